@@ -1,3 +1,14 @@
 C:/Users/71552/Documents/VulkanSDK/Bin/glslc.exe shader.vert -o vert.spv
 C:/Users/71552/Documents/VulkanSDK/Bin/glslc.exe shader.frag -o frag.spv
+C:/Users/71552/Documents/VulkanSDK/Bin/glslc.exe gltf.vert -o gltf_vert.spv
+C:/Users/71552/Documents/VulkanSDK/Bin/glslc.exe gltf.frag -o gltf_frag.spv
+C:/Users/71552/Documents/VulkanSDK/Bin/glslc.exe gltf_depth.vert -o gltf_depth_vert.spv
+C:/Users/71552/Documents/VulkanSDK/Bin/glslc.exe gltf_depth_masked.vert -o gltf_depth_masked_vert.spv
+C:/Users/71552/Documents/VulkanSDK/Bin/glslc.exe gltf_depth_masked.frag -o gltf_depth_masked_frag.spv
+C:/Users/71552/Documents/VulkanSDK/Bin/glslc.exe oit_resolve.vert -o oit_resolve_vert.spv
+C:/Users/71552/Documents/VulkanSDK/Bin/glslc.exe oit_resolve.frag -o oit_resolve_frag.spv
+C:/Users/71552/Documents/VulkanSDK/Bin/glslc.exe ibl_prefilter.comp -o ibl_prefilter_comp.spv
+C:/Users/71552/Documents/VulkanSDK/Bin/glslc.exe ibl_irradiance.comp -o ibl_irradiance_comp.spv
+C:/Users/71552/Documents/VulkanSDK/Bin/glslc.exe ibl_brdf_lut.comp -o ibl_brdf_lut_comp.spv
+C:/Users/71552/Documents/VulkanSDK/Bin/glslc.exe mip_downsample.comp -o mip_downsample_comp.spv
 pause
\ No newline at end of file
@@ -1,4 +1,5 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
 // ============================================================================
 // glTF Fragment Shader
@@ -34,12 +35,59 @@ layout(set = 1, binding = 1) readonly buffer MaterialBuffer {
     vec4 materials[];  // Each material takes 7 vec4s (112 bytes)
 };
 
-// Set 2: Textures (array of combined image samplers)
-// glTF materials can reference any texture by index
-layout(set = 2, binding = 0) uniform sampler2D textures[32];  // Support up to 32 textures
-
-// Set 3: Environment cubemap for IBL
-layout(set = 3, binding = 0) uniform samplerCube cubemapTex;
+// Set 0, Binding 1: Texture feedback (see TextureFeedback.h) - the finest mip
+// each heap slot was asked for, read back by the CPU to drive texture residency
+layout(set = 0, binding = 1) buffer TextureFeedbackBuffer {
+    uint sampleCell;     // pixel of each 8x8 tile that reports this frame
+    uint minMip[];       // floor(LOD) + FEEDBACK_LOD_BIAS, 0xFFFFFFFF = not sampled
+} feedback;
+
+// Off when the device lacks fragmentStoresAndAtomics or residency is disabled
+layout(constant_id = 0) const bool TEXTURE_FEEDBACK = false;
+const float FEEDBACK_LOD_BIAS = 16.0;
+
+// Material permutation (MaterialFeatureBits in GltfMaterial.h). Each pipeline
+// is specialized for one feature set, so unused texture fetches, material
+// reads and UV selection are compiled out instead of branched around.
+layout(constant_id = 1) const uint MATERIAL_FEATURES = 0u;
+const bool HAS_BASE_COLOR_MAP         = (MATERIAL_FEATURES & (1u << 0)) != 0u;
+const bool HAS_NORMAL_MAP             = (MATERIAL_FEATURES & (1u << 1)) != 0u;
+const bool HAS_METALLIC_ROUGHNESS_MAP = (MATERIAL_FEATURES & (1u << 2)) != 0u;
+const bool HAS_OCCLUSION_MAP          = (MATERIAL_FEATURES & (1u << 3)) != 0u;
+const bool HAS_OCCLUSION_PACKED       = (MATERIAL_FEATURES & (1u << 4)) != 0u;
+const bool HAS_EMISSIVE               = (MATERIAL_FEATURES & (1u << 5)) != 0u;
+const bool HAS_EMISSIVE_MAP           = (MATERIAL_FEATURES & (1u << 6)) != 0u;
+const bool ALPHA_MASK                 = (MATERIAL_FEATURES & (1u << 7)) != 0u;
+const bool ALPHA_BLEND                = (MATERIAL_FEATURES & (1u << 8)) != 0u;
+const bool USES_UV1                   = (MATERIAL_FEATURES & (1u << 9)) != 0u;
+const bool DOUBLE_SIDED               = (MATERIAL_FEATURES & (1u << 10)) != 0u;
+// Blend variants drawn into the weighted-blended OIT targets (WeightedOit.h)
+layout(constant_id = 2) const bool OIT_ACCUMULATE = false;
+
+const bool HAS_ANY_MAP = HAS_BASE_COLOR_MAP || HAS_NORMAL_MAP || HAS_METALLIC_ROUGHNESS_MAP ||
+                         HAS_OCCLUSION_MAP || HAS_EMISSIVE_MAP;
+
+// Set 2: Bindless texture heap (see BindlessTextureHeap.h), shared by all models.
+// Samplers and images are bound separately; a material texture "index" is a
+// handle with the image slot in the low 16 bits and the sampler slot above.
+// Handles come from the material picked by push constant, so they are
+// uniform per draw and need no nonuniformEXT.
+const int MAX_SAMPLERS = 64;  // must match BindlessTextureHeap::kMaxSamplers
+layout(set = 2, binding = 0) uniform sampler samplers[MAX_SAMPLERS];
+layout(set = 2, binding = 1) uniform texture2D textures[];
+
+#define TEXTURE_SLOT(handle) ((handle) & 0xFFFF)
+#define MATERIAL_TEXTURE(handle) sampler2D(textures[TEXTURE_SLOT(handle)], samplers[(handle) >> 16])
+
+// Set 3: Split-sum IBL baked from the environment cubemap
+// (see EnvironmentLighting): GGX-prefiltered specular cube with roughness
+// across its mips, BRDF scale/bias LUT, and SH9 irradiance already divided
+// by pi
+layout(set = 3, binding = 0) uniform samplerCube prefilteredEnv;
+layout(set = 3, binding = 1) uniform sampler2D brdfLut;
+layout(set = 3, binding = 2) uniform IrradianceSH {
+    vec4 coefficients[9];
+} irradianceSH;
 
 // Push constants for material/node indices
 layout(push_constant) uniform PushConstants {
@@ -56,8 +104,10 @@ layout(location = 4) in vec2 fragTexCoord0;
 layout(location = 5) in vec2 fragTexCoord1;
 layout(location = 6) in vec4 fragColor;
 
-// Output
+// Output; with OIT_ACCUMULATE location 0 is the accum target and
+// location 1 the revealage target
 layout(location = 0) out vec4 outColor;
+layout(location = 1) out float outRevealage;
 
 // Material data structure (must match MaterialData in C++)
 struct Material {
@@ -142,12 +192,14 @@ float Diffuse_Burley(float NdotL, float NdotV, float LdotH, float roughness) {
 // ============================================================================
 
 Material getMaterial(int index) {
-    // Each material now occupies 7 vec4s (112 bytes) in the buffer
+    // Each material occupies 7 vec4s (112 bytes) in the buffer; only the
+    // ones this permutation uses are read. Alpha mode and double-sidedness
+    // are part of the permutation and never read.
     int baseIdx = index * 7;
 
     Material mat;
     mat.baseColorFactor = materials[baseIdx + 0];
-    mat.emissiveFactor = materials[baseIdx + 1];
+    mat.emissiveFactor = HAS_EMISSIVE ? materials[baseIdx + 1] : vec4(0.0);
 
     vec4 factors = materials[baseIdx + 2];
     mat.metallicFactor = factors.x;
@@ -155,34 +207,71 @@ Material getMaterial(int index) {
     mat.normalScale = factors.z;
     mat.occlusionStrength = factors.w;
 
-    vec4 alphaData = materials[baseIdx + 3];
-    mat.alphaCutoff = alphaData.x;
-    mat.alphaMode = floatBitsToInt(alphaData.y);
-    mat.doubleSided = floatBitsToInt(alphaData.z);
-    mat.padding = floatBitsToInt(alphaData.w);
-
-    // Read texture indices - use floatBitsToInt to reinterpret the float bits as int
-    vec4 texIndices1 = materials[baseIdx + 4];
-    mat.baseColorTextureIndex = floatBitsToInt(texIndices1.x);
-    mat.metallicRoughnessTextureIndex = floatBitsToInt(texIndices1.y);
-    mat.normalTextureIndex = floatBitsToInt(texIndices1.z);
-    mat.occlusionTextureIndex = floatBitsToInt(texIndices1.w);
-
-    vec4 texIndices2 = materials[baseIdx + 5];
-    mat.emissiveTextureIndex = floatBitsToInt(texIndices2.x);
-    mat.baseColorTexCoord = floatBitsToInt(texIndices2.y);
-    mat.metallicRoughnessTexCoord = floatBitsToInt(texIndices2.z);
-    mat.normalTexCoord = floatBitsToInt(texIndices2.w);
-
-    vec4 texIndices3 = materials[baseIdx + 6];
-    mat.occlusionTexCoord = floatBitsToInt(texIndices3.x);
-    mat.emissiveTexCoord = floatBitsToInt(texIndices3.y);
-    mat.padding2 = floatBitsToInt(texIndices3.z);
-    mat.padding3 = floatBitsToInt(texIndices3.w);
+    mat.alphaCutoff = ALPHA_MASK ? materials[baseIdx + 3].x : 0.0;
+    mat.alphaMode = ALPHA_BLEND ? 2 : (ALPHA_MASK ? 1 : 0);
+    mat.doubleSided = 0;
+    mat.padding = 0;
+
+    // Texture handles - use floatBitsToInt to reinterpret the float bits as int
+    ivec4 texIndices1 = HAS_ANY_MAP ? floatBitsToInt(materials[baseIdx + 4]) : ivec4(-1);
+    mat.baseColorTextureIndex = texIndices1.x;
+    mat.metallicRoughnessTextureIndex = texIndices1.y;
+    mat.normalTextureIndex = texIndices1.z;
+    mat.occlusionTextureIndex = texIndices1.w;
+
+    // UV set indices are only needed when some texture reads TEXCOORD_1
+    ivec4 texIndices2 = (HAS_EMISSIVE_MAP || USES_UV1) ? floatBitsToInt(materials[baseIdx + 5]) : ivec4(-1, 0, 0, 0);
+    mat.emissiveTextureIndex = texIndices2.x;
+    mat.baseColorTexCoord = texIndices2.y;
+    mat.metallicRoughnessTexCoord = texIndices2.z;
+    mat.normalTexCoord = texIndices2.w;
+
+    ivec4 texIndices3 = USES_UV1 ? floatBitsToInt(materials[baseIdx + 6]) : ivec4(0);
+    mat.occlusionTexCoord = texIndices3.x;
+    mat.emissiveTexCoord = texIndices3.y;
+    mat.padding2 = 0;
+    mat.padding3 = 0;
 
     return mat;
 }
 
+vec2 selectUV(int texCoord) {
+    return (USES_UV1 && texCoord != 0) ? fragTexCoord1 : fragTexCoord0;
+}
+
+// ============================================================================
+// Texture Feedback
+// ============================================================================
+
+bool feedbackPixel = false;
+
+// LOD is relative to the bound (possibly reduced) image; negative = magnified.
+// The query needs implicit derivatives, so every pixel of the quad runs it
+// and only the reporting pixel writes the result.
+void recordFeedback(int textureHandle, vec2 uv) {
+    if (!TEXTURE_FEEDBACK) return;
+    float lod = textureQueryLod(MATERIAL_TEXTURE(textureHandle), uv).y;
+    if (!feedbackPixel) return;
+    atomicMin(feedback.minMip[TEXTURE_SLOT(textureHandle)], uint(clamp(floor(lod) + FEEDBACK_LOD_BIAS, 0.0, 63.0)));
+}
+
+// World direction -> cubemap lookup direction (same swizzle as shader.frag)
+vec3 envDirection(vec3 d) {
+    return vec3(d.y, -d.z, d.x);
+}
+
+vec3 irradiance(vec3 n) {
+    return max(irradianceSH.coefficients[0].rgb * 0.282095
+             + irradianceSH.coefficients[1].rgb * 0.488603 * n.y
+             + irradianceSH.coefficients[2].rgb * 0.488603 * n.z
+             + irradianceSH.coefficients[3].rgb * 0.488603 * n.x
+             + irradianceSH.coefficients[4].rgb * 1.092548 * n.x * n.y
+             + irradianceSH.coefficients[5].rgb * 1.092548 * n.y * n.z
+             + irradianceSH.coefficients[6].rgb * 0.315392 * (3.0 * n.z * n.z - 1.0)
+             + irradianceSH.coefficients[7].rgb * 1.092548 * n.x * n.z
+             + irradianceSH.coefficients[8].rgb * 0.546274 * (n.x * n.x - n.y * n.y), vec3(0.0));
+}
+
 // ============================================================================
 // Main Shader
 // ============================================================================
@@ -191,69 +280,81 @@ void main() {
     // Get material data
     Material mat = getMaterial(pc.materialIndex);
 
-    // Select UV set for base color texture
-    vec2 uv = (mat.baseColorTexCoord == 0) ? fragTexCoord0 : fragTexCoord1;
+    // One pixel per 8x8 tile reports, so the atomics stay cheap
+    if (TEXTURE_FEEDBACK) {
+        uvec2 cell = uvec2(gl_FragCoord.xy) & 7u;
+        feedbackPixel = (cell.y * 8u + cell.x) == feedback.sampleCell;
+    }
 
     // Sample base color texture or use factor if no texture
-    vec4 baseColor;
-    if (mat.baseColorTextureIndex >= 0) {
-        // Debug: visualize texture index as color
-        // outColor = vec4(float(mat.baseColorTextureIndex) / 10.0, float(mat.metallicRoughnessTextureIndex) / 10.0, float(mat.normalTextureIndex) / 10.0, 1.0);
-        // return;
-        baseColor = mat.baseColorFactor * texture(textures[mat.baseColorTextureIndex], uv) * fragColor;
-    } else {
-        baseColor = mat.baseColorFactor * fragColor;
+    vec4 baseColor = mat.baseColorFactor * fragColor;
+    if (HAS_BASE_COLOR_MAP) {
+        vec2 uv = selectUV(mat.baseColorTexCoord);
+        baseColor *= texture(MATERIAL_TEXTURE(mat.baseColorTextureIndex), uv);
+        recordFeedback(mat.baseColorTextureIndex, uv);
     }
 
     // Alpha testing for MASK mode
-    if (mat.alphaMode == 1 && baseColor.a < mat.alphaCutoff) {
+    if (ALPHA_MASK && baseColor.a < mat.alphaCutoff) {
         discard;
     }
 
     // Sample metallic-roughness texture or use factors
-    float roughness, metallic;
-    if (mat.metallicRoughnessTextureIndex >= 0) {
-        vec2 uvMR = (mat.metallicRoughnessTexCoord == 0) ? fragTexCoord0 : fragTexCoord1;
-        // glTF spec: G = roughness, B = metallic
-        vec2 metallicRoughness = texture(textures[mat.metallicRoughnessTextureIndex], uvMR).gb;
-        roughness = clamp(metallicRoughness.x * mat.roughnessFactor, 0.04, 1.0);
-        metallic = clamp(metallicRoughness.y * mat.metallicFactor, 0.0, 1.0);
-    } else {
-        roughness = clamp(mat.roughnessFactor, 0.04, 1.0);
-        metallic = clamp(mat.metallicFactor, 0.0, 1.0);
+    float roughness = mat.roughnessFactor;
+    float metallic = mat.metallicFactor;
+    vec3 orm = vec3(1.0);
+    if (HAS_METALLIC_ROUGHNESS_MAP) {
+        vec2 uvMR = selectUV(mat.metallicRoughnessTexCoord);
+        // glTF spec: R = occlusion (when packed), G = roughness, B = metallic
+        orm = texture(MATERIAL_TEXTURE(mat.metallicRoughnessTextureIndex), uvMR).rgb;
+        recordFeedback(mat.metallicRoughnessTextureIndex, uvMR);
+        roughness *= orm.g;
+        metallic *= orm.b;
     }
+    roughness = clamp(roughness, 0.04, 1.0);
+    metallic = clamp(metallic, 0.0, 1.0);
 
     // Sample normal map or use vertex normal
-    vec3 tangentNormal;
-    if (mat.normalTextureIndex >= 0) {
-        vec2 uvNormal = (mat.normalTexCoord == 0) ? fragTexCoord0 : fragTexCoord1;
-        tangentNormal = texture(textures[mat.normalTextureIndex], uvNormal).xyz * 2.0 - 1.0;
+    vec3 N;
+    if (HAS_NORMAL_MAP) {
+        vec2 uvNormal = selectUV(mat.normalTexCoord);
+        // Normal maps may be stored as two-channel BC5; rebuild Z from XY
+        vec3 tangentNormal;
+        tangentNormal.xy = texture(MATERIAL_TEXTURE(mat.normalTextureIndex), uvNormal).xy * 2.0 - 1.0;
+        recordFeedback(mat.normalTextureIndex, uvNormal);
+        tangentNormal.z = sqrt(clamp(1.0 - dot(tangentNormal.xy, tangentNormal.xy), 0.0, 1.0));
         tangentNormal.xy *= mat.normalScale;
+
+        // Construct TBN matrix and transform normal to world space
+        mat3 TBN = mat3(normalize(fragTangent), normalize(fragBitangent), normalize(fragNormal));
+        N = normalize(TBN * tangentNormal);
     } else {
-        tangentNormal = vec3(0.0, 0.0, 1.0);  // Default tangent-space normal
+        N = normalize(fragNormal);
     }
 
-    // Construct TBN matrix and transform normal to world space
-    mat3 TBN = mat3(normalize(fragTangent), normalize(fragBitangent), normalize(fragNormal));
-    vec3 N = normalize(TBN * tangentNormal);
+    // Double-sided materials are not culled; light back faces from their own side
+    if (DOUBLE_SIDED && !gl_FrontFacing) {
+        N = -N;
+    }
 
     // Sample occlusion map or use full value
-    float ao;
-    if (mat.occlusionTextureIndex >= 0) {
-        vec2 uvAO = (mat.occlusionTexCoord == 0) ? fragTexCoord0 : fragTexCoord1;
-        ao = texture(textures[mat.occlusionTextureIndex], uvAO).r;
+    float ao = 1.0;
+    if (HAS_OCCLUSION_PACKED) {
+        // Packed ORM texture: reuse the metallic-roughness fetch
+        ao = 1.0 + mat.occlusionStrength * (orm.r - 1.0);
+    } else if (HAS_OCCLUSION_MAP) {
+        vec2 uvAO = selectUV(mat.occlusionTexCoord);
+        ao = texture(MATERIAL_TEXTURE(mat.occlusionTextureIndex), uvAO).r;
+        recordFeedback(mat.occlusionTextureIndex, uvAO);
         ao = 1.0 + mat.occlusionStrength * (ao - 1.0);  // Apply strength
-    } else {
-        ao = 1.0;  // No occlusion
     }
 
     // Sample emissive map or use factor
-    vec3 emissive;
-    if (mat.emissiveTextureIndex >= 0) {
-        vec2 uvEmissive = (mat.emissiveTexCoord == 0) ? fragTexCoord0 : fragTexCoord1;
-        emissive = mat.emissiveFactor.rgb * texture(textures[mat.emissiveTextureIndex], uvEmissive).rgb;
-    } else {
-        emissive = mat.emissiveFactor.rgb;
+    vec3 emissive = mat.emissiveFactor.rgb;
+    if (HAS_EMISSIVE_MAP) {
+        vec2 uvEmissive = selectUV(mat.emissiveTexCoord);
+        emissive *= texture(MATERIAL_TEXTURE(mat.emissiveTextureIndex), uvEmissive).rgb;
+        recordFeedback(mat.emissiveTextureIndex, uvEmissive);
     }
 
     // ========================================================================
@@ -288,21 +389,26 @@ void main() {
     // Direct lighting
     vec3 Lo = (diffuse + specular) * ubo.sunColor.rgb * NdotL;
 
-    // Image-based lighting (IBL) from environment cubemap
-    float maxLod = 12.0;
-    float lod = roughness * maxLod;
-    vec3 prefilteredColor = textureLod(cubemapTex, vec3(R.y, -R.z, R.x), lod).rgb;
+    // Image-based lighting: split-sum specular and SH diffuse
+    float lod = roughness * float(textureQueryLevels(prefilteredEnv) - 1);
+    vec3 prefilteredColor = textureLod(prefilteredEnv, envDirection(R), lod).rgb;
+    vec2 envBRDF = texture(brdfLut, vec2(NdotV, roughness)).rg;
+    vec3 specularIBL = prefilteredColor * (F0 * envBRDF.x + envBRDF.y);
 
-    vec3 F_ibl = F_Schlick(NdotV, F0);
-    vec3 specularIBL = prefilteredColor * F_ibl;
-
-    // Ambient lighting
-    vec3 ambient = ubo.ambientLight.rgb * baseColor.rgb * ao;
+    vec3 kD_ibl = (1.0 - F_Schlick(NdotV, F0)) * (1.0 - metallic);
+    vec3 diffuseIBL = kD_ibl * baseColor.rgb * irradiance(envDirection(N));
 
     // Final color
-    vec3 color = ambient + Lo + specularIBL + emissive;
+    vec3 color = (diffuseIBL + specularIBL) * ao + Lo + emissive;
 
     // Output with material alpha for BLEND mode
-    float alpha = (mat.alphaMode == 2) ? baseColor.a : 1.0;
+    float alpha = ALPHA_BLEND ? baseColor.a : 1.0;
+    if (OIT_ACCUMULATE) {
+        // Depth weight (McGuire & Bavoil): nearer layers dominate the average
+        float weight = clamp(alpha * max(1e-2, 3e3 * pow(1.0 - gl_FragCoord.z, 3.0)), 1e-2, 3e3);
+        outColor = vec4(color * alpha, alpha) * weight;
+        outRevealage = alpha;
+        return;
+    }
     outColor = vec4(color, alpha);
 }
@@ -49,6 +49,9 @@ layout(location = 4) out vec2 fragTexCoord0;
 layout(location = 5) out vec2 fragTexCoord1;
 layout(location = 6) out vec4 fragColor;
 
+// Bit-identical to gltf_depth.vert, so EQUAL depth tests pass after a pre-pass
+invariant gl_Position;
+
 void main() {
     // Get node transform from storage buffer
     mat4 modelMatrix = nodeTransforms[pc.nodeIndex];
@@ -0,0 +1,40 @@
+#version 450
+
+// ============================================================================
+// glTF Depth Pre-pass Vertex Shader
+// Position only, no fragment stage. The position math must stay identical to
+// gltf.vert: the main pass tests against this depth with EQUAL.
+// ============================================================================
+
+// Set 0: Per-frame data (camera, lights)
+// NOTE: Must match UniformBufferObject in Application.cpp exactly
+layout(set = 0, binding = 0) uniform UniformBufferObject {
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+    mat4 normalMat;
+    vec4 cameraPosition;
+    vec4 viewDirection;
+    vec4 sunDirection;
+    vec4 sunColor;
+    vec4 ambientLight;
+} ubo;
+
+// Set 1: Per-model data (transforms for all nodes)
+layout(set = 1, binding = 0) readonly buffer TransformBuffer {
+    mat4 nodeTransforms[];
+};
+
+layout(push_constant) uniform PushConstants {
+    int nodeIndex;
+    int materialIndex;
+} pc;
+
+layout(location = 0) in vec3 inPosition;
+
+invariant gl_Position;
+
+void main() {
+    vec4 worldPos = nodeTransforms[pc.nodeIndex] * vec4(inPosition, 1.0);
+    gl_Position = ubo.proj * ubo.view * worldPos;
+}
@@ -0,0 +1,42 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+// ============================================================================
+// glTF Alpha-Tested Depth Pre-pass Fragment Shader
+// Only the alpha test of gltf.frag: base color factor * base color texture
+// alpha against the cutoff. Vertex color alpha is not in the packed stream,
+// so primitives whose vertex colors carry alpha never take this path.
+// ============================================================================
+
+// Set 1: Per-model material data (7 vec4s per material, see gltf.frag)
+layout(set = 1, binding = 1) readonly buffer MaterialBuffer {
+    vec4 materials[];
+};
+
+// Set 2: Bindless texture heap (see gltf.frag)
+const int MAX_SAMPLERS = 64;  // must match BindlessTextureHeap::kMaxSamplers
+layout(set = 2, binding = 0) uniform sampler samplers[MAX_SAMPLERS];
+layout(set = 2, binding = 1) uniform texture2D textures[];
+
+#define MATERIAL_TEXTURE(handle) sampler2D(textures[(handle) & 0xFFFF], samplers[(handle) >> 16])
+
+layout(push_constant) uniform PushConstants {
+    int nodeIndex;
+    int materialIndex;
+} pc;
+
+layout(location = 0) in vec2 fragTexCoord;
+
+void main() {
+    int baseIdx = pc.materialIndex * 7;
+    float alpha = materials[baseIdx + 0].a;
+    float alphaCutoff = materials[baseIdx + 3].x;
+    int baseColorTexture = floatBitsToInt(materials[baseIdx + 4].x);
+
+    if (baseColorTexture >= 0) {
+        alpha *= texture(MATERIAL_TEXTURE(baseColorTexture), fragTexCoord).a;
+    }
+    if (alpha < alphaCutoff) {
+        discard;
+    }
+}
@@ -0,0 +1,44 @@
+#version 450
+
+// ============================================================================
+// glTF Alpha-Tested Depth Pre-pass Vertex Shader
+// Position + the base color UV (GltfPositionUvVertex). The position math must
+// stay identical to gltf.vert, as in gltf_depth.vert.
+// ============================================================================
+
+// Set 0: Per-frame data (camera, lights)
+// NOTE: Must match UniformBufferObject in Application.cpp exactly
+layout(set = 0, binding = 0) uniform UniformBufferObject {
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+    mat4 normalMat;
+    vec4 cameraPosition;
+    vec4 viewDirection;
+    vec4 sunDirection;
+    vec4 sunColor;
+    vec4 ambientLight;
+} ubo;
+
+// Set 1: Per-model data (transforms for all nodes)
+layout(set = 1, binding = 0) readonly buffer TransformBuffer {
+    mat4 nodeTransforms[];
+};
+
+layout(push_constant) uniform PushConstants {
+    int nodeIndex;
+    int materialIndex;
+} pc;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inTexCoord;
+
+layout(location = 0) out vec2 fragTexCoord;
+
+invariant gl_Position;
+
+void main() {
+    vec4 worldPos = nodeTransforms[pc.nodeIndex] * vec4(inPosition, 1.0);
+    gl_Position = ubo.proj * ubo.view * worldPos;
+    fragTexCoord = inTexCoord;
+}
@@ -0,0 +1,24 @@
+#version 450
+
+// ============================================================================
+// OIT Resolve Fragment Shader
+// Weighted-blended OIT composite (see WeightedOit.h): average the weighted
+// transparent color and cover the scene by 1 - revealage
+// ============================================================================
+
+layout(input_attachment_index = 0, set = 0, binding = 0) uniform subpassInput accumInput;
+layout(input_attachment_index = 1, set = 0, binding = 1) uniform subpassInput revealageInput;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    float revealage = subpassLoad(revealageInput).r;
+    if (revealage >= 1.0) {
+        discard;   // no transparent surface here
+    }
+
+    vec4 accum = subpassLoad(accumInput);
+    // Clamp so a weight overflow to +inf cannot turn into NaN
+    vec3 average = accum.rgb / clamp(accum.a, 1e-4, 5e4);
+    outColor = vec4(average, 1.0 - revealage);
+}
@@ -83,7 +83,10 @@ void main() {
     vec3 Bw = normalize(cross(Nw, Tw));
     mat3 TBN = mat3(Tw, Bw, Nw);
 
-    vec3 nTan = texture(normalTex, fragTexCoord).xyz * 2.0 - 1.0;
+    // Normal maps may be stored as RG8/BC5; rebuild Z from XY
+    vec3 nTan;
+    nTan.xy = texture(normalTex, fragTexCoord).xy * 2.0 - 1.0;
+    nTan.z  = sqrt(clamp(1.0 - dot(nTan.xy, nTan.xy), 0.0, 1.0));
     vec3 N    = normalize(TBN * nTan);   // final world-space normal
 
     // --- Lighting vectors (world-space) ---
@@ -0,0 +1,144 @@
+// ============================================================================
+// AppSettings.cpp - Command line parsing
+// ============================================================================
+
+#include "AppSettings.h"
+#include <iostream>
+#include <stdexcept>
+
+AppSettings AppSettings::fromCommandLine(int argc, char** argv) {
+    AppSettings settings;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto nextValue = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+
+        if (arg == "--help" || arg == "-h") {
+            settings.showHelp = true;
+        } else if (arg == "--model") {
+            settings.gltfModelPath = nextValue();
+        } else if (arg == "--load-model") {
+            settings.runtimeModelPaths.push_back(nextValue());
+        } else if (arg == "--upload-budget-ms") {
+            std::string value = nextValue();
+            double budget = 0.0;
+            try {
+                budget = std::stod(value);
+            } catch (const std::exception&) {
+            }
+            if (!(budget > 0.0)) {
+                throw std::runtime_error("Invalid upload time budget: " + value);
+            }
+            settings.uploadBudget.timePerFrame = std::chrono::microseconds(static_cast<int64_t>(budget * 1000.0));
+        } else if (arg == "--upload-budget-mb") {
+            std::string value = nextValue();
+            uint64_t budget = 0;
+            try {
+                budget = std::stoull(value);
+            } catch (const std::exception&) {
+            }
+            if (budget == 0) {
+                throw std::runtime_error("Invalid upload byte budget: " + value);
+            }
+            settings.uploadBudget.bytesPerFrame = budget * 1024ull * 1024ull;
+        } else if (arg == "--texture-quality") {
+            std::string value = nextValue();
+            if (!parseTextureQuality(value, settings.gltfLoad.textureBudget.quality)) {
+                throw std::runtime_error("Unknown texture quality: " + value);
+            }
+        } else if (arg == "--texture-budget-mb") {
+            std::string value = nextValue();
+            try {
+                settings.gltfLoad.textureBudget.budgetBytes = std::stoull(value) * 1024ull * 1024ull;
+            } catch (const std::exception&) {
+                throw std::runtime_error("Invalid texture budget: " + value);
+            }
+        } else if (arg == "--no-bc") {
+            settings.gltfLoad.textureCook.allowBlockCompression = false;
+        } else if (arg == "--no-texture-cache") {
+            settings.gltfLoad.textureCook.useDiskCache = false;
+        } else if (arg == "--no-pipeline-cache") {
+            settings.pipelineCachePath.clear();
+        } else if (arg == "--no-ibl-cache") {
+            settings.environmentLighting.useDiskCache = false;
+        } else if (arg == "--no-texture-streaming") {
+            settings.gltfLoad.streamTextures = false;
+        } else if (arg == "--no-texture-feedback") {
+            settings.gltfLoad.textureFeedback = false;
+        } else if (arg == "--frames-in-flight") {
+            std::string value = nextValue();
+            unsigned long frames = 0;
+            try {
+                frames = std::stoul(value);
+            } catch (const std::exception&) {
+            }
+            if (frames < 1 || frames > kMaxFramesInFlight) {
+                throw std::runtime_error("Invalid frames in flight (1-" + std::to_string(kMaxFramesInFlight) + "): " + value);
+            }
+            settings.framesInFlight = static_cast<uint32_t>(frames);
+        } else if (arg == "--job-threads") {
+            std::string value = nextValue();
+            unsigned long threads = 0;
+            try {
+                threads = std::stoul(value);
+            } catch (const std::exception&) {
+                throw std::runtime_error("Invalid job thread count: " + value);
+            }
+            settings.jobThreads = static_cast<uint32_t>(threads);
+        } else if (arg == "--record-threads") {
+            std::string value = nextValue();
+            unsigned long threads = 0;
+            try {
+                threads = std::stoul(value);
+            } catch (const std::exception&) {
+                throw std::runtime_error("Invalid record thread count: " + value);
+            }
+            settings.recordThreads = static_cast<uint32_t>(threads);
+        } else if (arg == "--depth-prepass") {
+            settings.depthPrepass = true;
+        } else if (arg == "--oit") {
+            settings.oitTransparency = true;
+        } else if (arg == "--benchmark-draw-sort") {
+            settings.benchmarkDrawSort = true;
+        } else if (arg == "--benchmark-jobs") {
+            settings.benchmarkJobs = true;
+        } else if (arg == "--benchmark-mips") {
+            settings.benchmarkMipGeneration = true;
+        } else if (arg == "--benchmark-recording") {
+            settings.benchmarkRecording = true;
+        } else {
+            throw std::runtime_error("Unknown option: " + arg);
+        }
+    }
+
+    return settings;
+}
+
+void AppSettings::printUsage(const char* executable) {
+    std::cout << "Usage: " << executable << " [options]\n"
+              << "  --model <path>               glTF model to load\n"
+              << "  --load-model <path>          model to add while running, one per L press (repeatable; U unloads)\n"
+              << "  --upload-budget-ms <n>       CPU time per frame for streaming and model uploads (default: 2)\n"
+              << "  --upload-budget-mb <n>       bytes per frame for streaming and model uploads (default: 16)\n"
+              << "  --texture-quality <preset>   low | medium | high | ultra (default: high)\n"
+              << "  --texture-budget-mb <n>      texture VRAM budget, overrides the preset default\n"
+              << "  --no-bc                      disable block-compressed textures\n"
+              << "  --no-texture-cache           do not read/write cooked textures on disk\n"
+              << "  --no-pipeline-cache          do not read/write compiled pipelines on disk\n"
+              << "  --no-ibl-cache               rebake image-based lighting instead of using cache/ibl\n"
+              << "  --no-texture-streaming       load every texture before the first frame\n"
+              << "  --no-texture-feedback        keep streamed textures at full budgeted resolution\n"
+              << "  --frames-in-flight <n>       frames the CPU may run ahead of the GPU, 1-4 (default: 2)\n"
+              << "  --job-threads <n>            threads for loading and per-frame work, 0 = all cores (default: 0)\n"
+              << "  --record-threads <n>         threads recording draws, 0 = all job threads, 1 = inline (default: 1)\n"
+              << "  --depth-prepass              start with the depth pre-pass on (P toggles it)\n"
+              << "  --oit                        start with weighted blended OIT transparency (O toggles it)\n"
+              << "  --benchmark-draw-sort        time the draw list radix sort against std::sort and exit\n"
+              << "  --benchmark-jobs             time loading and per-frame work at 1..N job threads and exit\n"
+              << "  --benchmark-mips             time compute mip generation against blits at startup\n"
+              << "  --benchmark-recording        time draw recording at 1..N job threads once loaded\n"
+              << "  --help                       show this message" << std::endl;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "EnvironmentLighting.h"
+#include "GltfModel.h"
+#include "UploadScheduler.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Application Settings
+// Runtime configuration filled from the command line in main()
+// ============================================================================
+
+struct AppSettings {
+    static constexpr uint32_t kMaxFramesInFlight = 4;
+
+    std::string gltfModelPath = "models/ABeautifulGame/glTF/ABeautifulGame.gltf";
+    GltfLoadOptions gltfLoad;
+    std::vector<std::string> runtimeModelPaths;  // loaded one per L press while running
+    UploadBudget uploadBudget;        // per frame, shared by texture streaming and added models
+    EnvironmentLightingOptions environmentLighting;
+    std::string pipelineCachePath = "cache/pipelines.bin";  // empty: keep the cache in memory only
+    uint32_t framesInFlight = 2;      // 1..kMaxFramesInFlight: fewer for latency, more for throughput
+    uint32_t jobThreads = 0;          // job system threads including the main one; 0: one per hardware thread
+    uint32_t recordThreads = 1;       // threads recording draws, capped at jobThreads; 0: all, 1: inline (keeps fragment counts)
+    bool depthPrepass = false;        // initial state; P toggles it at runtime
+    bool oitTransparency = false;     // weighted blended OIT instead of sorted blending; O toggles it
+    bool showHelp = false;
+    bool benchmarkDrawSort = false;   // run the draw list sort benchmark and exit
+    bool benchmarkJobs = false;       // run the job system scaling benchmark and exit
+    bool benchmarkMipGeneration = false;  // time compute against blit mip generation at startup
+    bool benchmarkRecording = false;  // time draw recording at 1..N job threads once textures are loaded
+
+    // Throws std::runtime_error on unknown options or bad values
+    static AppSettings fromCommandLine(int argc, char** argv);
+    static void printUsage(const char* executable);
+};
@@ -10,12 +10,15 @@
 #include <cstring>
 #include <optional>
 #include <set>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <algorithm>
 #include <fstream>
 #include <array>
 #include <unordered_map>
+#include <iomanip>
+#include <utility>
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
@@ -79,11 +82,43 @@ void Application::framebufferResizeCallback(GLFWwindow* window, int, int)
     if (app) app->m_framebufferResized = true;
 }
 
+void Application::keyCallback(GLFWwindow* window, int key, int, int action, int)
+{
+    auto app = reinterpret_cast<Application*>(
+        glfwGetWindowUserPointer(window));
+    if (!app || action != GLFW_PRESS) return;
+
+    if (key == GLFW_KEY_P) {
+        app->m_depthPrepass = !app->m_depthPrepass;
+        std::cout << "Depth pre-pass " << (app->m_depthPrepass ? "on" : "off") << std::endl;
+    } else if (key == GLFW_KEY_O) {
+        app->m_oitTransparency = !app->m_oitTransparency;
+        std::cout << "Transparency: " << (app->m_oitTransparency ? "weighted blended OIT" : "sorted blending") << std::endl;
+    } else if (key == GLFW_KEY_L) {
+        const std::vector<std::string>& paths = app->m_settings.runtimeModelPaths;
+        if (app->m_nextRuntimeModel >= paths.size()) {
+            std::cout << "No more models to load (add them with --load-model)" << std::endl;
+        } else if (app->m_gltfModels.size() + app->m_modelLoader.pending() >= kMaxGltfModels) {
+            std::cout << "Model limit reached (" << kMaxGltfModels << "), unload one with U first" << std::endl;
+        } else {
+            const std::string& path = paths[app->m_nextRuntimeModel++];
+            std::cout << "Loading " << path << " in the background" << std::endl;
+            app->m_modelLoader.request(path);
+        }
+    } else if (key == GLFW_KEY_U) {
+        app->m_unloadRequested = true;
+    }
+}
+
 // ============================================================================
 // Application Lifecycle
 // ============================================================================
 
 void Application::run() {
+    m_startTime = std::chrono::steady_clock::now();
+    m_jobs.start(m_settings.jobThreads);
+    std::cout << "Job threads: " << m_jobs.threadCount() << std::endl;
+    m_modelLoader.setJobSystem(&m_jobs);
     initWindow();
     initVulkan();
     mainLoop();
@@ -101,6 +136,7 @@ void Application::initWindow() {
 
     glfwSetWindowUserPointer(m_window, this);
     glfwSetFramebufferSizeCallback(m_window, framebufferResizeCallback);
+    glfwSetKeyCallback(m_window, keyCallback);
 }
 
 // ============================================================================
@@ -141,7 +177,7 @@ VkShaderModule Application::createShaderModule(Device device, const std::vector<
 // Texture & Descriptor Helper Methods
 // ============================================================================
 
-Texture Application::loadTexture(const std::string& path, VkFormat format,
+Texture Application::loadTexture(const std::string& path, TextureUsageFlags usage,
                                   VkFilter filter, VkSamplerAddressMode addressMode) {
     int width, height, channels;
     stbi_uc* pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
@@ -150,11 +186,28 @@ Texture Application::loadTexture(const std::string& path, VkFormat format,
         throw std::runtime_error("Failed to load texture: " + path);
     }
 
-    Texture texture;
-    texture.createFromPixels(m_device, m_commandPool.get(), m_device.graphicsQ(),
-                             pixels, width, height, format, true, filter, addressMode);
+    // The cooker narrows the stored channels (R8/RG8/BCn) to what `usage` reads
+    CookedTexture cooked = m_textureCooker.cook(pixels, static_cast<uint32_t>(width),
+                                                static_cast<uint32_t>(height), usage);
     stbi_image_free(pixels);
 
+    SamplerKey samplerKey;
+    samplerKey.magFilter = samplerKey.minFilter = filter;
+    samplerKey.addressModeU = samplerKey.addressModeV = samplerKey.addressModeW = addressMode;
+    VkSampler sampler = m_samplerCache.get(m_device, samplerKey);
+
+    Texture texture;
+    if (cooked.generateMipmapsOnGpu) {
+        texture.createFromPixels(m_device, m_commandPool.get(), m_device.graphicsQ(),
+                                 cooked.levels[0].data.data(), cooked.levels[0].width, cooked.levels[0].height,
+                                 cooked.format, true,
+                                 filter, addressMode, cooked.components, sampler, &m_mipGenerator);
+    } else {
+        texture.createFromMipChain(m_device, m_commandPool.get(), m_device.graphicsQ(),
+                                   cooked.levels, cooked.format, filter, addressMode, cooked.components, sampler,
+                                   &m_transferQueue);
+    }
+
     return texture;
 }
 
@@ -365,12 +418,28 @@ void Application::loadCubemap() {
         static_cast<uint32_t>(w),
         static_cast<uint32_t>(h),
         VK_FORMAT_R8G8B8A8_SRGB, /* generateMip = */ true,
-        VK_FILTER_LINEAR
+        VK_FILTER_LINEAR,
+        &m_mipGenerator
     );
 
     for (int f = 0; f < 6; ++f) {
         stbi_image_free(faces[f]);
     }
+
+    // Bake (or load from the cache) the glTF shading's IBL from the faces
+    auto prefilterCode = readFile("shaders/ibl_prefilter_comp.spv");
+    auto irradianceCode = readFile("shaders/ibl_irradiance_comp.spv");
+    auto brdfLutCode = readFile("shaders/ibl_brdf_lut_comp.spv");
+    EnvironmentLighting::BakeShaders bakeShaders;
+    bakeShaders.prefilter = createShaderModule(m_device, prefilterCode);
+    bakeShaders.irradiance = createShaderModule(m_device, irradianceCode);
+    bakeShaders.brdfLut = createShaderModule(m_device, brdfLutCode);
+    m_environmentLighting.create(m_device, m_commandPool.get(), m_device.graphicsQ(), m_pipelineCache, m_cubemap,
+                                 EnvironmentLighting::hashFiles({ std::begin(kFaces), std::end(kFaces) }),
+                                 bakeShaders, m_settings.environmentLighting);
+    vkDestroyShaderModule(m_device.get(), bakeShaders.brdfLut, nullptr);
+    vkDestroyShaderModule(m_device.get(), bakeShaders.irradiance, nullptr);
+    vkDestroyShaderModule(m_device.get(), bakeShaders.prefilter, nullptr);
 }
 
 // ============================================================================
@@ -392,6 +461,7 @@ void Application::initVulkanCore() {
     m_surface.create(m_instance.get(), m_window);
     m_physicalDevice.pick(m_instance.get(), m_surface.get());
     m_device.create(m_physicalDevice, kEnableValidationLayers);
+    m_pipelineCache.create(m_device, m_settings.pipelineCachePath);
 }
 
 void Application::initRenderResources() {
@@ -406,38 +476,75 @@ void Application::initRenderResources() {
     VkShaderModule fragShaderModule = createShaderModule(m_device, fragShaderCode);
 
     m_pipelineLayout.create(m_device, {}, {});
-    m_graphicsPipeline.create(m_device, m_renderPass.get(), m_pipelineLayout.get(),
+    m_graphicsPipeline.create(m_device, m_pipelineCache, m_renderPass.get(), m_pipelineLayout.get(),
                               m_swapchain.extent(), m_msaaSamples, m_descriptorSetLayout.get(),
                               vertShaderModule, fragShaderModule);
 
     m_commandPool.create(m_device, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, m_surface.get());
     m_framebuffer.create(m_device, m_swapchain, m_renderPass);
-    m_commandBuffers.create(m_device, m_commandPool.get(), kMaxFramesInFlight);
-    m_syncObjects.create(m_device, kMaxFramesInFlight);
+    m_framesInFlight = m_settings.framesInFlight;
+    std::cout << "Frames in flight: " << m_framesInFlight << std::endl;
+    m_commandBuffers.create(m_device, m_commandPool.get(), m_framesInFlight);
+    // A recording slot per job thread unless limited; one slot records inline
+    uint32_t recordThreads = m_settings.recordThreads == 0
+        ? m_jobs.threadCount() : std::min(m_settings.recordThreads, m_jobs.threadCount());
+    m_drawRecorder.create(m_device, m_framesInFlight, recordThreads);
+    std::cout << "Draw recording threads: " << recordThreads << std::endl;
+    m_syncObjects.create(m_device, m_framesInFlight);
+    m_transferQueue.create(m_device, m_device.transferFamily(), m_device.transferQ(), m_commandPool.get(),
+                           m_syncObjects, m_deletionQueue);
+    m_computeQueue.create(m_device, m_device.computeFamily(), m_device.computeQ(), m_commandPool.get(),
+                          m_syncObjects, m_deletionQueue);
+    m_pipelineStats.create(m_device, m_framesInFlight);
+    m_gpuTimer.create(m_device, m_framesInFlight, { "transparency (sorted blending)", "transparency (weighted blended OIT)" });
+    m_depthPrepass = m_settings.depthPrepass;
+    m_oitTransparency = m_settings.oitTransparency;
+    m_uploadScheduler.setBudget(m_settings.uploadBudget);
+
+    auto oitVertCode = readFile("shaders/oit_resolve_vert.spv");
+    auto oitFragCode = readFile("shaders/oit_resolve_frag.spv");
+    VkShaderModule oitVertModule = createShaderModule(m_device, oitVertCode);
+    VkShaderModule oitFragModule = createShaderModule(m_device, oitFragCode);
+    m_weightedOit.create(m_device, m_pipelineCache, m_renderPass.get(), oitVertModule, oitFragModule);
+    m_weightedOit.setTargets(m_device, m_framebuffer.oitAccumView(), m_framebuffer.oitRevealageView());
+    vkDestroyShaderModule(m_device.get(), oitFragModule, nullptr);
+    vkDestroyShaderModule(m_device.get(), oitVertModule, nullptr);
 }
 
 void Application::initTextures() {
-    m_baseTexture = loadTexture(kBaseTexturePath);
-    m_normalTexture = loadTexture(kNormalTexturePath);
-    m_metalRoughnessTexture = loadTexture(kMetalRoughnessTexturePath);
-    m_aoTexture = loadTexture(kAoTexturePath);
-    m_emissiveTexture = loadTexture(kEmissiveTexturePath);
+    auto mipDownsampleCode = readFile("shaders/mip_downsample_comp.spv");
+    VkShaderModule mipDownsampleShader = createShaderModule(m_device, mipDownsampleCode);
+    m_mipGenerator.create(m_device, m_pipelineCache, mipDownsampleShader, &m_computeQueue);
+    vkDestroyShaderModule(m_device.get(), mipDownsampleShader, nullptr);
+    if (m_settings.benchmarkMipGeneration) {
+        m_mipGenerator.benchmark(m_device, m_commandPool.get(), m_device.graphicsQ());
+    }
+
+    m_textureCooker.init(m_device, m_settings.gltfLoad.textureCook);
+    m_samplerCache.create(m_device);
+    m_baseTexture = loadTexture(kBaseTexturePath, TEXTURE_USAGE_BASE_COLOR);
+    m_normalTexture = loadTexture(kNormalTexturePath, TEXTURE_USAGE_NORMAL);
+    m_metalRoughnessTexture = loadTexture(kMetalRoughnessTexturePath, TEXTURE_USAGE_METALLIC_ROUGHNESS);
+    m_aoTexture = loadTexture(kAoTexturePath, TEXTURE_USAGE_OCCLUSION);
+    m_emissiveTexture = loadTexture(kEmissiveTexturePath, TEXTURE_USAGE_EMISSIVE);
+    m_textureCooker.printStats();
     loadCubemap();
 }
 
 void Application::initGeometry() {
     loadModel();
     VkDeviceSize bufferSize = sizeof(m_vertices[0]) * m_vertices.size();
-    m_vertexBuf.createFrom(m_device, m_commandPool.get(), m_device.graphicsQ(), m_vertices.data(), bufferSize);
-    m_indexBuf.createFromVector(m_device, m_commandPool.get(), m_device.graphicsQ(), m_indices);
-    m_uboSet.create(m_device, kMaxFramesInFlight, sizeof(UniformBufferObject));
+    m_vertexBuf.createFrom(m_device, m_commandPool.get(), m_device.graphicsQ(), m_vertices.data(), bufferSize,
+                           &m_transferQueue);
+    m_indexBuf.createFromVector(m_device, m_commandPool.get(), m_device.graphicsQ(), m_indices, &m_transferQueue);
+    m_uboSet.create(m_device, m_framesInFlight, sizeof(UniformBufferObject));
 }
 
 void Application::initDescriptors() {
-    m_descriptorPool.create(m_device);
-    m_descriptorSets.create(m_device, m_descriptorPool.get(), m_descriptorSetLayout.get());
+    m_descriptorPool.create(m_device, m_framesInFlight);
+    m_descriptorSets.create(m_device, m_descriptorPool.get(), m_descriptorSetLayout.get(), m_framesInFlight);
 
-    for (size_t i = 0; i < kMaxFramesInFlight; i++) {
+    for (size_t i = 0; i < m_framesInFlight; i++) {
         VkDescriptorBufferInfo bufferInfo{};
         bufferInfo.buffer = m_uboSet.buffer(i);
         bufferInfo.offset = 0;
@@ -470,22 +577,35 @@ void Application::initDescriptors() {
 
 void Application::initGltf() {
     // Initialize glTF subsystem: descriptor layouts, pool, model loading, and pipeline
-    m_gltfDescriptorLayouts.create(m_device);
-    m_gltfDescriptorPool.create(m_device, 32); // Support up to 32 textures
-    m_gltfDescriptorSets.allocate(m_device, m_gltfDescriptorPool.get(), m_gltfDescriptorLayouts, kMaxFramesInFlight);
+    m_textureHeap.create(m_device, m_framesInFlight);
+    m_gltfDescriptorLayouts.create(m_device, m_textureHeap.layout());
+    // Unloaded models free their sets behind the frames in flight, so the
+    // pool has room for a second generation of them
+    m_gltfDescriptorPool.create(m_device, m_framesInFlight, 2 * kMaxGltfModels);
+    m_gltfDescriptorSets.allocate(m_device, m_gltfDescriptorPool.get(), m_gltfDescriptorLayouts,
+                                  m_textureHeap, m_framesInFlight);
+
+    // Indexed by heap slot; bound even when unused, the shader declares it either way
+    m_textureFeedback.create(m_device, m_framesInFlight, m_textureHeap.capacity());
+    updateGltfDescriptors();
 
     loadGltfModel();
-    createGltfPipeline();
-    updateGltfDescriptors();
 }
 
 void Application::loadGltfModel() {
-    // Load the ToyCar test model
-    m_gltfModel.loadFromFile(m_device, m_commandPool.get(), m_device.graphicsQ(),
-                              "models/ABeautifulGame/glTF/ABeautifulGame.gltf");
+    if (m_device.features().fragmentStoresAndAtomics != VK_TRUE) {
+        m_settings.gltfLoad.textureFeedback = false;
+    }
+    auto model = std::make_unique<GltfModel>();
+    model->loadFromFile(m_device, m_commandPool.get(), m_device.graphicsQ(), m_textureHeap,
+                        m_samplerCache, &m_mipGenerator, &m_transferQueue,
+                        m_settings.gltfModelPath, m_settings.gltfLoad, &m_jobs);
+    addGltfModel(std::move(model));
 }
 
-void Application::createGltfPipeline() {
+// Builds the pipelines for one model's material variants; the layout and the
+// depth pre-pass pipelines are shared and created with the first model
+void Application::createGltfPipelines(GltfSceneModel& sceneModel) {
     // Load glTF shaders
     auto vertShaderCode = readFile("shaders/gltf_vert.spv");
     auto fragShaderCode = readFile("shaders/gltf_frag.spv");
@@ -500,7 +620,9 @@ void Application::createGltfPipeline() {
     pushConstantRange.size = sizeof(int) * 2;  // nodeIndex + materialIndex
 
     // Create pipeline layout with multiple descriptor sets and push constants
-    m_gltfPipelineLayout.create(m_device, m_gltfDescriptorLayouts.getAllLayouts(), { pushConstantRange });
+    if (m_gltfPipelineLayout.get() == VK_NULL_HANDLE) {
+        m_gltfPipelineLayout.create(m_device, m_gltfDescriptorLayouts.getAllLayouts(), { pushConstantRange });
+    }
 
     // Create the actual graphics pipeline using GltfVertex
     VkPipelineShaderStageCreateInfo vertStageInfo{};
@@ -515,6 +637,27 @@ void Application::createGltfPipeline() {
     fragStageInfo.module = fragShaderModule;
     fragStageInfo.pName = "main";
 
+    // constant_id 0: TEXTURE_FEEDBACK, constant_id 1: MATERIAL_FEATURES (per variant),
+    // constant_id 2: OIT_ACCUMULATE (OIT blend pipelines only)
+    struct FragmentConstants {
+        VkBool32 textureFeedback;
+        uint32_t materialFeatures;
+        VkBool32 oitAccumulate;
+    } fragConstants{};
+    fragConstants.textureFeedback = sceneModel.model->usesTextureFeedback() ? VK_TRUE : VK_FALSE;
+    fragConstants.oitAccumulate = VK_FALSE;
+    VkSpecializationMapEntry fragEntries[] = {
+        { 0, offsetof(FragmentConstants, textureFeedback), sizeof(VkBool32) },
+        { 1, offsetof(FragmentConstants, materialFeatures), sizeof(uint32_t) },
+        { 2, offsetof(FragmentConstants, oitAccumulate), sizeof(VkBool32) },
+    };
+    VkSpecializationInfo fragSpecialization{};
+    fragSpecialization.mapEntryCount = 3;
+    fragSpecialization.pMapEntries = fragEntries;
+    fragSpecialization.dataSize = sizeof(FragmentConstants);
+    fragSpecialization.pData = &fragConstants;
+    fragStageInfo.pSpecializationInfo = &fragSpecialization;
+
     VkPipelineShaderStageCreateInfo shaderStages[] = { vertStageInfo, fragStageInfo };
 
     // Vertex input state - use GltfVertex
@@ -547,7 +690,7 @@ void Application::createGltfPipeline() {
     rasterizer.rasterizerDiscardEnable = VK_FALSE;
     rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
     rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;  // per variant: none when double-sided
     rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
     rasterizer.depthBiasEnable = VK_FALSE;
 
@@ -561,16 +704,16 @@ void Application::createGltfPipeline() {
     VkPipelineDepthStencilStateCreateInfo depthStencil{};
     depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
     depthStencil.depthTestEnable = VK_TRUE;
-    depthStencil.depthWriteEnable = VK_TRUE;
+    depthStencil.depthWriteEnable = VK_TRUE;  // per variant: off for blended materials
     depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
     depthStencil.depthBoundsTestEnable = VK_FALSE;
     depthStencil.stencilTestEnable = VK_FALSE;
 
-    // Color blending
+    // Color blending (per variant: only blended materials enable it)
     VkPipelineColorBlendAttachmentState colorBlendAttachment{};
     colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
                                            VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_TRUE;
+    colorBlendAttachment.blendEnable = VK_FALSE;
     colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
     colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
     colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
@@ -610,22 +753,135 @@ void Application::createGltfPipeline() {
     pipelineInfo.pDynamicState = &dynamicState;
     pipelineInfo.layout = m_gltfPipelineLayout.get();
     pipelineInfo.renderPass = m_renderPass.get();
-    pipelineInfo.subpass = 0;
+    pipelineInfo.subpass = RenderPass::SUBPASS_SCENE;
+
+    // One pipeline per material variant; fragStageInfo was copied into
+    // shaderStages, so the specialization data is updated in place.
+    // Opaque and mask variants write depth without blending so early-Z and
+    // the blend units stay out of the way; blend variants test depth only.
+    // With the depth pre-pass on, opaque depth is already final: those
+    // variants get a second pipeline that only shades the visible sample.
+    // Mask variants accept equal depth but keep writing it, since mask
+    // primitives without a position+UV stream skip the pre-pass.
+    sceneModel.pipelines.clear();
+    sceneModel.prepassPipelines.clear();
+    for (MaterialFeatureFlags features : sceneModel.model->getMaterialVariants()) {
+        AlphaMode pass = featureAlphaMode(features);
+        bool blend = pass == AlphaMode::Blend;
+        fragConstants.materialFeatures = features;
+        colorBlendAttachment.blendEnable = blend ? VK_TRUE : VK_FALSE;
+        depthStencil.depthWriteEnable = blend ? VK_FALSE : VK_TRUE;
+        rasterizer.cullMode = (features & MATERIAL_FEATURE_DOUBLE_SIDED) ? VK_CULL_MODE_NONE : VK_CULL_MODE_BACK_BIT;
+        std::string name = "gltf " + materialFeatureName(features);
+        sceneModel.pipelines.push_back(m_pipelineCache.createGraphicsPipeline(m_device, pipelineInfo, name.c_str()));
+
+        if (pass == AlphaMode::Blend) {
+            sceneModel.prepassPipelines.push_back(sceneModel.pipelines.back());
+            continue;
+        }
+        if (pass == AlphaMode::Opaque) {
+            depthStencil.depthWriteEnable = VK_FALSE;
+            depthStencil.depthCompareOp = VK_COMPARE_OP_EQUAL;
+            name += " depth-equal";
+        } else {
+            depthStencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+            name += " depth-lequal";
+        }
+        sceneModel.prepassPipelines.push_back(m_pipelineCache.createGraphicsPipeline(m_device, pipelineInfo, name.c_str()));
+        depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+    }
 
-    if (vkCreateGraphicsPipelines(m_device.get(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_gltfPipeline) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create glTF graphics pipeline");
+    // Weighted-blended OIT: blend variants again, drawing into the OIT
+    // subpass's accum/revealage targets with depth test only
+    auto oitBlendStates = WeightedOit::accumulateBlendStates();
+    colorBlending.attachmentCount = static_cast<uint32_t>(oitBlendStates.size());
+    colorBlending.pAttachments = oitBlendStates.data();
+    depthStencil.depthWriteEnable = VK_FALSE;
+    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+    fragConstants.oitAccumulate = VK_TRUE;
+    pipelineInfo.subpass = RenderPass::SUBPASS_OIT_ACCUMULATE;
+
+    sceneModel.oitPipelines.clear();
+    for (MaterialFeatureFlags features : sceneModel.model->getMaterialVariants()) {
+        if (featureAlphaMode(features) != AlphaMode::Blend) {
+            sceneModel.oitPipelines.push_back(VK_NULL_HANDLE);
+            continue;
+        }
+        fragConstants.materialFeatures = features;
+        rasterizer.cullMode = (features & MATERIAL_FEATURE_DOUBLE_SIDED) ? VK_CULL_MODE_NONE : VK_CULL_MODE_BACK_BIT;
+        std::string name = "gltf " + materialFeatureName(features) + " oit";
+        sceneModel.oitPipelines.push_back(m_pipelineCache.createGraphicsPipeline(m_device, pipelineInfo, name.c_str()));
     }
 
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+    pipelineInfo.subpass = RenderPass::SUBPASS_SCENE;
+
     vkDestroyShaderModule(m_device.get(), fragShaderModule, nullptr);
     vkDestroyShaderModule(m_device.get(), vertShaderModule, nullptr);
+
+    if (m_gltfDepthPipelines[GltfModel::DEPTH_PIPELINE_OPAQUE] != VK_NULL_HANDLE) {
+        return;
+    }
+
+    // Depth pre-pass: no color writes, and each pipeline binds the smallest
+    // vertex stream it needs. Opaque: vertex stage only, position stream.
+    // Mask: position+UV stream and a fragment stage that only alpha-tests.
+    auto depthVertCode = readFile("shaders/gltf_depth_vert.spv");
+    auto maskedVertCode = readFile("shaders/gltf_depth_masked_vert.spv");
+    auto maskedFragCode = readFile("shaders/gltf_depth_masked_frag.spv");
+    VkShaderModule depthVertModule = createShaderModule(m_device, depthVertCode);
+    VkShaderModule maskedVertModule = createShaderModule(m_device, maskedVertCode);
+    VkShaderModule maskedFragModule = createShaderModule(m_device, maskedFragCode);
+
+    colorBlendAttachment.colorWriteMask = 0;
+    colorBlendAttachment.blendEnable = VK_FALSE;
+    depthStencil.depthWriteEnable = VK_TRUE;
+    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+
+    auto positionBinding = GltfPositionVertex::getBindingDescription();
+    auto positionAttributes = GltfPositionVertex::getAttributeDescriptions();
+    vertexInputInfo.pVertexBindingDescriptions = &positionBinding;
+    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(positionAttributes.size());
+    vertexInputInfo.pVertexAttributeDescriptions = positionAttributes.data();
+    vertStageInfo.module = depthVertModule;
+    pipelineInfo.stageCount = 1;
+    pipelineInfo.pStages = &vertStageInfo;
+
+    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+    m_gltfDepthPipelines[GltfModel::DEPTH_PIPELINE_OPAQUE] =
+        m_pipelineCache.createGraphicsPipeline(m_device, pipelineInfo, "gltf depth pre-pass");
+    rasterizer.cullMode = VK_CULL_MODE_NONE;
+    m_gltfDepthPipelines[GltfModel::DEPTH_PIPELINE_OPAQUE_DOUBLE_SIDED] =
+        m_pipelineCache.createGraphicsPipeline(m_device, pipelineInfo, "gltf depth pre-pass 2S");
+
+    auto positionUvBinding = GltfPositionUvVertex::getBindingDescription();
+    auto positionUvAttributes = GltfPositionUvVertex::getAttributeDescriptions();
+    vertexInputInfo.pVertexBindingDescriptions = &positionUvBinding;
+    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(positionUvAttributes.size());
+    vertexInputInfo.pVertexAttributeDescriptions = positionUvAttributes.data();
+    vertStageInfo.module = maskedVertModule;
+    fragStageInfo.module = maskedFragModule;
+    fragStageInfo.pSpecializationInfo = nullptr;
+    VkPipelineShaderStageCreateInfo maskedStages[] = { vertStageInfo, fragStageInfo };
+    pipelineInfo.stageCount = 2;
+    pipelineInfo.pStages = maskedStages;
+
+    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+    m_gltfDepthPipelines[GltfModel::DEPTH_PIPELINE_MASK] =
+        m_pipelineCache.createGraphicsPipeline(m_device, pipelineInfo, "gltf depth pre-pass MASK");
+    rasterizer.cullMode = VK_CULL_MODE_NONE;
+    m_gltfDepthPipelines[GltfModel::DEPTH_PIPELINE_MASK_DOUBLE_SIDED] =
+        m_pipelineCache.createGraphicsPipeline(m_device, pipelineInfo, "gltf depth pre-pass MASK 2S");
+
+    vkDestroyShaderModule(m_device.get(), maskedFragModule, nullptr);
+    vkDestroyShaderModule(m_device.get(), maskedVertModule, nullptr);
+    vkDestroyShaderModule(m_device.get(), depthVertModule, nullptr);
 }
 
 void Application::updateGltfDescriptors() {
-    // Only update if glTF model is loaded
-    if (!m_gltfModel.isLoaded()) return;
-
-    // Update descriptor sets with actual buffer and texture data
-    for (uint32_t i = 0; i < kMaxFramesInFlight; i++) {
+    // Sets 0 and 3 are shared by every model; set 1 is written per model
+    for (uint32_t i = 0; i < m_framesInFlight; i++) {
         std::vector<VkWriteDescriptorSet> writes;
 
         // Set 0, Binding 0: Per-frame UBO (camera, lights)
@@ -644,87 +900,222 @@ void Application::updateGltfDescriptors() {
         uboWrite.pBufferInfo = &uboInfo;
         writes.push_back(uboWrite);
 
+        // Set 0, Binding 1: this frame's texture feedback buffer
+        VkDescriptorBufferInfo feedbackInfo{};
+        feedbackInfo.buffer = m_textureFeedback.buffer(i);
+        feedbackInfo.offset = 0;
+        feedbackInfo.range = VK_WHOLE_SIZE;
+
+        VkWriteDescriptorSet feedbackWrite{};
+        feedbackWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        feedbackWrite.dstSet = m_gltfDescriptorSets.getPerFrameSet(i);
+        feedbackWrite.dstBinding = 1;
+        feedbackWrite.dstArrayElement = 0;
+        feedbackWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        feedbackWrite.descriptorCount = 1;
+        feedbackWrite.pBufferInfo = &feedbackInfo;
+        writes.push_back(feedbackWrite);
+
+        // Set 3, Binding 0: Prefiltered specular cube
+        VkDescriptorImageInfo specularInfo{};
+        specularInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        specularInfo.imageView = m_environmentLighting.specularView();
+        specularInfo.sampler = m_environmentLighting.sampler();
+
+        VkWriteDescriptorSet specularWrite{};
+        specularWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        specularWrite.dstSet = m_gltfDescriptorSets.getEnvironmentSet(i);
+        specularWrite.dstBinding = 0;
+        specularWrite.dstArrayElement = 0;
+        specularWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        specularWrite.descriptorCount = 1;
+        specularWrite.pImageInfo = &specularInfo;
+        writes.push_back(specularWrite);
+
+        // Set 3, Binding 1: BRDF LUT
+        VkDescriptorImageInfo brdfLutInfo = specularInfo;
+        brdfLutInfo.imageView = m_environmentLighting.brdfLutView();
+
+        VkWriteDescriptorSet brdfLutWrite = specularWrite;
+        brdfLutWrite.dstBinding = 1;
+        brdfLutWrite.pImageInfo = &brdfLutInfo;
+        writes.push_back(brdfLutWrite);
+
+        // Set 3, Binding 2: SH9 irradiance
+        VkDescriptorBufferInfo irradianceInfo{};
+        irradianceInfo.buffer = m_environmentLighting.irradianceBuffer();
+        irradianceInfo.offset = 0;
+        irradianceInfo.range = EnvironmentLighting::kIrradianceBufferSize;
+
+        VkWriteDescriptorSet irradianceWrite{};
+        irradianceWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        irradianceWrite.dstSet = m_gltfDescriptorSets.getEnvironmentSet(i);
+        irradianceWrite.dstBinding = 2;
+        irradianceWrite.dstArrayElement = 0;
+        irradianceWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        irradianceWrite.descriptorCount = 1;
+        irradianceWrite.pBufferInfo = &irradianceInfo;
+        writes.push_back(irradianceWrite);
+
+        // Update all descriptor sets (set 2 is maintained by the texture heap)
+        vkUpdateDescriptorSets(m_device.get(), static_cast<uint32_t>(writes.size()),
+                               writes.data(), 0, nullptr);
+    }
+}
+
+void Application::updateGltfModelDescriptors(const GltfSceneModel& sceneModel) {
+    for (uint32_t i = 0; i < m_framesInFlight; i++) {
         // Set 1, Binding 0: Transform storage buffer
         VkDescriptorBufferInfo transformInfo{};
-        transformInfo.buffer = m_gltfModel.getTransformBuffer();
+        transformInfo.buffer = sceneModel.model->getTransformBuffer();
         transformInfo.offset = 0;
         transformInfo.range = VK_WHOLE_SIZE;
 
         VkWriteDescriptorSet transformWrite{};
         transformWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        transformWrite.dstSet = m_gltfDescriptorSets.getPerModelSet(i);
+        transformWrite.dstSet = sceneModel.modelSets[i];
         transformWrite.dstBinding = 0;
         transformWrite.dstArrayElement = 0;
         transformWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
         transformWrite.descriptorCount = 1;
         transformWrite.pBufferInfo = &transformInfo;
-        writes.push_back(transformWrite);
 
         // Set 1, Binding 1: Material storage buffer
         VkDescriptorBufferInfo materialInfo{};
-        materialInfo.buffer = m_gltfModel.getMaterialBuffer();
+        materialInfo.buffer = sceneModel.model->getMaterialBuffer();
         materialInfo.offset = 0;
         materialInfo.range = VK_WHOLE_SIZE;
 
-        VkWriteDescriptorSet materialWrite{};
-        materialWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        materialWrite.dstSet = m_gltfDescriptorSets.getPerModelSet(i);
+        VkWriteDescriptorSet materialWrite = transformWrite;
         materialWrite.dstBinding = 1;
-        materialWrite.dstArrayElement = 0;
-        materialWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        materialWrite.descriptorCount = 1;
         materialWrite.pBufferInfo = &materialInfo;
-        writes.push_back(materialWrite);
 
-        // Set 2, Binding 0: Texture array
-        const auto& textures = m_gltfModel.getTextures();
-        std::vector<VkDescriptorImageInfo> imageInfos(std::max(1u, static_cast<uint32_t>(textures.size())));
+        VkWriteDescriptorSet writes[] = { transformWrite, materialWrite };
+        vkUpdateDescriptorSets(m_device.get(), 2, writes, 0, nullptr);
+    }
+}
 
-        if (!textures.empty()) {
-            for (size_t t = 0; t < textures.size(); ++t) {
-                imageInfos[t].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                imageInfos[t].imageView = textures[t].view();
-                imageInfos[t].sampler = textures[t].sampler();
-            }
+// Called after the current frame slot's timeline wait and before the texture heap's
+// beginFrame(): the current frame's copy of the heap is idle, the other frames'
+// copies are updated on their own turn
+void Application::updateGltfStreaming() {
+    // This frame slot's previous submission has finished: its feedback is
+    // ready, indexed by heap slot so each model picks out its own textures
+    if (gltfTextureFeedback()) {
+        m_textureFeedback.collect(m_currentFrame, m_textureFeedbackData);
+    }
+
+    for (GltfSceneModel& sceneModel : m_gltfModels) {
+        if (sceneModel.model->usesTextureFeedback()) {
+            sceneModel.model->applyTextureFeedback(m_currentFrame, m_textureFeedbackData);
+        }
+        sceneModel.model->updateStreaming(uploadFrame(), m_uploadScheduler, m_framesInFlight, m_currentFrame);
+    }
+
+    // Full chains queued by any model, nearest to the camera first
+    m_uploadScheduler.runQueued(uploadFrame());
+}
+
+UploadFrame Application::uploadFrame() {
+    return UploadFrame{ m_device, m_commandPool.get(), m_device.graphicsQ(), m_deletionQueue,
+                        m_syncObjects.submittedValue() };
+}
+
+bool Application::gltfTextureFeedback() const {
+    for (const GltfSceneModel& sceneModel : m_gltfModels) {
+        if (sceneModel.model->usesTextureFeedback()) return true;
+    }
+    return false;
+}
+
+void Application::reportLoadTimings() {
+    auto elapsedMs = [this] {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_startTime).count();
+    };
+    if (!m_firstFrameReported) {
+        m_firstFrameReported = true;
+        std::cout << "Time to first frame: " << elapsedMs() << " ms" << std::endl;
+    }
+    if (!m_fullQualityReported && !m_gltfModels.empty() && m_gltfModels.front().model->isStreamingComplete()) {
+        m_fullQualityReported = true;
+        std::cout << "Time to full texture quality: " << elapsedMs() << " ms" << std::endl;
+    }
+}
+
+// ============================================================================
+// Runtime Model Loading
+// ============================================================================
+
+// Publish a fully uploaded model: it is drawn from the next recorded frame on
+void Application::addGltfModel(std::unique_ptr<GltfModel> model) {
+    GltfSceneModel sceneModel;
+    sceneModel.model = std::move(model);
+    sceneModel.modelSets = GltfDescriptorSets::allocatePerModelSets(
+        m_device, m_gltfDescriptorPool.get(), m_gltfDescriptorLayouts, m_framesInFlight);
+    createGltfPipelines(sceneModel);
+    updateGltfModelDescriptors(sceneModel);
+    m_gltfModels.push_back(std::move(sceneModel));
+}
+
+// Frames already submitted may still draw the model; everything it owns is
+// released once the timeline passes the latest of them
+void Application::unloadGltfModel(size_t index) {
+    GltfSceneModel& sceneModel = m_gltfModels[index];
+    uint64_t retireValue = m_syncObjects.submittedValue();
+    std::cout << "Unloading " << sceneModel.model->getModelPath() << std::endl;
+
+    sceneModel.model->retire(m_device, m_deletionQueue, retireValue);
+
+    VkDevice device = m_device.get();
+    VkDescriptorPool pool = m_gltfDescriptorPool.get();
+    std::vector<VkPipeline> pipelines = sceneModel.pipelines;
+    for (size_t i = 0; i < sceneModel.prepassPipelines.size(); ++i) {
+        if (sceneModel.prepassPipelines[i] != sceneModel.pipelines[i]) {
+            pipelines.push_back(sceneModel.prepassPipelines[i]);
+        }
+    }
+    for (VkPipeline pipeline : sceneModel.oitPipelines) {
+        if (pipeline != VK_NULL_HANDLE) pipelines.push_back(pipeline);
+    }
+    m_deletionQueue.push(retireValue, [device, pool, pipelines, sets = sceneModel.modelSets]() {
+        for (VkPipeline pipeline : pipelines) {
+            vkDestroyPipeline(device, pipeline, nullptr);
+        }
+        vkFreeDescriptorSets(device, pool, static_cast<uint32_t>(sets.size()), sets.data());
+    });
+
+    m_gltfModels.erase(m_gltfModels.begin() + static_cast<std::ptrdiff_t>(index));
+}
+
+// Called after the frame slot's timeline wait and before the texture heap's
+// beginFrame(), so the slots of a model published here are in this frame's heap copy
+void Application::updateModelLoading() {
+    if (m_unloadRequested) {
+        m_unloadRequested = false;
+        if (m_gltfModels.size() > 1) {
+            unloadGltfModel(m_gltfModels.size() - 1);
         } else {
-            // If no textures, use a dummy texture (base texture as fallback)
-            imageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageInfos[0].imageView = m_baseTexture.view();
-            imageInfos[0].sampler = m_baseTexture.sampler();
+            std::cout << "Only the startup model is loaded" << std::endl;
         }
+    }
 
-        VkWriteDescriptorSet texturesWrite{};
-        texturesWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        texturesWrite.dstSet = m_gltfDescriptorSets.getTexturesSet(i);
-        texturesWrite.dstBinding = 0;
-        texturesWrite.dstArrayElement = 0;
-        texturesWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        texturesWrite.descriptorCount = static_cast<uint32_t>(imageInfos.size());
-        texturesWrite.pImageInfo = imageInfos.data();
-        writes.push_back(texturesWrite);
-
-        // Set 3, Binding 0: Environment cubemap
-        VkDescriptorImageInfo cubemapInfo{};
-        cubemapInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        cubemapInfo.imageView = m_cubemap.view();
-        cubemapInfo.sampler = m_cubemap.sampler();
-
-        VkWriteDescriptorSet cubemapWrite{};
-        cubemapWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        cubemapWrite.dstSet = m_gltfDescriptorSets.getEnvironmentSet(i);
-        cubemapWrite.dstBinding = 0;
-        cubemapWrite.dstArrayElement = 0;
-        cubemapWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        cubemapWrite.descriptorCount = 1;
-        cubemapWrite.pImageInfo = &cubemapInfo;
-        writes.push_back(cubemapWrite);
-
-        // Update all descriptor sets
-        vkUpdateDescriptorSets(m_device.get(), static_cast<uint32_t>(writes.size()),
-                               writes.data(), 0, nullptr);
+    // Whatever upload budget streaming left this frame
+    std::vector<std::unique_ptr<GltfModel>> loaded = m_modelLoader.update(
+        m_device, m_commandPool.get(), m_device.graphicsQ(), m_textureHeap, m_samplerCache,
+        &m_mipGenerator, &m_transferQueue, m_settings.gltfLoad, m_uploadScheduler);
+    for (std::unique_ptr<GltfModel>& model : loaded) {
+        addGltfModel(std::move(model));
     }
 }
 
+void Application::bindGltfDescriptorSets(VkCommandBuffer cmd, const GltfSceneModel& sceneModel) const {
+    auto descriptorSets = m_gltfDescriptorSets.getAllSets(m_currentFrame, sceneModel.modelSets[m_currentFrame]);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            m_gltfPipelineLayout.get(), 0,
+                            static_cast<uint32_t>(descriptorSets.size()),
+                            descriptorSets.data(), 0, nullptr);
+}
+
 // ============================================================================
 // Main Loop & Rendering
 // ============================================================================
@@ -748,7 +1139,7 @@ void Application::updateUniformBuffer(uint32_t currentImage) {
     UniformBufferObject ubo{};
     ubo.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(30.0f), glm::vec3(0.0f, 1.0f, 0.0f));  // Rotate around Y-axis
 	ubo.view = glm::lookAt(viewPos, viewPos + viewDir, glm::vec3(0.0f, 1.0f, 0.0f));  // Y-up for glTF
-    ubo.proj = glm::perspective(glm::radians(45.0f), (float)kWidth / (float)kHeight, 0.1f, 10.0f);
+    ubo.proj = glm::perspective(glm::radians(45.0f), (float)m_swapchain.extent().width / (float)m_swapchain.extent().height, 0.1f, 10.0f);
     ubo.proj[1][1] *= -1; // GLM was originally designed for OpenGL, where the Y coordinate of the clip coordinates is inverted.
 	ubo.normalMat = glm::transpose(glm::inverse(ubo.model));
     ubo.cameraPosition = glm::vec4(viewPos, 0.0f);
@@ -762,31 +1153,53 @@ void Application::updateUniformBuffer(uint32_t currentImage) {
 }
 
 void Application::drawFrame() {
-    vkWaitForFences(m_device.get(), 1, &m_syncObjects.getInFlightFence(m_currentFrame), VK_TRUE, UINT64_MAX);
+    // CPU frame time, split by whether a runtime model load was in progress
+    auto frameStart = std::chrono::steady_clock::now();
+    if (m_lastFrameStart.time_since_epoch().count() != 0) {
+        m_modelLoader.recordFrameTime(std::chrono::duration<double, std::milli>(frameStart - m_lastFrameStart).count());
+    }
+    m_lastFrameStart = frameStart;
+
+    // This slot's previous submission must be done before its command buffer,
+    // UBO and descriptor copies are reused; with fewer frames in flight the
+    // CPU runs closer behind the GPU (lower latency), with more it rarely stalls
+    m_syncObjects.waitForFrame(m_device, m_currentFrame);
+    m_deletionQueue.collect(m_syncObjects.completedValue(m_device));
 
     uint32_t imageIndex;
     VkResult result = vkAcquireNextImageKHR(m_device.get(), 
         m_swapchain.get(), UINT64_MAX, m_syncObjects.getImageAvailableSemaphore(m_currentFrame), VK_NULL_HANDLE, &imageIndex);
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-        m_swapchain.recreate(m_device, m_surface.get(), m_window);
+        recreateSwapchain();
         return;
     }
     else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
         throw std::runtime_error("failed to acquire swap chain image!");
     }
 
-    // Only reset the fence if we are submitting work
-    vkResetFences(m_device.get(), 1, &m_syncObjects.getInFlightFence(m_currentFrame));
+    // Stream in finished textures, then add or drop models, sharing one upload
+    // budget; both run only for frames that will be submitted, ahead of this
+    // frame's texture heap update
+    m_uploadScheduler.beginFrame(m_syncObjects.submittedValue(), m_syncObjects.completedValue(m_device));
+    updateGltfStreaming();
+    updateModelLoading();
+    m_uploadScheduler.printStatus();
+    m_textureHeap.beginFrame(m_device, m_currentFrame);
+    m_pipelineStats.collect(m_device, m_currentFrame);
+    m_gpuTimer.collect(m_device, m_currentFrame);
 
     updateUniformBuffer(m_currentFrame);
 
-    // Update glTF transforms if model is loaded
-    if (m_gltfModel.isLoaded()) {
-        m_gltfModel.updateTransforms(m_device);
+    // Update glTF transforms and draw order
+    for (GltfSceneModel& sceneModel : m_gltfModels) {
+        sceneModel.model->updateTransforms(m_device);
+        sceneModel.model->sortDraws(viewPos, viewDir, !m_oitTransparency);
     }
 
     m_commandBuffers.reset(m_currentFrame);
+    m_drawRecorder.beginFrame(m_device, m_currentFrame);
+    auto recordStart = std::chrono::steady_clock::now();
 
     // Manually record command buffer to include both OBJ and glTF rendering
     VkCommandBuffer cmd = m_commandBuffers[m_currentFrame];
@@ -797,6 +1210,10 @@ void Application::drawFrame() {
         throw std::runtime_error("Failed to begin recording command buffer");
     }
 
+    bool depthPrepass = m_depthPrepass && !m_gltfModels.empty();
+    m_pipelineStats.reset(cmd, m_currentFrame, depthPrepass);
+    m_gpuTimer.reset(cmd, m_currentFrame);
+
     // Begin render pass
     VkRenderPassBeginInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -805,57 +1222,64 @@ void Application::drawFrame() {
     renderPassInfo.renderArea.offset = {0, 0};
     renderPassInfo.renderArea.extent = m_swapchain.extent();
 
-    std::array<VkClearValue, 2> clearValues{};
+    // Indexed by attachment (see RenderPass.h); the swapchain resolve target is not cleared
+    std::array<VkClearValue, 5> clearValues{};
     clearValues[0].color = {{0.22f, 0.22f, 0.22f, 1.0f}};
     clearValues[1].depthStencil = {1.0f, 0};
+    clearValues[3].color = {{0.0f, 0.0f, 0.0f, 0.0f}};   // OIT accum
+    clearValues[4].color = {{1.0f, 0.0f, 0.0f, 0.0f}};   // OIT revealage: fully revealed
     renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
     renderPassInfo.pClearValues = clearValues.data();
 
-    vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-    // Set viewport and scissor
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = static_cast<float>(m_swapchain.extent().width);
-    viewport.height = static_cast<float>(m_swapchain.extent().height);
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-    vkCmdSetViewport(cmd, 0, 1, &viewport);
-
-    VkRect2D scissor{};
-    scissor.offset = {0, 0};
-    scissor.extent = m_swapchain.extent();
-    vkCmdSetScissor(cmd, 0, 1, &scissor);
-
-    // Draw OBJ model (DISABLED - showing glTF only)
-    // vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline.get());
-    // VkBuffer vertexBuffers[] = {m_vertexBuf.get()};
-    // VkDeviceSize offsets[] = {0};
-    // vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, offsets);
-    // vkCmdBindIndexBuffer(cmd, m_indexBuf.get(), 0, VK_INDEX_TYPE_UINT32);
-    // vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline.getLayout(),
-    //                         0, 1, &m_descriptorSets[m_currentFrame], 0, nullptr);
-    // vkCmdDrawIndexed(cmd, static_cast<uint32_t>(m_indexBuf.size() / 4), 1, 0, 0, 0);
-
-    // Draw glTF model
-    if (m_gltfModel.isLoaded()) {
-        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_gltfPipeline);
+    // Transparency: sorted blending draws back-to-front straight into the
+    // scene (within each model; models draw in load order); OIT accumulates
+    // in its own subpass and resolves in the composite one. Both are timed so
+    // the two modes can be compared.
+    bool blendDraws = false;
+    for (const GltfSceneModel& sceneModel : m_gltfModels) {
+        blendDraws = blendDraws || sceneModel.model->hasBlendDraws();
+    }
+    bool oit = blendDraws && m_oitTransparency;
+
+    // With more than one recording thread the scene subpass is recorded into
+    // secondary command buffers in parallel; otherwise inline, as below
+    if (m_drawRecorder.slotCount() > 1 && !m_gltfModels.empty()) {
+        vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        recordSceneSecondaries(cmd, renderPassInfo.framebuffer, depthPrepass, blendDraws && !oit);
+    } else {
+        vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        recordSceneInline(cmd, depthPrepass, blendDraws && !oit);
+    }
 
-        auto descriptorSets = m_gltfDescriptorSets.getAllSets(m_currentFrame);
-        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                m_gltfPipelineLayout.get(), 0,
-                                static_cast<uint32_t>(descriptorSets.size()),
-                                descriptorSets.data(), 0, nullptr);
+    vkCmdNextSubpass(cmd, VK_SUBPASS_CONTENTS_INLINE);
+    if (oit) {
+        setViewportAndScissor(cmd);   // executed secondaries leave the dynamic state undefined
+        m_gpuTimer.begin(cmd, m_currentFrame, kTimerOitBlend);
+        for (const GltfSceneModel& sceneModel : m_gltfModels) {
+            if (!sceneModel.model->hasBlendDraws()) continue;
+            bindGltfDescriptorSets(cmd, sceneModel);
+            sceneModel.model->draw(cmd, m_gltfPipelineLayout.get(), sceneModel.oitPipelines, m_currentFrame,
+                                   GltfModel::DRAW_PASS_BLEND);
+        }
+    }
 
-        m_gltfModel.draw(cmd, m_gltfPipelineLayout.get(), m_currentFrame);
+    vkCmdNextSubpass(cmd, VK_SUBPASS_CONTENTS_INLINE);
+    if (oit) {
+        m_weightedOit.recordResolve(cmd);
+        m_gpuTimer.end(cmd, m_currentFrame, kTimerOitBlend);
     }
 
     vkCmdEndRenderPass(cmd);
 
+    if (gltfTextureFeedback()) {
+        TextureFeedback::recordHostBarrier(cmd);
+    }
+
     if (vkEndCommandBuffer(cmd) != VK_SUCCESS) {
         throw std::runtime_error("Failed to record command buffer");
     }
+    m_drawRecorder.recordFrameTime(
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - recordStart).count());
 
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -868,17 +1292,35 @@ void Application::drawFrame() {
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &m_commandBuffers[m_currentFrame];
 
-    VkSemaphore signalSemaphores[] = { m_syncObjects.getRenderFinishedSemaphore(m_currentFrame) };
-    submitInfo.signalSemaphoreCount = 1;
+    // Present waits on the binary semaphore; the timeline value marks the frame done
+    VkSemaphore signalSemaphores[] = { m_syncObjects.getRenderFinishedSemaphore(m_currentFrame), m_syncObjects.timeline() };
+    submitInfo.signalSemaphoreCount = 2;
     submitInfo.pSignalSemaphores = signalSemaphores;
-    if (vkQueueSubmit(m_device.graphicsQ(), 1, &submitInfo, m_syncObjects.getInFlightFence(m_currentFrame)) != VK_SUCCESS) {
+
+    uint64_t waitValues[] = { 0 };
+    uint64_t signalValues[] = { 0, m_syncObjects.nextFrameValue(m_currentFrame) };
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = 1;
+    timelineInfo.pWaitSemaphoreValues = waitValues;
+    timelineInfo.signalSemaphoreValueCount = 2;
+    timelineInfo.pSignalSemaphoreValues = signalValues;
+    submitInfo.pNext = &timelineInfo;
+
+    if (vkQueueSubmit(m_device.graphicsQ(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
         throw std::runtime_error("failed to submit draw command buffer!");
     }
 
+    // Replaced swapchains go once this frame, submitted after a present to
+    // the current swapchain, has completed
+    if (m_presentedSinceRecreate && m_swapchain.hasOld()) {
+        m_swapchain.retireOld(m_device, m_deletionQueue, signalValues[1]);
+    }
+
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores = signalSemaphores;
+    presentInfo.pWaitSemaphores = &signalSemaphores[0];
     VkSwapchainKHR swapChains[] = { m_swapchain.get()};
     presentInfo.swapchainCount = 1;
     presentInfo.pSwapchains = swapChains;
@@ -889,13 +1331,260 @@ void Application::drawFrame() {
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_framebufferResized) {
         m_framebufferResized = false;
-        m_swapchain.recreate(m_device, m_surface.get(), m_window);
+        recreateSwapchain();
     }
     else if (result != VK_SUCCESS) {
         throw std::runtime_error("failed to present swap chain image!");
     }
+    else {
+        m_presentedSinceRecreate = true;
+    }
 
-    m_currentFrame = (m_currentFrame + 1) % kMaxFramesInFlight;
+    reportLoadTimings();
+
+    // Timed once the startup model's textures are cooked and no model is
+    // loading, so the job threads have nothing else to do
+    if (m_settings.benchmarkRecording && !m_recordingBenchmarked && !m_gltfModels.empty() &&
+        m_gltfModels.front().model->isStreamingComplete() && m_modelLoader.pending() == 0) {
+        m_recordingBenchmarked = true;
+        benchmarkRecording();
+    }
+
+    m_currentFrame = (m_currentFrame + 1) % m_framesInFlight;
+}
+
+void Application::setViewportAndScissor(VkCommandBuffer cmd) const {
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(m_swapchain.extent().width);
+    viewport.height = static_cast<float>(m_swapchain.extent().height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = m_swapchain.extent();
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+}
+
+// Subpass 0 straight into the frame's primary command buffer: the depth
+// pre-pass, the opaque and alpha-tested main pass and sorted blending, each
+// model in load order
+void Application::recordSceneInline(VkCommandBuffer cmd, bool depthPrepass, bool sortedBlend) {
+    setViewportAndScissor(cmd);
+
+    // Draw OBJ model (DISABLED - showing glTF only)
+    // vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline.get());
+    // VkBuffer vertexBuffers[] = {m_vertexBuf.get()};
+    // VkDeviceSize offsets[] = {0};
+    // vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, offsets);
+    // vkCmdBindIndexBuffer(cmd, m_indexBuf.get(), 0, VK_INDEX_TYPE_UINT32);
+    // vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline.getLayout(),
+    //                         0, 1, &m_descriptorSets[m_currentFrame], 0, nullptr);
+    // vkCmdDrawIndexed(cmd, static_cast<uint32_t>(m_indexBuf.size() / 4), 1, 0, 0, 0);
+
+    // Draw glTF models; each binds its own set 1 alongside the shared sets
+    if (!m_gltfModels.empty()) {
+        // Depth pre-pass in the same subpass: opaque and alpha-tested depth
+        // first, then the main pass shades each opaque pixel once via EQUAL
+        if (depthPrepass) {
+            m_pipelineStats.begin(cmd, m_currentFrame, PipelineStatistics::SCOPE_DEPTH_PREPASS);
+            for (const GltfSceneModel& sceneModel : m_gltfModels) {
+                bindGltfDescriptorSets(cmd, sceneModel);
+                sceneModel.model->drawDepthPrepass(cmd, m_gltfPipelineLayout.get(), m_gltfDepthPipelines);
+            }
+            m_pipelineStats.end(cmd, m_currentFrame, PipelineStatistics::SCOPE_DEPTH_PREPASS);
+        }
+
+        m_pipelineStats.begin(cmd, m_currentFrame, PipelineStatistics::SCOPE_MAIN_PASS);
+        for (const GltfSceneModel& sceneModel : m_gltfModels) {
+            bindGltfDescriptorSets(cmd, sceneModel);
+            sceneModel.model->draw(cmd, m_gltfPipelineLayout.get(),
+                                   depthPrepass ? sceneModel.prepassPipelines : sceneModel.pipelines, m_currentFrame,
+                                   GltfModel::DRAW_PASS_OPAQUE | GltfModel::DRAW_PASS_MASK);
+        }
+        m_pipelineStats.end(cmd, m_currentFrame, PipelineStatistics::SCOPE_MAIN_PASS);
+    }
+
+    if (sortedBlend) {
+        m_gpuTimer.begin(cmd, m_currentFrame, kTimerSortedBlend);
+        for (const GltfSceneModel& sceneModel : m_gltfModels) {
+            if (!sceneModel.model->hasBlendDraws()) continue;
+            bindGltfDescriptorSets(cmd, sceneModel);
+            sceneModel.model->draw(cmd, m_gltfPipelineLayout.get(), sceneModel.pipelines, m_currentFrame,
+                                   GltfModel::DRAW_PASS_BLEND);
+        }
+        m_gpuTimer.end(cmd, m_currentFrame, kTimerSortedBlend);
+    }
+}
+
+// Subpass 0 as secondary command buffers recorded over the job threads: each
+// pass of each model is cut into draw list slices, in the same order as the
+// inline path, and the primary executes them all. A secondary inherits no
+// dynamic state or bindings, so every slice sets its own. Fragment counts
+// need a scope's queries in one command buffer and are only gathered when
+// recording inline (--record-threads 1); the sorted blend timestamps go in
+// the first and last blend slices.
+void Application::recordSceneSecondaries(VkCommandBuffer cmd, VkFramebuffer framebuffer, bool depthPrepass,
+                                         bool sortedBlend) {
+    m_drawSlices.clear();
+    auto addSlices = [this](DrawSlice::Pass pass, const GltfSceneModel& sceneModel, size_t first, size_t last) {
+        if (first >= last) return;
+        const size_t slots = m_drawRecorder.slotCount();
+        const size_t sliceSize = std::max(kMinDrawsPerSecondary, (last - first + slots - 1) / slots);
+        for (size_t begin = first; begin < last; begin += sliceSize) {
+            m_drawSlices.push_back({ pass, &sceneModel, begin, std::min(begin + sliceSize, last), false, false });
+        }
+    };
+
+    if (depthPrepass) {
+        for (const GltfSceneModel& sceneModel : m_gltfModels) {
+            addSlices(DrawSlice::DEPTH_PREPASS, sceneModel, 0, sceneModel.model->firstBlendEntry());
+        }
+    }
+    for (const GltfSceneModel& sceneModel : m_gltfModels) {
+        addSlices(DrawSlice::MAIN, sceneModel, 0, sceneModel.model->firstBlendEntry());
+    }
+    if (sortedBlend) {
+        size_t firstBlendSlice = m_drawSlices.size();
+        for (const GltfSceneModel& sceneModel : m_gltfModels) {
+            addSlices(DrawSlice::SORTED_BLEND, sceneModel, sceneModel.model->firstBlendEntry(),
+                      sceneModel.model->drawListSize());
+        }
+        if (firstBlendSlice < m_drawSlices.size()) {
+            m_drawSlices[firstBlendSlice].timerBegin = true;
+            m_drawSlices.back().timerEnd = true;
+        }
+    }
+
+    const std::vector<VkCommandBuffer>& secondaries = m_drawRecorder.record(
+        m_device, m_jobs, m_renderPass.get(), 0, framebuffer, m_drawSlices.size(),
+        [&](VkCommandBuffer secondary, size_t index) {
+            const DrawSlice& slice = m_drawSlices[index];
+            const GltfSceneModel& sceneModel = *slice.sceneModel;
+            setViewportAndScissor(secondary);
+            bindGltfDescriptorSets(secondary, sceneModel);
+            if (slice.timerBegin) {
+                m_gpuTimer.begin(secondary, m_currentFrame, kTimerSortedBlend);
+            }
+            switch (slice.pass) {
+            case DrawSlice::DEPTH_PREPASS:
+                sceneModel.model->drawDepthPrepass(secondary, m_gltfPipelineLayout.get(), m_gltfDepthPipelines,
+                                                   slice.firstEntry, slice.lastEntry);
+                break;
+            case DrawSlice::MAIN:
+                sceneModel.model->draw(secondary, m_gltfPipelineLayout.get(),
+                                       depthPrepass ? sceneModel.prepassPipelines : sceneModel.pipelines,
+                                       m_currentFrame, GltfModel::DRAW_PASS_OPAQUE | GltfModel::DRAW_PASS_MASK,
+                                       slice.firstEntry, slice.lastEntry);
+                break;
+            case DrawSlice::SORTED_BLEND:
+                sceneModel.model->draw(secondary, m_gltfPipelineLayout.get(), sceneModel.pipelines, m_currentFrame,
+                                       GltfModel::DRAW_PASS_BLEND, slice.firstEntry, slice.lastEntry);
+                break;
+            }
+            if (slice.timerEnd) {
+                m_gpuTimer.end(secondary, m_currentFrame, kTimerSortedBlend);
+            }
+        });
+
+    if (!secondaries.empty()) {
+        vkCmdExecuteCommands(cmd, static_cast<uint32_t>(secondaries.size()), secondaries.data());
+    }
+}
+
+// Records the startup model's draws, repeated up to a 50k-draw frame, into
+// secondary command buffers at 1..N threads and prints the speedups (run
+// with --benchmark-recording). Every run uses m_jobs, limited to N threads
+// by recording N slices. Nothing is submitted; the pools are reset between
+// frames.
+void Application::benchmarkRecording() {
+    if (m_gltfModels.empty()) return;
+
+    using Clock = std::chrono::steady_clock;
+    const GltfSceneModel& sceneModel = m_gltfModels.front();
+    GltfModel& model = *sceneModel.model;
+    model.updateTransforms(m_device);
+    model.sortDraws(viewPos, glm::normalize(origin - viewPos));
+    const size_t modelDraws = model.drawListSize();
+    if (modelDraws == 0) return;
+
+    constexpr size_t kTargetDraws = 50000;
+    const size_t copies = (kTargetDraws + modelDraws - 1) / modelDraws;
+    const size_t frameDraws = copies * modelDraws;
+
+    std::vector<uint32_t> threadCounts;
+    const uint32_t jobThreads = m_jobs.threadCount();
+    for (uint32_t threads = 1; threads < jobThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(jobThreads);
+
+    std::cout << "Recording scaling: " << frameDraws << " draws (" << copies << " copies of "
+              << m_settings.gltfModelPath << ")" << std::endl;
+
+    std::vector<std::pair<uint32_t, double>> results;
+    for (uint32_t threads : threadCounts) {
+        ParallelRecorder recorder;
+        recorder.create(m_device, 1, threads);
+
+        // Slices of the repeated list, each walked one model copy at a time
+        const size_t sliceSize = std::max(kMinDrawsPerSecondary, (frameDraws + threads - 1) / threads);
+        const size_t slices = (frameDraws + sliceSize - 1) / sliceSize;
+        auto recordFrame = [&] {
+            recorder.beginFrame(m_device, 0);
+            recorder.record(m_device, m_jobs, m_renderPass.get(), 0, VK_NULL_HANDLE, slices,
+                            [&](VkCommandBuffer secondary, size_t index) {
+                setViewportAndScissor(secondary);
+                bindGltfDescriptorSets(secondary, sceneModel);
+                size_t first = index * sliceSize;
+                size_t last = std::min(first + sliceSize, frameDraws);
+                while (first < last) {
+                    size_t copyStart = first - first % modelDraws;
+                    size_t copyEnd = std::min(copyStart + modelDraws, last);
+                    model.draw(secondary, m_gltfPipelineLayout.get(), sceneModel.pipelines, 0,
+                               GltfModel::DRAW_PASS_ALL, first - copyStart, copyEnd - copyStart);
+                    first = copyEnd;
+                }
+            });
+        };
+
+        constexpr int kWarmup = 5, kFrames = 50;
+        for (int i = 0; i < kWarmup; ++i) {
+            recordFrame();
+        }
+        auto start = Clock::now();
+        for (int i = 0; i < kFrames; ++i) {
+            recordFrame();
+        }
+        results.emplace_back(threads, std::chrono::duration<double, std::milli>(Clock::now() - start).count() / kFrames);
+        recorder.destroy(m_device);
+    }
+
+    std::cout << std::setw(10) << "threads" << std::setw(12) << "record ms" << std::setw(10) << "speedup" << std::endl;
+    for (const auto& [threads, ms] : results) {
+        std::cout << std::setw(10) << threads << std::fixed
+                  << std::setprecision(3) << std::setw(12) << ms
+                  << std::setprecision(2) << std::setw(9) << results.front().second / ms << "x" << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+}
+
+// Everything submitted so far may still use the old attachments; they are
+// released once the timeline passes the last such frame while rendering
+// continues into the new ones. The old swapchain may also still have
+// presents queued, which the timeline does not cover: it is retired only
+// after a frame has been presented on the new swapchain (drawFrame).
+void Application::recreateSwapchain() {
+    uint64_t retireValue = m_syncObjects.submittedValue();
+    m_swapchain.recreate(m_device, m_surface.get(), m_window);
+    m_presentedSinceRecreate = false;
+    if (m_framebuffer.recreate(m_device, m_swapchain, m_renderPass, m_deletionQueue, retireValue)) {
+        m_weightedOit.setTargets(m_device, m_framebuffer.oitAccumView(), m_framebuffer.oitRevealageView(),
+                                 &m_deletionQueue, retireValue);
+    }
 }
 
 // ============================================================================
@@ -903,12 +1592,14 @@ void Application::drawFrame() {
 // ============================================================================
 
 void Application::cleanup() {
+    m_deletionQueue.flush();
     m_swapchain.destroy(m_device);
     m_baseTexture.destroy(m_device);
     m_normalTexture.destroy(m_device);
     m_metalRoughnessTexture.destroy(m_device);
     m_aoTexture.destroy(m_device);
     m_emissiveTexture.destroy(m_device);
+    m_environmentLighting.destroy(m_device);
     m_cubemap.destroy(m_device);
     m_vertexBuf.destroy(m_device);
     m_indexBuf.destroy(m_device);
@@ -920,23 +1611,49 @@ void Application::cleanup() {
     m_graphicsPipeline.destroy(m_device);
     m_pipelineLayout.destroy(m_device);
 
-    // glTF resources
-    m_gltfModel.destroy(m_device);
+    // glTF resources; models retire through the deletion queue, which the
+    // idle device lets run at once
+    m_modelLoader.destroy(m_device);
+    m_modelLoader.printReport();
+    m_uploadScheduler.printReport();
+    while (!m_gltfModels.empty()) {
+        unloadGltfModel(m_gltfModels.size() - 1);
+    }
+    m_deletionQueue.flush();
+    m_jobs.stop();  // after the models: their texture streamers submit jobs
+    m_textureFeedback.destroy(m_device);
     m_gltfDescriptorSets.destroy();
     m_gltfDescriptorPool.destroy(m_device);
     m_gltfDescriptorLayouts.destroy(m_device);
-    if (m_gltfPipeline != VK_NULL_HANDLE) {
-        vkDestroyPipeline(m_device.get(), m_gltfPipeline, nullptr);
-        m_gltfPipeline = VK_NULL_HANDLE;
+    m_textureHeap.destroy(m_device);
+    m_samplerCache.destroy(m_device);
+    m_mipGenerator.destroy(m_device);
+    for (VkPipeline& pipeline : m_gltfDepthPipelines) {
+        vkDestroyPipeline(m_device.get(), pipeline, nullptr);
+        pipeline = VK_NULL_HANDLE;
     }
     m_gltfPipelineLayout.destroy(m_device);
+    m_weightedOit.destroy(m_device);
+
+    m_pipelineCache.printStats();
+    m_pipelineCache.save(m_device);
+    m_pipelineCache.destroy(m_device);
 
     m_renderPass.destroy(m_device);
 
     m_framebuffer.destroy(m_device);
 
+    m_pipelineStats.printReport();
+    m_pipelineStats.destroy(m_device);
+    m_gpuTimer.printReport();
+    m_gpuTimer.destroy(m_device);
+
     m_syncObjects.destroy(m_device);
 
+    m_computeQueue.destroy(m_device);
+    m_transferQueue.destroy(m_device);
+    m_drawRecorder.printReport();
+    m_drawRecorder.destroy(m_device);
     m_commandPool.destroy(m_device);
     m_surface.destroy(m_instance.get());
 
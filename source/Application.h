@@ -1,6 +1,8 @@
 ﻿#pragma once
 
+#include <chrono>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "Instance.h"
@@ -10,23 +12,41 @@
 #include "Swapchain.h"
 #include "RenderPass.h"
 #include "Pipeline.h"
+#include "PipelineCache.h"
+#include "PipelineStatistics.h"
+#include "GpuTimer.h"
+#include "WeightedOit.h"
 #include "Descriptor.h"
 #include "Framebuffer.h"
 #include "CommandBuffer.h"
+#include "ParallelRecorder.h"
 #include "SyncObjects.h"
+#include "DeletionQueue.h"
 #include "Vertex.h"
 #include "VertexIndexBuffers.h"
 #include "UniformBuffers.h"
 #include "Texture.h"
+#include "TextureCooker.h"
+#include "SamplerCache.h"
+#include "TextureFeedback.h"
 #include "Cubemap.h"
+#include "EnvironmentLighting.h"
+#include "MipGenerator.h"
+#include "AsyncQueue.h"
 #include "GltfModel.h"
+#include "ModelLoader.h"
 #include "GltfDescriptors.h"
+#include "BindlessTextureHeap.h"
+#include "AppSettings.h"
 
 // Forward declaration only, glfw3.h is not included (to reduce compilation overhead)
 struct GLFWwindow;
 
 class Application final {
 public:
+    Application() = default;
+    explicit Application(const AppSettings& settings) : m_settings(settings) {}
+
     void run();
 
 private:
@@ -34,16 +54,25 @@ private:
     static constexpr const char* kApplicationName = "VULKAN";
     static constexpr uint32_t kWidth = 1500;
     static constexpr uint32_t kHeight = 1200;
-    static constexpr int kMaxFramesInFlight = 2;
+    // GpuTimer scopes: the same transparent draws in either blending mode
+    static constexpr uint32_t kTimerSortedBlend = 0;
+    static constexpr uint32_t kTimerOitBlend = 1;
+    // glTF models in the scene at once (startup model included)
+    static constexpr uint32_t kMaxGltfModels = 8;
+    // Smallest draw list slice worth a secondary command buffer of its own
+    static constexpr size_t kMinDrawsPerSecondary = 256;
 #ifndef NDEBUG
     static constexpr bool kEnableValidationLayers = true;
 #else
     static constexpr bool kEnableValidationLayers = false;
 #endif
 
+    AppSettings m_settings;
+
     // ---- Window & Callback ----
     GLFWwindow* m_window = nullptr;
     static void framebufferResizeCallback(GLFWwindow* window, int width, int height);
+    static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 
     // ---- Vulkan Objects ----
     Instance m_instance;
@@ -54,12 +83,17 @@ private:
     RenderPass m_renderPass;
     PipelineLayoutRAII m_pipelineLayout;
     GraphicsPipeline m_graphicsPipeline;
+    PipelineCache m_pipelineCache;  // shared by every pipeline, persisted across runs
     DescriptorSetLayoutRAII m_descriptorSetLayout;
     Framebuffer m_framebuffer;
     CommandPool m_commandPool;
+    AsyncQueue m_transferQueue;   // uploads; the graphics queue when there is no transfer family
+    AsyncQueue m_computeQueue;    // compute mip generation; likewise falls back to graphics
     CommandBuffer m_commandBuffers;
+    ParallelRecorder m_drawRecorder;   // scene subpass draws, recorded over the job threads
 
     SyncObjects m_syncObjects;
+    DeletionQueue m_deletionQueue;   // objects retiring behind the frames in flight
     VertexBuffer m_vertexBuf;
     IndexBuffer m_indexBuf;
     UniformBufferSet m_uboSet;
@@ -72,8 +106,14 @@ private:
     Texture m_metalRoughnessTexture;
     Texture m_aoTexture;
     Texture m_emissiveTexture;
+    TextureCooker m_textureCooker;
+    SamplerCache m_samplerCache;  // every 2D texture sampler, shared by unique state
+    MipGenerator m_mipGenerator;  // compute mip chains for uploaded textures; blits when unsupported
 	Cubemap m_cubemap;
+    EnvironmentLighting m_environmentLighting;  // split-sum IBL baked from m_cubemap
     bool m_framebufferResized = false;
+    bool m_presentedSinceRecreate = false;   // an image of the current swapchain was presented; see retireOld()
+    uint32_t m_framesInFlight = 2;   // from AppSettings; every per-frame resource has this many copies
     uint32_t m_currentFrame = 0;
 
     VkSampleCountFlagBits m_msaaSamples = VK_SAMPLE_COUNT_1_BIT;
@@ -82,12 +122,58 @@ private:
     std::vector<uint32_t> m_indices;
 
     // ---- glTF Rendering System ----
-    GltfModel m_gltfModel;
+    JobSystem m_jobs;   // loading and per-frame CPU work; declared first so it outlives the models
+
+    // A model in the scene with the pipelines built for its material
+    // variants and its set 1 (transforms + materials) per frame in flight
+    struct GltfSceneModel {
+        std::unique_ptr<GltfModel> model;
+        std::vector<VkPipeline> pipelines;  // one per GltfModel material variant
+        // Main pass after a depth pre-pass: opaque variants test EQUAL without
+        // writing depth, mask variants test LESS_OR_EQUAL, blend entries alias
+        // pipelines
+        std::vector<VkPipeline> prepassPipelines;
+        // Blend variants drawn into the OIT targets (VK_NULL_HANDLE for the others)
+        std::vector<VkPipeline> oitPipelines;
+        std::vector<VkDescriptorSet> modelSets;
+    };
+    std::vector<GltfSceneModel> m_gltfModels;  // the startup model, then runtime loads in order
+
+    // One secondary command buffer of the scene subpass: a slice of one
+    // model's sorted draw list in one of the subpass's passes
+    struct DrawSlice {
+        enum Pass { DEPTH_PREPASS, MAIN, SORTED_BLEND } pass;
+        const GltfSceneModel* sceneModel;
+        size_t firstEntry;
+        size_t lastEntry;
+        bool timerBegin;   // the first and last sorted blend slices bracket the GPU timer scope
+        bool timerEnd;
+    };
+    std::vector<DrawSlice> m_drawSlices;       // this frame's, rebuilt every frame
+    ModelLoader m_modelLoader;                 // runtime loads: parsed in the background, uploaded on budget
+    UploadScheduler m_uploadScheduler;         // per-frame upload budget for streaming and runtime loads
+    size_t m_nextRuntimeModel = 0;             // next of AppSettings::runtimeModelPaths for L
+    bool m_unloadRequested = false;            // U: drop the most recently added model
+    std::chrono::steady_clock::time_point m_lastFrameStart;
     GltfDescriptorSetLayouts m_gltfDescriptorLayouts;
     GltfDescriptorPool m_gltfDescriptorPool;
     GltfDescriptorSets m_gltfDescriptorSets;
     PipelineLayoutRAII m_gltfPipelineLayout;
-    VkPipeline m_gltfPipeline = VK_NULL_HANDLE;
+    GltfModel::DepthPipelines m_gltfDepthPipelines{};  // shared by every model
+    bool m_depthPrepass = false;  // toggled with P
+    PipelineStatistics m_pipelineStats;
+    WeightedOit m_weightedOit;
+    bool m_oitTransparency = false;  // toggled with O; sorted blending otherwise
+    GpuTimer m_gpuTimer;
+    BindlessTextureHeap m_textureHeap;  // set 2: every glTF texture, shared by all models
+    TextureFeedback m_textureFeedback;
+    std::vector<uint32_t> m_textureFeedbackData;
+
+    // ---- Load Timing ----
+    std::chrono::steady_clock::time_point m_startTime;
+    bool m_firstFrameReported = false;
+    bool m_fullQualityReported = false;
+    bool m_recordingBenchmarked = false;
 
     // ---- Lifecycle ----
     void initWindow();
@@ -96,6 +182,11 @@ private:
     void cleanup();
 
     void drawFrame();
+    void setViewportAndScissor(VkCommandBuffer cmd) const;
+    void recordSceneInline(VkCommandBuffer cmd, bool depthPrepass, bool sortedBlend);
+    void recordSceneSecondaries(VkCommandBuffer cmd, VkFramebuffer framebuffer, bool depthPrepass, bool sortedBlend);
+    void benchmarkRecording();
+    void recreateSwapchain();
 
     // ---- Debug Utils destruction helper (for direct calls within the class) ----
     static void destroyDebugUtilsMessengerEXT(VkInstance instance,
@@ -112,14 +203,25 @@ private:
     // ---- glTF Initialization ----
     void initGltf();
     void loadGltfModel();
-    void createGltfPipeline();
+    void createGltfPipelines(GltfSceneModel& sceneModel);
     void updateGltfDescriptors();
+    void updateGltfModelDescriptors(const GltfSceneModel& sceneModel);
+    void updateGltfStreaming();
+    UploadFrame uploadFrame();
+    bool gltfTextureFeedback() const;
+
+    // ---- Runtime Model Loading ----
+    void addGltfModel(std::unique_ptr<GltfModel> model);
+    void unloadGltfModel(size_t index);
+    void updateModelLoading();
+    void bindGltfDescriptorSets(VkCommandBuffer cmd, const GltfSceneModel& sceneModel) const;
+    void reportLoadTimings();
 
     // ---- Model & Texture Loading ----
     void loadModel();
     void loadCubemap();
     void computeTangents();
-    Texture loadTexture(const std::string& path, VkFormat format = VK_FORMAT_R8G8B8A8_SRGB,
+    Texture loadTexture(const std::string& path, TextureUsageFlags usage = TEXTURE_USAGE_BASE_COLOR,
                         VkFilter filter = VK_FILTER_LINEAR,
                         VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT);
 
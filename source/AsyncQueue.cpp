@@ -0,0 +1,210 @@
+// ============================================================================
+// AsyncQueue.cpp - Transfer / compute submissions with queue family handoffs
+// ============================================================================
+
+#include "AsyncQueue.h"
+#include "DeletionQueue.h"
+#include "Device.h"
+#include "SyncObjects.h"
+#include "Utilities.h"
+#include <cstdint>
+#include <stdexcept>
+
+// ============================================================================
+// Creation
+// ============================================================================
+
+void AsyncQueue::create(const Device& device, uint32_t family, VkQueue queue, VkCommandPool graphicsPool,
+                        SyncObjects& sync, DeletionQueue& deletionQueue) {
+    m_family = family;
+    m_queue = queue;
+    m_graphicsPool = graphicsPool;
+    m_graphicsQueue = device.graphicsQ();
+    m_graphicsFamily = device.graphicsFamily();
+    m_dedicated = family != m_graphicsFamily;
+    m_sync = &sync;
+    m_deletionQueue = &deletionQueue;
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = family;
+    if (vkCreateCommandPool(device.get(), &poolInfo, nullptr, &m_pool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create async queue command pool");
+    }
+}
+
+void AsyncQueue::destroy(const Device& device) {
+    if (m_pool == VK_NULL_HANDLE) return;
+
+    // The deletion queue has run by now, so every semaphore is back
+    for (VkSemaphore semaphore : m_freeSemaphores) {
+        vkDestroySemaphore(device.get(), semaphore, nullptr);
+    }
+    m_freeSemaphores.clear();
+
+    vkDestroyCommandPool(device.get(), m_pool, nullptr);
+    m_pool = VK_NULL_HANDLE;
+}
+
+// ============================================================================
+// Submission
+// ============================================================================
+
+VkCommandBuffer AsyncQueue::begin(const Device& device) {
+    return beginSingleTimeCommands(device, m_pool);
+}
+
+uint64_t AsyncQueue::submit(const Device& device, VkCommandBuffer cmd,
+                            const std::vector<ImageHandoff>& images,
+                            const std::vector<BufferHandoff>& buffers) {
+    // Same family: the whole transition here. Otherwise this is the release
+    // half; the acquire repeats the layouts and carries the destination access.
+    const uint32_t srcFamily = m_dedicated ? m_family : VK_QUEUE_FAMILY_IGNORED;
+    const uint32_t dstFamily = m_dedicated ? m_graphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+    VkPipelineStageFlags srcStages = 0;
+    VkPipelineStageFlags dstStages = 0;
+
+    std::vector<VkImageMemoryBarrier> imageBarriers;
+    for (const ImageHandoff& handoff : images) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = handoff.srcAccess;
+        barrier.dstAccessMask = handoff.dstAccess;
+        barrier.oldLayout = handoff.oldLayout;
+        barrier.newLayout = handoff.newLayout;
+        barrier.srcQueueFamilyIndex = srcFamily;
+        barrier.dstQueueFamilyIndex = dstFamily;
+        barrier.image = handoff.image;
+        barrier.subresourceRange = handoff.range;
+        imageBarriers.push_back(barrier);
+        srcStages |= handoff.srcStage;
+        dstStages |= handoff.dstStage;
+    }
+
+    std::vector<VkBufferMemoryBarrier> bufferBarriers;
+    for (const BufferHandoff& handoff : buffers) {
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = handoff.srcAccess;
+        barrier.dstAccessMask = handoff.dstAccess;
+        barrier.srcQueueFamilyIndex = srcFamily;
+        barrier.dstQueueFamilyIndex = dstFamily;
+        barrier.buffer = handoff.buffer;
+        barrier.offset = handoff.offset;
+        barrier.size = handoff.size;
+        bufferBarriers.push_back(barrier);
+        srcStages |= handoff.srcStage;
+        dstStages |= handoff.dstStage;
+    }
+
+    const bool handoffs = !imageBarriers.empty() || !bufferBarriers.empty();
+    if (handoffs) {
+        VkPipelineStageFlags barrierDstStages = dstStages;
+        if (m_dedicated) {
+            // Release: the destination half belongs to the acquire
+            for (auto& barrier : imageBarriers) barrier.dstAccessMask = 0;
+            for (auto& barrier : bufferBarriers) barrier.dstAccessMask = 0;
+            barrierDstStages = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+        }
+        vkCmdPipelineBarrier(cmd, srcStages, barrierDstStages, 0,
+                             0, nullptr,
+                             static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+                             static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+    }
+    vkEndCommandBuffer(cmd);
+
+    // Every signal of the frame timeline happens on the graphics queue, in
+    // the order its values are taken
+    const uint64_t value = m_sync->nextSubmitValue();
+    VkSemaphore timeline = m_sync->timeline();
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &value;
+
+    VkDevice handle = device.get();
+    if (!m_dedicated) {
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &cmd;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &timeline;
+        if (vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to submit async queue work");
+        }
+        m_deletionQueue->push(value, [handle, pool = m_pool, cmd]() {
+            vkFreeCommandBuffers(handle, pool, 1, &cmd);
+        });
+        return value;
+    }
+
+    VkSemaphore semaphore = VK_NULL_HANDLE;
+    if (!m_freeSemaphores.empty()) {
+        semaphore = m_freeSemaphores.back();
+        m_freeSemaphores.pop_back();
+    } else {
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        if (vkCreateSemaphore(handle, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create async queue handoff semaphore");
+        }
+    }
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &semaphore;
+    if (vkQueueSubmit(m_queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to submit async queue work");
+    }
+
+    // Acquire on the graphics queue, ahead of any frame that uses the
+    // resources; with nothing to acquire the batch only carries the signal
+    VkCommandBuffer acquire = VK_NULL_HANDLE;
+    if (handoffs) {
+        acquire = beginSingleTimeCommands(device, m_graphicsPool);
+        for (size_t i = 0; i < images.size(); ++i) {
+            imageBarriers[i].srcAccessMask = 0;
+            imageBarriers[i].dstAccessMask = images[i].dstAccess;
+        }
+        for (size_t i = 0; i < buffers.size(); ++i) {
+            bufferBarriers[i].srcAccessMask = 0;
+            bufferBarriers[i].dstAccessMask = buffers[i].dstAccess;
+        }
+        vkCmdPipelineBarrier(acquire, dstStages, dstStages, 0,
+                             0, nullptr,
+                             static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+                             static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+        vkEndCommandBuffer(acquire);
+    } else {
+        dstStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
+
+    VkSubmitInfo acquireInfo{};
+    acquireInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    acquireInfo.pNext = &timelineInfo;
+    acquireInfo.waitSemaphoreCount = 1;
+    acquireInfo.pWaitSemaphores = &semaphore;
+    acquireInfo.pWaitDstStageMask = &dstStages;
+    acquireInfo.commandBufferCount = handoffs ? 1 : 0;
+    acquireInfo.pCommandBuffers = &acquire;
+    acquireInfo.signalSemaphoreCount = 1;
+    acquireInfo.pSignalSemaphores = &timeline;
+    if (vkQueueSubmit(m_graphicsQueue, 1, &acquireInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to submit queue ownership acquire");
+    }
+
+    m_deletionQueue->push(value, [this, handle, cmd, acquire, semaphore]() {
+        vkFreeCommandBuffers(handle, m_pool, 1, &cmd);
+        if (acquire != VK_NULL_HANDLE) {
+            vkFreeCommandBuffers(handle, m_graphicsPool, 1, &acquire);
+        }
+        m_freeSemaphores.push_back(semaphore);
+    });
+    return value;
+}
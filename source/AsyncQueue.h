@@ -0,0 +1,88 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+class DeletionQueue;
+class Device;
+class SyncObjects;
+
+// ============================================================================
+// Async Queue
+// One-off GPU work (uploads, compute) on a dedicated transfer or compute
+// queue family, so it overlaps the frames in flight on the graphics queue.
+// The resources the work writes are released to the graphics family at the
+// end of its command buffer and acquired by a small graphics submission that
+// waits on a semaphore. Without a dedicated family the work runs on the
+// graphics queue and every handoff is an ordinary barrier.
+//
+// The CPU never waits. Each submission ends in a graphics-queue batch that
+// signals the frame timeline with a value of its own, so completion is
+// tracked like any frame and the command buffers, and whatever the caller
+// retires at the returned value, are freed through the frame deletion queue.
+// ============================================================================
+
+// Image range written by the async work, and how graphics will read it
+struct ImageHandoff {
+    VkImage image = VK_NULL_HANDLE;
+    VkImageSubresourceRange range{ VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+    VkImageLayout oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;     // as the work left it
+    VkImageLayout newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    VkPipelineStageFlags srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    VkAccessFlags srcAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
+    VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    VkAccessFlags dstAccess = VK_ACCESS_SHADER_READ_BIT;
+};
+
+// Buffer range written by the async work, and how graphics will read it
+struct BufferHandoff {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = VK_WHOLE_SIZE;
+    VkPipelineStageFlags srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    VkAccessFlags srcAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
+    VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+    VkAccessFlags dstAccess = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+};
+
+class AsyncQueue {
+public:
+    // `family` and `queue` come from Device (transferQ/computeQ and their
+    // families); acquires are recorded from `graphicsPool`. Submissions take
+    // values on `sync`'s timeline and retire through `deletionQueue`, which
+    // must be flushed before destroy().
+    void create(const Device& device, uint32_t family, VkQueue queue, VkCommandPool graphicsPool,
+                SyncObjects& sync, DeletionQueue& deletionQueue);
+    void destroy(const Device& device);
+
+    bool dedicated() const { return m_dedicated; }
+    uint32_t family() const { return m_family; }
+
+    // Where callers retire what the work reads (staging, views) at the value
+    // submit() returned
+    DeletionQueue& deletionQueue() { return *m_deletionQueue; }
+
+    // Command buffer for this queue's family, recording started
+    VkCommandBuffer begin(const Device& device);
+
+    // End and submit `cmd` and hand the listed resources to the graphics
+    // family, without waiting. Graphics work submitted afterwards sees them
+    // in their new layout and access state. Returns the frame timeline value
+    // at which the work, and the handoff, have completed.
+    uint64_t submit(const Device& device, VkCommandBuffer cmd,
+                    const std::vector<ImageHandoff>& images,
+                    const std::vector<BufferHandoff>& buffers = {});
+
+private:
+    VkCommandPool m_pool = VK_NULL_HANDLE;
+    VkQueue m_queue = VK_NULL_HANDLE;
+    uint32_t m_family = 0;
+    bool m_dedicated = false;
+
+    VkCommandPool m_graphicsPool = VK_NULL_HANDLE;
+    VkQueue m_graphicsQueue = VK_NULL_HANDLE;
+    uint32_t m_graphicsFamily = 0;
+    SyncObjects* m_sync = nullptr;
+    DeletionQueue* m_deletionQueue = nullptr;
+    std::vector<VkSemaphore> m_freeSemaphores;          // dedicated -> graphics signals to reuse
+};
@@ -0,0 +1,233 @@
+// ============================================================================
+// BindlessTextureHeap.cpp - Global descriptor-indexed texture array
+// ============================================================================
+
+#include "BindlessTextureHeap.h"
+#include "Device.h"
+#include "Texture.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// ============================================================================
+// Creation
+// ============================================================================
+
+void BindlessTextureHeap::create(const Device& device, uint32_t framesInFlight, uint32_t capacity) {
+    VkPhysicalDeviceVulkan12Properties properties12{};
+    properties12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties2{};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &properties12;
+    vkGetPhysicalDeviceProperties2(device.physical(), &properties2);
+
+    m_capacity = std::min({ capacity,
+                            1u << kSamplerShift,
+                            properties12.maxDescriptorSetUpdateAfterBindSampledImages,
+                            properties12.maxPerStageDescriptorUpdateAfterBindSampledImages });
+
+    // Set 2, Binding 0: Sampler array (one entry per unique sampler state)
+    VkDescriptorSetLayoutBinding samplerBinding{};
+    samplerBinding.binding = 0;
+    samplerBinding.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+    samplerBinding.descriptorCount = kMaxSamplers;
+    samplerBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    samplerBinding.pImmutableSamplers = nullptr;
+
+    // Set 2, Binding 1: Variable-count array of sampled images (must be last)
+    VkDescriptorSetLayoutBinding imageBinding{};
+    imageBinding.binding = 1;
+    imageBinding.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    imageBinding.descriptorCount = m_capacity;
+    imageBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    imageBinding.pImmutableSamplers = nullptr;
+
+    VkDescriptorSetLayoutBinding bindings[] = { samplerBinding, imageBinding };
+
+    const VkDescriptorBindingFlags sharedFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                                                 VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                                 VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+    VkDescriptorBindingFlags bindingFlags[] = {
+        sharedFlags,
+        sharedFlags | VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT
+    };
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{};
+    flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    flagsInfo.bindingCount = 2;
+    flagsInfo.pBindingFlags = bindingFlags;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &flagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutInfo.bindingCount = 2;
+    layoutInfo.pBindings = bindings;
+
+    if (vkCreateDescriptorSetLayout(device.get(), &layoutInfo, nullptr, &m_layout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create bindless texture descriptor set layout");
+    }
+
+    VkDescriptorPoolSize poolSizes[2];
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_SAMPLER;
+    poolSizes[0].descriptorCount = kMaxSamplers * framesInFlight;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    poolSizes[1].descriptorCount = m_capacity * framesInFlight;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.poolSizeCount = 2;
+    poolInfo.pPoolSizes = poolSizes;
+    poolInfo.maxSets = framesInFlight;
+
+    if (vkCreateDescriptorPool(device.get(), &poolInfo, nullptr, &m_pool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create bindless texture descriptor pool");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(framesInFlight, m_layout);
+    std::vector<uint32_t> counts(framesInFlight, m_capacity);
+    VkDescriptorSetVariableDescriptorCountAllocateInfo countInfo{};
+    countInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
+    countInfo.descriptorSetCount = framesInFlight;
+    countInfo.pDescriptorCounts = counts.data();
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.pNext = &countInfo;
+    allocInfo.descriptorPool = m_pool;
+    allocInfo.descriptorSetCount = framesInFlight;
+    allocInfo.pSetLayouts = layouts.data();
+
+    m_sets.resize(framesInFlight);
+    if (vkAllocateDescriptorSets(device.get(), &allocInfo, m_sets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate bindless texture descriptor sets");
+    }
+
+    m_pendingWrites.assign(framesInFlight, {});
+    m_nextSlot = 0;
+    m_slotsInUse = 0;
+    m_freeSlots.clear();
+    m_retiringSlots.clear();
+    m_samplerSlots.clear();
+
+    std::cout << "Bindless texture heap: " << m_capacity << " image slots, " << kMaxSamplers
+              << " sampler slots x " << framesInFlight << " frames" << std::endl;
+}
+
+void BindlessTextureHeap::destroy(const Device& device) {
+    if (m_pool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(device.get(), m_pool, nullptr);
+        m_pool = VK_NULL_HANDLE;
+    }
+    if (m_layout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(device.get(), m_layout, nullptr);
+        m_layout = VK_NULL_HANDLE;
+    }
+    m_sets.clear();
+    m_pendingWrites.clear();
+    m_freeSlots.clear();
+    m_retiringSlots.clear();
+    m_samplerSlots.clear();
+    m_capacity = 0;
+}
+
+// ============================================================================
+// Slot Management
+// ============================================================================
+
+VkDescriptorImageInfo BindlessTextureHeap::imageInfo(const Texture& texture) {
+    VkDescriptorImageInfo info{};
+    info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    info.imageView = texture.view();
+    info.sampler = VK_NULL_HANDLE;   // samplers are bound separately (binding 0)
+    return info;
+}
+
+void BindlessTextureHeap::write(const Device& device, VkDescriptorSet set, uint32_t binding, uint32_t slot,
+                                VkDescriptorType type, const VkDescriptorImageInfo& info) const {
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = set;
+    write.dstBinding = binding;
+    write.dstArrayElement = slot;
+    write.descriptorType = type;
+    write.descriptorCount = 1;
+    write.pImageInfo = &info;
+    vkUpdateDescriptorSets(device.get(), 1, &write, 0, nullptr);
+}
+
+uint32_t BindlessTextureHeap::add(const Device& device, const Texture& texture) {
+    uint32_t slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else if (m_nextSlot < m_capacity) {
+        slot = m_nextSlot++;
+    } else {
+        throw std::runtime_error("Bindless texture heap is full (" + std::to_string(m_capacity) + " slots)");
+    }
+
+    // No pending command buffer reads this slot, so every frame's copy can be written now
+    VkDescriptorImageInfo info = imageInfo(texture);
+    for (size_t frame = 0; frame < m_sets.size(); ++frame) {
+        write(device, m_sets[frame], 1, slot, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, info);
+        m_pendingWrites[frame].erase(slot);
+    }
+    m_slotsInUse++;
+    return slot;
+}
+
+uint32_t BindlessTextureHeap::samplerSlot(const Device& device, VkSampler sampler) {
+    auto it = m_samplerSlots.find(sampler);
+    if (it != m_samplerSlots.end()) {
+        return it->second;
+    }
+    if (m_samplerSlots.size() >= kMaxSamplers) {
+        throw std::runtime_error("Bindless texture heap is out of sampler slots (" +
+                                 std::to_string(kMaxSamplers) + ")");
+    }
+
+    // Like add(): a new slot is not referenced by any pending command buffer
+    uint32_t slot = static_cast<uint32_t>(m_samplerSlots.size());
+    VkDescriptorImageInfo info{};
+    info.sampler = sampler;
+    for (VkDescriptorSet set : m_sets) {
+        write(device, set, 0, slot, VK_DESCRIPTOR_TYPE_SAMPLER, info);
+    }
+    m_samplerSlots.emplace(sampler, slot);
+    return slot;
+}
+
+void BindlessTextureHeap::replace(uint32_t slot, const Texture& texture) {
+    VkDescriptorImageInfo info = imageInfo(texture);
+    for (auto& pending : m_pendingWrites) {
+        pending[slot] = info;
+    }
+}
+
+void BindlessTextureHeap::remove(uint32_t slot) {
+    if (slot == kInvalidSlot) return;
+    for (auto& pending : m_pendingWrites) {
+        pending.erase(slot);
+    }
+    m_retiringSlots.push_back({ slot, static_cast<uint32_t>(m_sets.size()) });
+    m_slotsInUse--;
+}
+
+void BindlessTextureHeap::beginFrame(const Device& device, uint32_t frame) {
+    for (const auto& [slot, info] : m_pendingWrites[frame]) {
+        write(device, m_sets[frame], 1, slot, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, info);
+    }
+    m_pendingWrites[frame].clear();
+
+    // After one beginFrame per frame in flight, no recorded frame can reference the slot
+    for (auto it = m_retiringSlots.begin(); it != m_retiringSlots.end();) {
+        if (--it->framesLeft == 0) {
+            m_freeSlots.push_back(it->slot);
+            it = m_retiringSlots.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
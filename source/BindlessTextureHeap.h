@@ -0,0 +1,82 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class Device;
+class Texture;
+
+// ============================================================================
+// Bindless Texture Heap
+// Set 2, shared by every model: binding 0 is a small array of samplers,
+// binding 1 a global, variable-count array of sampled images. Images and
+// samplers get stable slots on registration; materials refer to a texture by
+// a handle packing both (see handle()), so one sampler per unique state
+// serves any number of images.
+//
+// Each frame in flight has its own copy of the set, all with the same slot
+// numbering. Writing a fresh slot is immediate (update-unused-while-pending);
+// replacing a slot that in-flight frames may read is applied to each frame's
+// copy in beginFrame(), after that frame's timeline wait.
+// ============================================================================
+
+class BindlessTextureHeap {
+public:
+    static constexpr uint32_t kInvalidSlot = 0xFFFFFFFFu;
+    static constexpr uint32_t kMaxSamplers = 64;      // must match MAX_SAMPLERS in gltf.frag
+    static constexpr uint32_t kSamplerShift = 16;     // image slot bits in a texture handle
+
+    // Shader-side texture handle: image slot in the low bits, sampler slot above
+    static int32_t handle(uint32_t imageSlot, uint32_t samplerSlot) {
+        return static_cast<int32_t>((samplerSlot << kSamplerShift) | imageSlot);
+    }
+
+    // Capacity is clamped to the device's update-after-bind limits and to
+    // what fits in a handle's image bits
+    void create(const Device& device, uint32_t framesInFlight, uint32_t capacity = 4096);
+    void destroy(const Device& device);
+
+    // Register a texture's image in a free slot (written to every frame's set now)
+    uint32_t add(const Device& device, const Texture& texture);
+
+    // Slot of a sampler, registering it on first use. Samplers are expected
+    // to come from SamplerCache and stay registered until destroy().
+    uint32_t samplerSlot(const Device& device, VkSampler sampler);
+
+    // Point an existing slot at a new texture from each frame's next beginFrame()
+    void replace(uint32_t slot, const Texture& texture);
+
+    // Free a slot; it is handed out again once no frame can still read it
+    void remove(uint32_t slot);
+
+    // Call once per frame after the frame's timeline wait, before recording
+    void beginFrame(const Device& device, uint32_t frame);
+
+    VkDescriptorSetLayout layout() const { return m_layout; }
+    VkDescriptorSet set(uint32_t frame) const { return m_sets[frame]; }
+    uint32_t capacity() const { return m_capacity; }
+    uint32_t slotsInUse() const { return m_slotsInUse; }
+
+private:
+    struct RetiringSlot {
+        uint32_t slot;
+        uint32_t framesLeft;
+    };
+
+    static VkDescriptorImageInfo imageInfo(const Texture& texture);
+    void write(const Device& device, VkDescriptorSet set, uint32_t binding, uint32_t slot,
+               VkDescriptorType type, const VkDescriptorImageInfo& info) const;
+
+    VkDescriptorSetLayout m_layout = VK_NULL_HANDLE;
+    VkDescriptorPool m_pool = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> m_sets;
+    uint32_t m_capacity = 0;
+
+    uint32_t m_nextSlot = 0;             // slots below this have been handed out before
+    uint32_t m_slotsInUse = 0;
+    std::vector<uint32_t> m_freeSlots;
+    std::vector<RetiringSlot> m_retiringSlots;
+    std::vector<std::unordered_map<uint32_t, VkDescriptorImageInfo>> m_pendingWrites;  // per frame
+    std::unordered_map<VkSampler, uint32_t> m_samplerSlots;
+};
@@ -0,0 +1,369 @@
+// ============================================================================
+// BlockCompression.cpp - BC1/BC3/BC4/BC5 block encoders
+// Principal-axis endpoint fit with one least-squares refinement pass for
+// color blocks, min/max endpoints for single-channel blocks. The per-texel
+// projection loops have an SSE2 path; everything else is plain scalar code.
+// ============================================================================
+
+#include "BlockCompression.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KASCADE_BC_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace bc {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace {
+
+// Projection bucket -> BC1 index (palette order is c0, c1, 2/3c0+1/3c1, 1/3c0+2/3c1)
+constexpr uint8_t kBC1IndexFromBucket[4] = { 0, 2, 3, 1 };
+
+inline uint16_t packRGB565(float r, float g, float b) {
+    auto q = [](float v, int maxValue) {
+        int i = static_cast<int>(v * maxValue / 255.0f + 0.5f);
+        return std::clamp(i, 0, maxValue);
+    };
+    return static_cast<uint16_t>((q(r, 31) << 11) | (q(g, 63) << 5) | q(b, 31));
+}
+
+inline void unpackRGB565(uint16_t c, float out[3]) {
+    uint32_t r = (c >> 11) & 31;
+    uint32_t g = (c >> 5) & 63;
+    uint32_t b = c & 31;
+    out[0] = static_cast<float>((r << 3) | (r >> 2));
+    out[1] = static_cast<float>((g << 2) | (g >> 4));
+    out[2] = static_cast<float>((b << 3) | (b >> 2));
+}
+
+struct ColorBlock {
+    alignas(16) float r[16];
+    alignas(16) float g[16];
+    alignas(16) float b[16];
+};
+
+// Map every texel onto the segment p0->p1 and quantize to one of 4 buckets
+void projectToBuckets(const ColorBlock& blk, const float p0[3], const float p1[3], int buckets[16]) {
+    float d[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+    float len2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+    if (len2 < 1e-6f) {
+        for (int i = 0; i < 16; ++i) buckets[i] = 0;
+        return;
+    }
+    float s = 3.0f / len2;
+    d[0] *= s; d[1] *= s; d[2] *= s;
+    float base = p0[0] * d[0] + p0[1] * d[1] + p0[2] * d[2];
+
+#ifdef KASCADE_BC_SSE2
+    const __m128 dr = _mm_set1_ps(d[0]);
+    const __m128 dg = _mm_set1_ps(d[1]);
+    const __m128 db = _mm_set1_ps(d[2]);
+    const __m128 vb = _mm_set1_ps(base);
+    const __m128 lo = _mm_setzero_ps();
+    const __m128 hi = _mm_set1_ps(3.0f);
+    for (int i = 0; i < 16; i += 4) {
+        __m128 t = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_load_ps(blk.r + i), dr),
+                                         _mm_mul_ps(_mm_load_ps(blk.g + i), dg)),
+                              _mm_mul_ps(_mm_load_ps(blk.b + i), db));
+        t = _mm_min_ps(_mm_max_ps(_mm_sub_ps(t, vb), lo), hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(buckets + i), _mm_cvtps_epi32(t));
+    }
+#else
+    for (int i = 0; i < 16; ++i) {
+        float t = blk.r[i] * d[0] + blk.g[i] * d[1] + blk.b[i] * d[2] - base;
+        buckets[i] = static_cast<int>(std::clamp(t, 0.0f, 3.0f) + 0.5f);
+    }
+#endif
+}
+
+float blockError(const ColorBlock& blk, const float p0[3], const float p1[3], const int buckets[16]) {
+    float err = 0.0f;
+    for (int i = 0; i < 16; ++i) {
+        float w = buckets[i] / 3.0f;
+        float dr = p0[0] + (p1[0] - p0[0]) * w - blk.r[i];
+        float dg = p0[1] + (p1[1] - p0[1]) * w - blk.g[i];
+        float db = p0[2] + (p1[2] - p0[2]) * w - blk.b[i];
+        err += dr * dr + dg * dg + db * db;
+    }
+    return err;
+}
+
+// Least-squares endpoints for fixed bucket assignments
+bool refineEndpoints(const ColorBlock& blk, const int buckets[16], float outA[3], float outB[3]) {
+    float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+    float ax[3] = {}, bx[3] = {};
+    for (int i = 0; i < 16; ++i) {
+        float beta = buckets[i] / 3.0f;
+        float alpha = 1.0f - beta;
+        aa += alpha * alpha;
+        bb += beta * beta;
+        ab += alpha * beta;
+        ax[0] += alpha * blk.r[i]; ax[1] += alpha * blk.g[i]; ax[2] += alpha * blk.b[i];
+        bx[0] += beta * blk.r[i];  bx[1] += beta * blk.g[i];  bx[2] += beta * blk.b[i];
+    }
+    float det = aa * bb - ab * ab;
+    if (std::fabs(det) < 1e-6f) return false;
+    float inv = 1.0f / det;
+    for (int c = 0; c < 3; ++c) {
+        outA[c] = std::clamp((ax[c] * bb - bx[c] * ab) * inv, 0.0f, 255.0f);
+        outB[c] = std::clamp((bx[c] * aa - ax[c] * ab) * inv, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+struct EncodedColor {
+    uint16_t c0 = 0;
+    uint16_t c1 = 0;
+    int buckets[16] = {};
+    float error = 0.0f;
+};
+
+// Quantize endpoints, force 4-color ordering (c0 > c1) and pick indices
+EncodedColor quantizeAndAssign(const ColorBlock& blk, const float a[3], const float b[3]) {
+    EncodedColor enc;
+    enc.c0 = packRGB565(a[0], a[1], a[2]);
+    enc.c1 = packRGB565(b[0], b[1], b[2]);
+    if (enc.c0 < enc.c1) std::swap(enc.c0, enc.c1);
+
+    float p0[3], p1[3];
+    unpackRGB565(enc.c0, p0);
+    unpackRGB565(enc.c1, p1);
+    if (enc.c0 == enc.c1) {
+        for (int i = 0; i < 16; ++i) enc.buckets[i] = 0;
+    } else {
+        projectToBuckets(blk, p0, p1, enc.buckets);
+    }
+    enc.error = blockError(blk, p0, p1, enc.buckets);
+    return enc;
+}
+
+void writeColorBlock(const EncodedColor& enc, uint8_t out[8]) {
+    out[0] = static_cast<uint8_t>(enc.c0 & 0xFF);
+    out[1] = static_cast<uint8_t>(enc.c0 >> 8);
+    out[2] = static_cast<uint8_t>(enc.c1 & 0xFF);
+    out[3] = static_cast<uint8_t>(enc.c1 >> 8);
+    uint32_t indices = 0;
+    if (enc.c0 != enc.c1) {
+        for (int i = 0; i < 16; ++i) {
+            indices |= static_cast<uint32_t>(kBC1IndexFromBucket[enc.buckets[i]]) << (2 * i);
+        }
+    }
+    out[4] = static_cast<uint8_t>(indices & 0xFF);
+    out[5] = static_cast<uint8_t>((indices >> 8) & 0xFF);
+    out[6] = static_cast<uint8_t>((indices >> 16) & 0xFF);
+    out[7] = static_cast<uint8_t>(indices >> 24);
+}
+
+void encodeColor(const uint8_t texels[64], uint8_t out[8]) {
+    ColorBlock blk;
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 16; ++i) {
+        blk.r[i] = texels[i * 4 + 0];
+        blk.g[i] = texels[i * 4 + 1];
+        blk.b[i] = texels[i * 4 + 2];
+        mean[0] += blk.r[i]; mean[1] += blk.g[i]; mean[2] += blk.b[i];
+    }
+    mean[0] /= 16.0f; mean[1] /= 16.0f; mean[2] /= 16.0f;
+
+    // Covariance matrix (symmetric, 6 unique entries)
+    float cov[6] = {};
+    for (int i = 0; i < 16; ++i) {
+        float r = blk.r[i] - mean[0];
+        float g = blk.g[i] - mean[1];
+        float b = blk.b[i] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    // Principal axis by power iteration
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    for (int iter = 0; iter < 4; ++iter) {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float m = std::max(std::fabs(x), std::max(std::fabs(y), std::fabs(z)));
+        if (m < 1e-6f) break;
+        axis[0] = x / m; axis[1] = y / m; axis[2] = z / m;
+    }
+    float axisLen2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+
+    float minT = 0.0f, maxT = 0.0f;
+    if (axisLen2 > 1e-6f) {
+        minT = maxT = (blk.r[0] - mean[0]) * axis[0] + (blk.g[0] - mean[1]) * axis[1] + (blk.b[0] - mean[2]) * axis[2];
+        for (int i = 1; i < 16; ++i) {
+            float t = (blk.r[i] - mean[0]) * axis[0] + (blk.g[i] - mean[1]) * axis[1] + (blk.b[i] - mean[2]) * axis[2];
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+        minT /= axisLen2;
+        maxT /= axisLen2;
+    }
+
+    float a[3], b[3];
+    for (int c = 0; c < 3; ++c) {
+        a[c] = std::clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+        b[c] = std::clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+    }
+
+    EncodedColor best = quantizeAndAssign(blk, a, b);
+    if (best.c0 != best.c1 && best.error > 0.0f) {
+        // Bucket assignment is relative to the (possibly swapped) quantized endpoints
+        float p0[3], p1[3];
+        if (refineEndpoints(blk, best.buckets, p0, p1)) {
+            EncodedColor refined = quantizeAndAssign(blk, p0, p1);
+            if (refined.error < best.error) best = refined;
+        }
+    }
+    writeColorBlock(best, out);
+}
+
+} // namespace
+
+// ============================================================================
+// Single-block Encoders
+// ============================================================================
+
+void encodeBlockBC1(const uint8_t texels[64], uint8_t out[8]) {
+    encodeColor(texels, out);
+}
+
+void encodeBlockBC4(const uint8_t texels[64], uint32_t channel, uint8_t out[8]) {
+    alignas(16) float v[16];
+    float lo = 255.0f, hi = 0.0f;
+    for (int i = 0; i < 16; ++i) {
+        v[i] = texels[i * 4 + channel];
+        lo = std::min(lo, v[i]);
+        hi = std::max(hi, v[i]);
+    }
+
+    // e0 > e1 selects the 8-value interpolation mode
+    out[0] = static_cast<uint8_t>(hi);
+    out[1] = static_cast<uint8_t>(lo);
+
+    int steps[16] = {};
+    if (hi > lo) {
+        float scale = 7.0f / (hi - lo);
+#ifdef KASCADE_BC_SSE2
+        const __m128 vs = _mm_set1_ps(scale);
+        const __m128 vh = _mm_set1_ps(hi);
+        for (int i = 0; i < 16; i += 4) {
+            __m128 t = _mm_mul_ps(_mm_sub_ps(vh, _mm_load_ps(v + i)), vs);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(steps + i), _mm_cvtps_epi32(t));
+        }
+#else
+        for (int i = 0; i < 16; ++i) {
+            steps[i] = static_cast<int>((hi - v[i]) * scale + 0.5f);
+        }
+#endif
+    }
+
+    // Step 0 = e0 (index 0), step 7 = e1 (index 1), steps 1..6 = indices 2..7
+    uint64_t bits = 0;
+    for (int i = 0; i < 16; ++i) {
+        int s = std::clamp(steps[i], 0, 7);
+        uint64_t index = (s == 0) ? 0u : (s == 7) ? 1u : static_cast<uint64_t>(s + 1);
+        bits |= index << (3 * i);
+    }
+    for (int i = 0; i < 6; ++i) {
+        out[2 + i] = static_cast<uint8_t>((bits >> (8 * i)) & 0xFF);
+    }
+}
+
+void encodeBlockBC3(const uint8_t texels[64], uint8_t out[16]) {
+    encodeBlockBC4(texels, 3, out);
+    encodeColor(texels, out + 8);
+}
+
+void encodeBlockBC5(const uint8_t texels[64], uint8_t out[16]) {
+    encodeBlockBC4(texels, 0, out);
+    encodeBlockBC4(texels, 1, out + 8);
+}
+
+// ============================================================================
+// Image Compression
+// ============================================================================
+
+uint32_t blockBytes(Format format) {
+    switch (format) {
+        case Format::BC1:
+        case Format::BC4: return 8;
+        case Format::BC3:
+        case Format::BC5: return 16;
+    }
+    return 16;
+}
+
+size_t compressedSize(Format format, uint32_t width, uint32_t height) {
+    size_t blocksX = (width + 3) / 4;
+    size_t blocksY = (height + 3) / 4;
+    return blocksX * blocksY * blockBytes(format);
+}
+
+void compressImage(Format format,
+                   const uint8_t* rgba,
+                   uint32_t width,
+                   uint32_t height,
+                   uint8_t* outBlocks,
+                   uint32_t threadCount) {
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    const uint32_t stride = blockBytes(format);
+
+    auto compressRows = [=](uint32_t rowBegin, uint32_t rowEnd) {
+        uint8_t texels[64];
+        for (uint32_t by = rowBegin; by < rowEnd; ++by) {
+            for (uint32_t bx = 0; bx < blocksX; ++bx) {
+                // Gather 4x4 texels, clamping at the right/bottom edge
+                for (uint32_t y = 0; y < 4; ++y) {
+                    uint32_t sy = std::min(by * 4 + y, height - 1);
+                    for (uint32_t x = 0; x < 4; ++x) {
+                        uint32_t sx = std::min(bx * 4 + x, width - 1);
+                        std::memcpy(&texels[(y * 4 + x) * 4], &rgba[(static_cast<size_t>(sy) * width + sx) * 4], 4);
+                    }
+                }
+
+                uint8_t* dst = outBlocks + (static_cast<size_t>(by) * blocksX + bx) * stride;
+                switch (format) {
+                    case Format::BC1: encodeBlockBC1(texels, dst); break;
+                    case Format::BC3: encodeBlockBC3(texels, dst); break;
+                    case Format::BC4: encodeBlockBC4(texels, 0, dst); break;
+                    case Format::BC5: encodeBlockBC5(texels, dst); break;
+                }
+            }
+        }
+    };
+
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // Small images (and the tail of every mip chain) are not worth a thread
+    constexpr uint32_t kMinRowsPerThread = 8;
+    threadCount = std::min(threadCount, std::max(1u, blocksY / kMinRowsPerThread));
+
+    if (threadCount <= 1) {
+        compressRows(0, blocksY);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount - 1);
+    uint32_t rowsPerThread = (blocksY + threadCount - 1) / threadCount;
+    for (uint32_t t = 1; t < threadCount; ++t) {
+        uint32_t begin = std::min(t * rowsPerThread, blocksY);
+        uint32_t end = std::min(begin + rowsPerThread, blocksY);
+        if (begin < end) workers.emplace_back(compressRows, begin, end);
+    }
+    compressRows(0, std::min(rowsPerThread, blocksY));
+    for (auto& worker : workers) worker.join();
+}
+
+} // namespace bc
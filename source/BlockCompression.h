@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// ============================================================================
+// CPU Block Compression (BCn) Encoders
+// Used by the texture cook step to produce GPU-ready BC1/BC3/BC4/BC5 payloads.
+// Input is always tightly packed RGBA8; output blocks are written row-major,
+// ceil(width/4) * ceil(height/4) blocks per image. Edge blocks of images whose
+// size is not a multiple of 4 replicate the last row/column.
+// ============================================================================
+
+namespace bc {
+
+enum class Format {
+    BC1,   // RGB, 8 bytes per block (color textures without alpha, ORM)
+    BC3,   // RGBA, 16 bytes per block (color textures with alpha)
+    BC4,   // R, 8 bytes per block (occlusion)
+    BC5    // RG, 16 bytes per block (tangent-space normals)
+};
+
+// Bytes per 4x4 block for the given format
+uint32_t blockBytes(Format format);
+
+// Total size in bytes of a compressed image
+size_t compressedSize(Format format, uint32_t width, uint32_t height);
+
+// Compress a whole image. Work is split across block rows on up to
+// `threadCount` threads (0 = hardware concurrency).
+void compressImage(Format format,
+                   const uint8_t* rgba,
+                   uint32_t width,
+                   uint32_t height,
+                   uint8_t* outBlocks,
+                   uint32_t threadCount = 0);
+
+// Single-block encoders (16 RGBA8 texels in, one block out)
+void encodeBlockBC1(const uint8_t texels[64], uint8_t out[8]);
+void encodeBlockBC3(const uint8_t texels[64], uint8_t out[16]);
+void encodeBlockBC4(const uint8_t texels[64], uint32_t channel, uint8_t out[8]);
+void encodeBlockBC5(const uint8_t texels[64], uint8_t out[16]);
+
+} // namespace bc
@@ -1,4 +1,6 @@
 ﻿#include "Buffer.h"
+#include "AsyncQueue.h"
+#include "DeletionQueue.h"
 #include "Device.h"
 #include "Utilities.h"
 #include <stdexcept>
@@ -74,6 +76,22 @@ void Buffer::destroy(const Device& device) {
     m_bufferSize = 0;
 }
 
+void Buffer::retire(const Device& device, DeletionQueue& deletionQueue, uint64_t value) {
+    VkDevice handle = device.get();
+    VkBuffer buffer = m_buffer;
+    VkDeviceMemory memory = m_memory;
+    bool mapped = m_mappedPtr != nullptr;
+    deletionQueue.push(value, [handle, buffer, memory, mapped]() {
+        if (mapped) vkUnmapMemory(handle, memory);
+        if (buffer) vkDestroyBuffer(handle, buffer, nullptr);
+        if (memory) vkFreeMemory(handle, memory, nullptr);
+    });
+    m_mappedPtr = nullptr;
+    m_buffer = VK_NULL_HANDLE;
+    m_memory = VK_NULL_HANDLE;
+    m_bufferSize = 0;
+}
+
 void* Buffer::map(const Device& device, VkDeviceSize offset, VkDeviceSize size) {
     if (!m_mappedPtr) {
         if (vkMapMemory(device.get(), m_memory, offset, size, 0, &m_mappedPtr) != VK_SUCCESS) {
@@ -95,11 +113,11 @@ void Buffer::write(const void* src, VkDeviceSize size, VkDeviceSize dstOffset) {
     {
         throw std::runtime_error("Mapped memory is not available!");
     }
-    if (size > m_bufferSize)
+    if (dstOffset > m_bufferSize || size > m_bufferSize - dstOffset)
     {
         throw std::runtime_error("Write bytes exceeded allocated memory size!");
     }
-    std::memcpy(m_mappedPtr, src, (size_t)size);
+    std::memcpy(static_cast<char*>(m_mappedPtr) + dstOffset, src, (size_t)size);
 }
 
 void Buffer::copyBuffer(const Device& device,
@@ -119,3 +137,27 @@ void Buffer::copyBuffer(const Device& device,
 
     endSingleTimeCommands(device, cmd, commandPool, queue);
 }
+
+uint64_t Buffer::copyBuffer(const Device& device,
+    AsyncQueue& uploadQueue,
+    VkBuffer src,
+    VkBuffer dst,
+    VkDeviceSize size,
+    VkPipelineStageFlags dstStage,
+    VkAccessFlags dstAccess)
+{
+    VkCommandBuffer cmd = uploadQueue.begin(device);
+
+    VkBufferCopy region{};
+    region.srcOffset = 0;
+    region.dstOffset = 0;
+    region.size = size;
+    vkCmdCopyBuffer(cmd, src, dst, 1, &region);
+
+    BufferHandoff handoff;
+    handoff.buffer = dst;
+    handoff.size = size;
+    handoff.dstStage = dstStage;
+    handoff.dstAccess = dstAccess;
+    return uploadQueue.submit(device, cmd, {}, { handoff });
+}
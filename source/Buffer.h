@@ -2,6 +2,8 @@
 #include <vulkan/vulkan.h>
 #include <cstdint>
 
+class AsyncQueue;
+class DeletionQueue;
 class Device;
 
 // RAII wrapper for VkBuffer and VkDeviceMemory
@@ -21,6 +23,9 @@ public:
         VkMemoryPropertyFlags properties);
 
     void destroy(const Device& device);
+    // Hand the buffer to `deletionQueue`, destroyed once the frame timeline
+    // reaches `value`; this object is empty afterwards
+    void retire(const Device& device, DeletionQueue& deletionQueue, uint64_t value);
 
     void* map(const Device& device, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
     void  unmap(const Device& device);
@@ -33,6 +38,17 @@ public:
         VkBuffer dst,
         VkDeviceSize size);
 
+    // Copy on `uploadQueue` (e.g. the transfer queue) and hand `dst` to the
+    // graphics queue for reads at `dstStage` with `dstAccess`. Returns without
+    // waiting; `src` must live until the frame timeline reaches the result.
+    static uint64_t copyBuffer(const Device& device,
+        AsyncQueue& uploadQueue,
+        VkBuffer src,
+        VkBuffer dst,
+        VkDeviceSize size,
+        VkPipelineStageFlags dstStage,
+        VkAccessFlags dstAccess);
+
     VkBuffer       get() const { return m_buffer; }
     VkDeviceMemory getMemory() const { return m_memory; }
     VkDeviceSize   size() const { return m_bufferSize; }
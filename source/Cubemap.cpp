@@ -5,6 +5,8 @@
 #include "Cubemap.h"
 #include "Device.h"
 #include "Utilities.h"
+#include "Buffer.h"
+#include "MipGenerator.h"
 #include <stdexcept>
 #include <algorithm>
 #include <cmath>
@@ -35,98 +37,81 @@ void Cubemap::createFromFaces(const Device& device,
     uint32_t height,
     VkFormat format,
     bool generateMipmapsEnabled,
-    VkFilter samplerFilter)
+    VkFilter samplerFilter,
+    MipGenerator* mipGenerator)
 {
     if (!faces || !faces[0]) throw std::runtime_error("Cubemap: faces null");
+    m_faceSize = width;
 
     m_mipLevels = generateMipmapsEnabled
         ? (uint32_t)std::floor(std::log2(std::max(width, height))) + 1
         : 1u;
 
-    VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-    if (generateMipmapsEnabled) usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
-    createImageCube(device, width, height, m_mipLevels, format, usage);
+    const bool computeMipmaps = generateMipmapsEnabled && mipGenerator &&
+                                mipGenerator->supports(device, format, width, height);
 
-    transitionLayoutAll(device, commandPool, graphicsQueue,
-        format, VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    VkImageCreateFlags flags = 0;
+    if (computeMipmaps) {
+        usage |= MipGenerator::kImageUsage;
+        flags = MipGenerator::imageFlags(format);
+    }
+    else if (generateMipmapsEnabled) usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    createImageCube(device, width, height, m_mipLevels, format, usage, flags);
 
+    // All six faces in one staging buffer and one copy
     const VkDeviceSize faceSize = (VkDeviceSize)width * height * bytesPerPixel(format);
-
+    Buffer staging;
+    staging.createAndMap(device, faceSize * 6,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    std::vector<VkBufferImageCopy> regions(6);
     for (uint32_t f = 0; f < 6; ++f) {
-        VkBuffer stagingBuffer = VK_NULL_HANDLE;
-        VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
-
-        // staging buffer
-        {
-            VkBufferCreateInfo bi{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-            bi.size = faceSize;
-            bi.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-            bi.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-            if (vkCreateBuffer(device.get(), &bi, nullptr, &stagingBuffer) != VK_SUCCESS)
-                throw std::runtime_error("Cubemap: create staging buffer failed");
-
-            VkMemoryRequirements memReq{};
-            vkGetBufferMemoryRequirements(device.get(), stagingBuffer, &memReq);
-
-            VkPhysicalDeviceMemoryProperties memProp{};
-            vkGetPhysicalDeviceMemoryProperties(device.physical(), &memProp);
-
-            uint32_t typeIndex = UINT32_MAX;
-            for (uint32_t i = 0; i < memProp.memoryTypeCount; ++i) {
-                if ((memReq.memoryTypeBits & (1u << i)) &&
-                    (memProp.memoryTypes[i].propertyFlags &
-                        (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) ==
-                    (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
-                    typeIndex = i; break;
-                }
-            }
-            if (typeIndex == UINT32_MAX) throw std::runtime_error("Cubemap: no staging mem type");
-
-            VkMemoryAllocateInfo mai{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-            mai.allocationSize = memReq.size;
-            mai.memoryTypeIndex = typeIndex;
-            if (vkAllocateMemory(device.get(), &mai, nullptr, &stagingMemory) != VK_SUCCESS)
-                throw std::runtime_error("Cubemap: alloc staging memory failed");
-
-            vkBindBufferMemory(device.get(), stagingBuffer, stagingMemory, 0);
-
-            void* map = nullptr;
-            vkMapMemory(device.get(), stagingMemory, 0, faceSize, 0, &map);
-            std::memcpy(map, faces[f], (size_t)faceSize);
-            vkUnmapMemory(device.get(), stagingMemory);
-        }
-
-        VkCommandBuffer cmd = beginSingleTimeCommands(device, commandPool);
+        staging.write(faces[f], faceSize, faceSize * f);
 
-        VkBufferImageCopy region{};
-        region.bufferOffset = 0;
+        VkBufferImageCopy& region = regions[f];
+        region.bufferOffset = faceSize * f;
         region.bufferRowLength = 0;
         region.bufferImageHeight = 0;
         region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = f; 
+        region.imageSubresource.baseArrayLayer = f;
         region.imageSubresource.layerCount = 1;
         region.imageOffset = { 0, 0, 0 };
         region.imageExtent = { width, height, 1 };
-
-        vkCmdCopyBufferToImage(cmd, stagingBuffer, m_image,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-        endSingleTimeCommands(device, cmd, commandPool, graphicsQueue);
-
-        vkDestroyBuffer(device.get(), stagingBuffer, nullptr);
-        vkFreeMemory(device.get(), stagingMemory, nullptr);
     }
 
-    if (generateMipmapsEnabled) {
-        generateMipmapsCube(device, commandPool, graphicsQueue, format,
-            (int32_t)width, (int32_t)height);
+    uint64_t generateValue = 0;
+    if (computeMipmaps) {
+        generateValue = mipGenerator->generate(device, commandPool, graphicsQueue, staging.get(), regions,
+                                               m_image, format, width, height, m_mipLevels, 6);
     }
     else {
-        transitionLayoutAll(device, commandPool, graphicsQueue, format,
+        transitionLayoutAll(device, commandPool, graphicsQueue,
+            format, VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+        VkCommandBuffer cmd = beginSingleTimeCommands(device, commandPool);
+        vkCmdCopyBufferToImage(cmd, staging.get(), m_image,
             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            static_cast<uint32_t>(regions.size()), regions.data());
+        endSingleTimeCommands(device, cmd, commandPool, graphicsQueue);
+
+        if (generateMipmapsEnabled) {
+            generateMipmapsCube(device, commandPool, graphicsQueue, format,
+                (int32_t)width, (int32_t)height);
+        }
+        else {
+            transitionLayoutAll(device, commandPool, graphicsQueue, format,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        }
+    }
+    DeletionQueue* deletionQueue = computeMipmaps ? mipGenerator->deletionQueue() : nullptr;
+    if (deletionQueue) {
+        staging.retire(device, *deletionQueue, generateValue);
+    } else {
+        staging.destroy(device);
     }
 
     VkImageViewCreateInfo vi{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
@@ -152,10 +137,11 @@ void Cubemap::createImageCube(const Device& device,
     uint32_t width, uint32_t height,
     uint32_t mipLevels,
     VkFormat format,
-    VkImageUsageFlags usage)
+    VkImageUsageFlags usage,
+    VkImageCreateFlags flags)
 {
     VkImageCreateInfo ci{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
-    ci.flags = VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+    ci.flags = VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT | flags;
     ci.imageType = VK_IMAGE_TYPE_2D;
     ci.format = format;
     ci.extent = { width, height, 1 };
@@ -256,75 +242,7 @@ void Cubemap::generateMipmapsCube(const Device& device,
     }
 
     VkCommandBuffer cmd = beginSingleTimeCommands(device, commandPool);
-
-    VkImageMemoryBarrier barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
-    barrier.image = m_image;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.layerCount = 1;
-
-    for (uint32_t layer = 0; layer < 6; ++layer) {
-        int32_t mipW = texWidth;
-        int32_t mipH = texHeight;
-
-        for (uint32_t level = 1; level < m_mipLevels; ++level) {
-            barrier.subresourceRange.baseMipLevel = level - 1;
-            barrier.subresourceRange.baseArrayLayer = layer;
-            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-            vkCmdPipelineBarrier(cmd,
-                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-            int32_t nextW = std::max(mipW / 2, 1);
-            int32_t nextH = std::max(mipH / 2, 1);
-
-            VkImageBlit blit{};
-            blit.srcOffsets[0] = { 0, 0, 0 };
-            blit.srcOffsets[1] = { mipW, mipH, 1 };
-            blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            blit.srcSubresource.mipLevel = level - 1;
-            blit.srcSubresource.baseArrayLayer = layer;
-            blit.srcSubresource.layerCount = 1;
-
-            blit.dstOffsets[0] = { 0, 0, 0 };
-            blit.dstOffsets[1] = { nextW, nextH, 1 };
-            blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            blit.dstSubresource.mipLevel = level;
-            blit.dstSubresource.baseArrayLayer = layer;
-            blit.dstSubresource.layerCount = 1;
-
-            vkCmdBlitImage(cmd,
-                m_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                1, &blit, VK_FILTER_LINEAR);
-
-            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-            vkCmdPipelineBarrier(cmd,
-                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-            mipW = nextW;
-            mipH = nextH;
-        }
-
-        barrier.subresourceRange.baseMipLevel = m_mipLevels - 1;
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        vkCmdPipelineBarrier(cmd,
-            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-            0, 0, nullptr, 0, nullptr, 1, &barrier);
-    }
-
+    recordBlitMipChain(cmd, m_image, (uint32_t)texWidth, (uint32_t)texHeight, m_mipLevels, 6);
     endSingleTimeCommands(device, cmd, commandPool, graphicsQueue);
 }
 
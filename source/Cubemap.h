@@ -4,6 +4,8 @@
 #include "Device.h"
 #include "Texture.h"
 
+class MipGenerator;
+
 class Cubemap : public Texture {
 public:
     Cubemap() = default;
@@ -17,14 +19,18 @@ public:
         uint32_t height,
         VkFormat format,
         bool generateMipmapsEnabled,
-        VkFilter samplerFilter = VK_FILTER_LINEAR);
+        VkFilter samplerFilter = VK_FILTER_LINEAR,
+        MipGenerator* mipGenerator = nullptr);   // all six faces in one dispatch when supported
+
+    uint32_t faceSize() const { return m_faceSize; }
 
 private:
     void createImageCube(const Device& device,
         uint32_t width, uint32_t height,
         uint32_t mipLevels,
         VkFormat format,
-        VkImageUsageFlags usage);
+        VkImageUsageFlags usage,
+        VkImageCreateFlags flags = 0);
 
     void transitionLayoutAll(const Device& device,
         VkCommandPool commandPool,
@@ -40,4 +46,6 @@ private:
         int32_t width, int32_t height);
 
     void createCubemapSampler(const Device& device, VkFilter filter);
+
+    uint32_t m_faceSize = 0;   // width of mip 0
 };
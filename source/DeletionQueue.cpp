@@ -0,0 +1,26 @@
+// ============================================================================
+// DeletionQueue.cpp - Timeline-deferred destruction
+// ============================================================================
+
+#include "DeletionQueue.h"
+#include <utility>
+
+void DeletionQueue::push(uint64_t value, std::function<void()> destroy) {
+    m_entries.push_back({ value, std::move(destroy) });
+}
+
+void DeletionQueue::collect(uint64_t completedValue) {
+    while (!m_entries.empty() && m_entries.front().value <= completedValue) {
+        std::function<void()> destroy = std::move(m_entries.front().destroy);
+        m_entries.pop_front();
+        destroy();
+    }
+}
+
+void DeletionQueue::flush() {
+    while (!m_entries.empty()) {
+        std::function<void()> destroy = std::move(m_entries.front().destroy);
+        m_entries.pop_front();
+        destroy();
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+// ============================================================================
+// Deletion Queue
+// Destruction deferred until the GPU is done with an object. Each entry is
+// tagged with the frame timeline value (SyncObjects::submittedValue(), or
+// the value AsyncQueue::submit() returned) of the last submission that may
+// use the object and runs once the timeline has reached it, so replacing a
+// resource or freeing staging never needs a device or queue idle.
+// ============================================================================
+
+class DeletionQueue {
+public:
+    // Run `destroy` once the timeline reaches `value`; values must not decrease
+    void push(uint64_t value, std::function<void()> destroy);
+
+    // Run every entry the timeline has passed; call once per frame
+    void collect(uint64_t completedValue);
+
+    // Run everything now; only after the device is idle
+    void flush();
+
+    size_t pending() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        uint64_t value = 0;
+        std::function<void()> destroy;
+    };
+    std::deque<Entry> m_entries;
+};
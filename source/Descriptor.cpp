@@ -79,31 +79,29 @@ void DescriptorSetLayoutRAII::destroy(const Device& device)
     }
 }
 
-const int kMaxFramesInFlight = 2;
-
-void DescriptorPoolRAII::create(const Device& device)
+void DescriptorPoolRAII::create(const Device& device, uint32_t framesInFlight)
 {
     std::array<VkDescriptorPoolSize, 7> poolSizes{};
     poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = static_cast<uint32_t>(kMaxFramesInFlight);
+    poolSizes[0].descriptorCount = framesInFlight;
     poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[1].descriptorCount = static_cast<uint32_t>(kMaxFramesInFlight);
+    poolSizes[1].descriptorCount = framesInFlight;
     poolSizes[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[2].descriptorCount = static_cast<uint32_t>(kMaxFramesInFlight);
+    poolSizes[2].descriptorCount = framesInFlight;
     poolSizes[3].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[3].descriptorCount = static_cast<uint32_t>(kMaxFramesInFlight);
+    poolSizes[3].descriptorCount = framesInFlight;
     poolSizes[4].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[4].descriptorCount = static_cast<uint32_t>(kMaxFramesInFlight);
+    poolSizes[4].descriptorCount = framesInFlight;
     poolSizes[5].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[5].descriptorCount = static_cast<uint32_t>(kMaxFramesInFlight);
+    poolSizes[5].descriptorCount = framesInFlight;
     poolSizes[6].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[6].descriptorCount = static_cast<uint32_t>(kMaxFramesInFlight);
+    poolSizes[6].descriptorCount = framesInFlight;
 
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
     poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
     poolInfo.pPoolSizes = poolSizes.data();
-    poolInfo.maxSets = static_cast<uint32_t>(kMaxFramesInFlight);
+    poolInfo.maxSets = framesInFlight;
     if (vkCreateDescriptorPool(device.get(), &poolInfo, nullptr, &m_pool) != VK_SUCCESS) {
         throw std::runtime_error("failed to create descriptor pool!");
     }
@@ -117,15 +115,15 @@ void DescriptorPoolRAII::destroy(const Device& device)
     }
 }
 
-void DescriptorSet::create(const Device& device, VkDescriptorPool pool, VkDescriptorSetLayout layout)
+void DescriptorSet::create(const Device& device, VkDescriptorPool pool, VkDescriptorSetLayout layout, uint32_t framesInFlight)
 {
-    std::vector<VkDescriptorSetLayout> layouts(kMaxFramesInFlight, layout);
+    std::vector<VkDescriptorSetLayout> layouts(framesInFlight, layout);
     VkDescriptorSetAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
     allocInfo.descriptorPool = pool;
-    allocInfo.descriptorSetCount = static_cast<uint32_t>(kMaxFramesInFlight);
+    allocInfo.descriptorSetCount = framesInFlight;
     allocInfo.pSetLayouts = layouts.data();
-    m_descriptorSets.resize(kMaxFramesInFlight);
+    m_descriptorSets.resize(framesInFlight);
     if (vkAllocateDescriptorSets(device.get(), &allocInfo, m_descriptorSets.data()) != VK_SUCCESS) {
         throw std::runtime_error("failed to allocate descriptor sets!");
     }
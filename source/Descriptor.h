@@ -14,7 +14,7 @@ private:
 
 class DescriptorPoolRAII {
 public:
-    void create(const Device& device);
+    void create(const Device& device, uint32_t framesInFlight);
     void destroy(const Device& device);
     VkDescriptorPool get() const { return m_pool; }
 private:
@@ -23,7 +23,7 @@ private:
 
 class DescriptorSet {
 public:
-    void create(const Device& device, VkDescriptorPool pool, VkDescriptorSetLayout layout);
+    void create(const Device& device, VkDescriptorPool pool, VkDescriptorSetLayout layout, uint32_t framesInFlight);
     void destroy(const Device& device);
     std::vector<VkDescriptorSet> get() const { return m_descriptorSets; }
     VkDescriptorSet& operator[](size_t index) { return m_descriptorSets[index]; }
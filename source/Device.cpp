@@ -1,9 +1,12 @@
 #include "Device.h"
 #include "Instance.h"
 #include "PhysicalDevice.h"
+#include <cstring>
+#include <iostream>
 #include <vector>
 #include <set>
 #include <stdexcept>
+#include <string>
 
 void Device::create(const PhysicalDevice& physicalDevice, bool enableValidationLayers)
 {
@@ -14,6 +17,8 @@ void Device::create(const PhysicalDevice& physicalDevice, bool enableValidationL
 
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
     std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.presentFamily.value() };
+    if (indices.transferFamily.has_value()) uniqueQueueFamilies.insert(indices.transferFamily.value());
+    if (indices.computeFamily.has_value()) uniqueQueueFamilies.insert(indices.computeFamily.value());
 
     float queuePriority = 1.0f;
     for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -25,17 +30,66 @@ void Device::create(const PhysicalDevice& physicalDevice, bool enableValidationL
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
+    VkPhysicalDeviceFeatures supportedFeatures{};
+    vkGetPhysicalDeviceFeatures(m_physicalDevice, &supportedFeatures);
+
     VkPhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
+    // Optional: BCn sampling for cooked textures (falls back to RGBA8 when absent)
+    deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+    // Optional: texture feedback writes from gltf.frag (residency stays static without it)
+    deviceFeatures.fragmentStoresAndAtomics = supportedFeatures.fragmentStoresAndAtomics;
+    // Optional: fragment invocation counts for the depth pre-pass comparison
+    deviceFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
+    // Optional: single-dispatch compute mip generation (MipGenerator falls back to blits)
+    deviceFeatures.shaderStorageImageWriteWithoutFormat = supportedFeatures.shaderStorageImageWriteWithoutFormat;
+
+    // Descriptor indexing for the bindless texture heap (checked by PhysicalDevice::pick)
+    VkPhysicalDeviceVulkan12Features supported12{};
+    supported12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    VkPhysicalDeviceFeatures2 supported2{};
+    supported2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supported2.pNext = &supported12;
+    vkGetPhysicalDeviceFeatures2(m_physicalDevice, &supported2);
+
+    VkPhysicalDeviceVulkan12Features features12{};
+    features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    features12.runtimeDescriptorArray = VK_TRUE;
+    features12.descriptorBindingPartiallyBound = VK_TRUE;
+    features12.descriptorBindingVariableDescriptorCount = VK_TRUE;
+    features12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    features12.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+    features12.timelineSemaphore = VK_TRUE;   // frame pacing (SyncObjects)
+    features12.shaderSampledImageArrayNonUniformIndexing = supported12.shaderSampledImageArrayNonUniformIndexing;
+
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &features12;
+    features2.features = deviceFeatures;
+
+    // Optional: exact pipeline cache hit reporting (PipelineCache infers it otherwise)
+    std::vector<const char*> extensions = kDeviceExtensions;
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+    m_pipelineCreationFeedback = false;
+    for (const auto& extension : availableExtensions) {
+        if (std::strcmp(extension.extensionName, VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME) == 0) {
+            extensions.push_back(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+            m_pipelineCreationFeedback = true;
+        }
+    }
 
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = &features2;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
-    createInfo.pEnabledFeatures = &deviceFeatures;
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(kDeviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = kDeviceExtensions.data();
+    createInfo.pEnabledFeatures = nullptr;  // core features travel in features2
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    createInfo.ppEnabledExtensionNames = extensions.data();
 
     if (enableValidationLayers) {
         createInfo.enabledLayerCount = static_cast<uint32_t>(kValidationLayers.size());
@@ -48,9 +102,21 @@ void Device::create(const PhysicalDevice& physicalDevice, bool enableValidationL
     if (vkCreateDevice(m_physicalDevice, &createInfo, nullptr, &m_device) != VK_SUCCESS) {
         throw std::runtime_error("failed to create logical device!");
     }
+    m_enabledFeatures = deviceFeatures;
+    m_enabledFeatures12 = features12;
+    m_enabledFeatures12.pNext = nullptr;
 
     vkGetDeviceQueue(m_device, indices.graphicsFamily.value(), 0, &m_graphicsQueue);
     vkGetDeviceQueue(m_device, indices.presentFamily.value(), 0, &m_presentQueue);
+    vkGetDeviceQueue(m_device, transferFamily(), 0, &m_transferQueue);
+    vkGetDeviceQueue(m_device, computeFamily(), 0, &m_computeQueue);
+
+    std::cout << "Queues: graphics family " << graphicsFamily()
+              << ", transfer " << (indices.transferFamily.has_value() ? "family " + std::to_string(transferFamily())
+                                                                       : std::string("on graphics"))
+              << ", async compute " << (indices.computeFamily.has_value() ? "family " + std::to_string(computeFamily())
+                                                                          : std::string("on graphics"))
+              << std::endl;
 }
 
 void Device::destroy()
@@ -11,13 +11,28 @@ public:
     VkPhysicalDevice physical() const { return m_physicalDevice; }
     VkQueue graphicsQ() const { return m_graphicsQueue; }
     VkQueue presentQ() const { return m_presentQueue; }
+    // Dedicated transfer / async-compute queues; the graphics queue (and
+    // family) when the device has no separate family for them
+    VkQueue transferQ() const { return m_transferQueue; }
+    VkQueue computeQ() const { return m_computeQueue; }
+    uint32_t graphicsFamily() const { return m_queueIndices.graphicsFamily.value(); }
+    uint32_t transferFamily() const { return m_queueIndices.transferFamily.value_or(graphicsFamily()); }
+    uint32_t computeFamily() const { return m_queueIndices.computeFamily.value_or(graphicsFamily()); }
     QueueFamilyIndices queues() const { return m_queueIndices; }
+    const VkPhysicalDeviceFeatures& features() const { return m_enabledFeatures; }
+    const VkPhysicalDeviceVulkan12Features& features12() const { return m_enabledFeatures12; }
+    bool hasPipelineCreationFeedback() const { return m_pipelineCreationFeedback; }
 
 private:
     VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
     VkDevice m_device = VK_NULL_HANDLE;
     VkQueue m_graphicsQueue = VK_NULL_HANDLE;
     VkQueue m_presentQueue = VK_NULL_HANDLE;
+    VkQueue m_transferQueue = VK_NULL_HANDLE;
+    VkQueue m_computeQueue = VK_NULL_HANDLE;
     QueueFamilyIndices m_queueIndices;
+    VkPhysicalDeviceFeatures m_enabledFeatures{};
+    VkPhysicalDeviceVulkan12Features m_enabledFeatures12{};
+    bool m_pipelineCreationFeedback = false;  // VK_EXT_pipeline_creation_feedback enabled
 };
 
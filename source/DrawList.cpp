@@ -0,0 +1,161 @@
+// ============================================================================
+// DrawList.cpp - Sort-key draw ordering
+// ============================================================================
+
+#include "DrawList.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+// ============================================================================
+// Sort Keys
+// ============================================================================
+
+namespace drawkey {
+
+namespace {
+
+constexpr uint64_t mask(uint32_t bits) {
+    return (uint64_t(1) << bits) - 1;
+}
+
+} // namespace
+
+uint64_t make(uint32_t pass, uint32_t variant, uint32_t material, uint32_t geometry,
+              float depth01, bool backToFront) {
+    float clamped = std::min(std::max(depth01, 0.0f), 1.0f);
+    uint64_t depth = static_cast<uint64_t>(clamped * static_cast<float>(mask(kDepthBits)));
+    if (backToFront) {
+        depth = mask(kDepthBits) - depth;
+    }
+
+    uint64_t state = ((uint64_t(variant) & mask(kVariantBits)) << (kMaterialBits + kGeometryBits)) |
+                     ((uint64_t(material) & mask(kMaterialBits)) << kGeometryBits) |
+                     (uint64_t(geometry) & mask(kGeometryBits));
+    constexpr uint32_t kStateBits = kVariantBits + kMaterialBits + kGeometryBits;
+
+    uint64_t key = (uint64_t(pass) & mask(kPassBits)) << (64 - kPassBits);
+    if (backToFront) {
+        key |= (depth << kStateBits) | state;
+    } else {
+        key |= (state << kDepthBits) | depth;
+    }
+    return key;
+}
+
+} // namespace drawkey
+
+// ============================================================================
+// Radix Sort
+// ============================================================================
+
+void DrawList::sort() {
+    const size_t count = m_entries.size();
+    if (count < 2) return;
+
+    // 11-bit digits: six passes cover the key, and a 2048-entry histogram
+    // still sits in L1
+    constexpr uint32_t kDigitBits = 11;
+    constexpr uint32_t kBuckets = 1u << kDigitBits;
+    constexpr uint32_t kDigits = (64 + kDigitBits - 1) / kDigitBits;
+
+    // All histograms in one read of the keys
+    std::vector<uint32_t>& histograms = m_histograms;
+    histograms.assign(kDigits * kBuckets, 0);
+    for (const Entry& entry : m_entries) {
+        uint64_t key = entry.key;
+        for (uint32_t digit = 0; digit < kDigits; ++digit) {
+            histograms[digit * kBuckets + ((key >> (digit * kDigitBits)) & (kBuckets - 1))]++;
+        }
+    }
+
+    m_scratch.resize(count);
+    Entry* source = m_entries.data();
+    Entry* target = m_scratch.data();
+
+    for (uint32_t digit = 0; digit < kDigits; ++digit) {
+        uint32_t* histogram = &histograms[digit * kBuckets];
+        const uint32_t shift = digit * kDigitBits;
+
+        // Every key has the same digit here: this pass would be a plain copy
+        if (histogram[(source[0].key >> shift) & (kBuckets - 1)] == count) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (uint32_t bucket = 0; bucket < kBuckets; ++bucket) {
+            uint32_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            target[histogram[(source[i].key >> shift) & (kBuckets - 1)]++] = source[i];
+        }
+        std::swap(source, target);
+    }
+
+    if (source != m_entries.data()) {
+        m_entries.swap(m_scratch);
+    }
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+void benchmarkDrawListSort() {
+    constexpr int kRuns = 5;
+    const size_t counts[] = { 10000, 100000, 1000000 };
+
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<uint32_t> pass(0, 2), variant(0, 31), material(0, 511), geometry(0, 4095);
+    std::uniform_real_distribution<float> depth(0.0f, 1.0f);
+
+    std::cout << "Draw list sort (best of " << kRuns << " runs)" << std::endl;
+    std::cout << std::setw(10) << "draws" << std::setw(14) << "radix ms" << std::setw(14) << "std::sort ms"
+              << std::setw(10) << "speedup" << std::endl;
+
+    for (size_t count : counts) {
+        // Realistic key distribution: few passes and variants, many depths
+        std::vector<DrawList::Entry> input(count);
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t p = pass(rng);
+            input[i].key = drawkey::make(p, variant(rng), material(rng), geometry(rng), depth(rng), p == 2);
+            input[i].draw = static_cast<uint32_t>(i);
+        }
+
+        DrawList list;
+        list.reserve(count);
+        std::vector<DrawList::Entry> reference;
+        double radixMs = 1e30;
+        double stdMs = 1e30;
+
+        for (int run = 0; run < kRuns; ++run) {
+            list.clear();
+            for (const auto& entry : input) list.add(entry.key, entry.draw);
+            auto start = std::chrono::steady_clock::now();
+            list.sort();
+            radixMs = std::min(radixMs, std::chrono::duration<double, std::milli>(
+                                            std::chrono::steady_clock::now() - start).count());
+
+            reference = input;
+            start = std::chrono::steady_clock::now();
+            std::sort(reference.begin(), reference.end(), [](const DrawList::Entry& a, const DrawList::Entry& b) {
+                return a.key < b.key;
+            });
+            stdMs = std::min(stdMs, std::chrono::duration<double, std::milli>(
+                                        std::chrono::steady_clock::now() - start).count());
+        }
+
+        bool sameOrder = std::equal(reference.begin(), reference.end(), list.entries().begin(),
+                                    [](const DrawList::Entry& a, const DrawList::Entry& b) { return a.key == b.key; });
+
+        std::cout << std::setw(10) << count << std::fixed << std::setprecision(3)
+                  << std::setw(14) << radixMs << std::setw(14) << stdMs
+                  << std::setprecision(2) << std::setw(9) << stdMs / radixMs << "x"
+                  << (sameOrder ? "" : "  MISMATCH") << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+}
@@ -0,0 +1,574 @@
+// ============================================================================
+// EnvironmentLighting.cpp - Compute-baked split-sum IBL and its disk cache
+// ============================================================================
+
+#include "EnvironmentLighting.h"
+#include "Cubemap.h"
+#include "Device.h"
+#include "Pipeline.h"
+#include "PipelineCache.h"
+#include "Utilities.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+// ============================================================================
+// Helper Functions
+// ============================================================================
+
+namespace {
+
+constexpr VkFormat kFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
+constexpr VkDeviceSize kTexelBytes = 8;
+
+// Bump whenever a bake shader, the file layout or the bake's input changes
+// (3: caches baked from cubemaps whose faces 1-5 were staged at offset 0)
+constexpr uint32_t kCacheVersion = 3;
+constexpr char kCacheMagic[4] = { 'K', 'I', 'B', 'L' };
+
+struct CacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t specularSize;
+    uint32_t specularMipLevels;
+    uint32_t specularSamples;
+    uint32_t brdfLutSize;
+    uint32_t brdfLutSamples;
+    uint32_t sourceFaceSize;
+    uint64_t sourceKey;     // also names the file; checked so a renamed file is not taken for another source
+};
+
+struct PrefilterParams {
+    float roughness;
+    uint32_t mipSize;
+    uint32_t sourceSize;
+    uint32_t sampleCount;
+};
+
+struct IrradianceParams {
+    uint32_t faceSize;
+    float sourceLod;
+};
+
+struct BrdfLutParams {
+    uint32_t size;
+    uint32_t sampleCount;
+};
+
+// Irradiance is band-limited; a 32x32 source mip per face is plenty
+constexpr uint32_t kIrradianceFaceSize = 32;
+
+void createImage(const Device& device, uint32_t size, uint32_t mipLevels, uint32_t layers,
+                 VkImageCreateFlags flags, VkImage& image, VkDeviceMemory& memory) {
+    VkImageCreateInfo imageInfo{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+    imageInfo.flags = flags;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = kFormat;
+    imageInfo.extent = { size, size, 1 };
+    imageInfo.mipLevels = mipLevels;
+    imageInfo.arrayLayers = layers;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+                      VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (vkCreateImage(device.get(), &imageInfo, nullptr, &image) != VK_SUCCESS) {
+        throw std::runtime_error("EnvironmentLighting: create image failed");
+    }
+
+    VkMemoryRequirements requirements{};
+    vkGetImageMemoryRequirements(device.get(), image, &requirements);
+    VkMemoryAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+    allocInfo.allocationSize = requirements.size;
+    allocInfo.memoryTypeIndex = findMemoryType(device.physical(), requirements.memoryTypeBits,
+                                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    if (vkAllocateMemory(device.get(), &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+        throw std::runtime_error("EnvironmentLighting: alloc image memory failed");
+    }
+    vkBindImageMemory(device.get(), image, memory, 0);
+}
+
+VkImageView createView(const Device& device, VkImage image, VkImageViewType type,
+                       uint32_t baseMip, uint32_t mipCount, uint32_t layers) {
+    VkImageViewCreateInfo viewInfo{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    viewInfo.image = image;
+    viewInfo.viewType = type;
+    viewInfo.format = kFormat;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = baseMip;
+    viewInfo.subresourceRange.levelCount = mipCount;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = layers;
+    VkImageView view = VK_NULL_HANDLE;
+    if (vkCreateImageView(device.get(), &viewInfo, nullptr, &view) != VK_SUCCESS) {
+        throw std::runtime_error("EnvironmentLighting: create image view failed");
+    }
+    return view;
+}
+
+// Whole-image barrier (all mips and layers)
+void transition(VkCommandBuffer cmd, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout,
+                VkAccessFlags srcAccess, VkAccessFlags dstAccess,
+                VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage) {
+    VkImageMemoryBarrier barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+    barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+    vkCmdPipelineBarrier(cmd, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+VkDescriptorSetLayout createSetLayout(const Device& device, const std::vector<VkDescriptorType>& types) {
+    std::vector<VkDescriptorSetLayoutBinding> bindings(types.size());
+    for (uint32_t i = 0; i < types.size(); ++i) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = types[i];
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    VkDescriptorSetLayoutCreateInfo layoutInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    if (vkCreateDescriptorSetLayout(device.get(), &layoutInfo, nullptr, &layout) != VK_SUCCESS) {
+        throw std::runtime_error("EnvironmentLighting: create descriptor set layout failed");
+    }
+    return layout;
+}
+
+VkPipeline createComputePipeline(const Device& device, PipelineCache& pipelineCache, VkPipelineLayout layout,
+                                 VkShaderModule module, const char* name) {
+    VkComputePipelineCreateInfo pipelineInfo{ VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = module;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = layout;
+    return pipelineCache.createComputePipeline(device, pipelineInfo, name);
+}
+
+uint32_t groupCount(uint32_t size) {
+    return (size + 7) / 8;
+}
+
+} // namespace
+
+// ============================================================================
+// Creation
+// ============================================================================
+
+void EnvironmentLighting::create(const Device& device,
+                                 VkCommandPool commandPool,
+                                 VkQueue queue,
+                                 PipelineCache& pipelineCache,
+                                 const Cubemap& source,
+                                 uint64_t sourceKey,
+                                 const BakeShaders& shaders,
+                                 const EnvironmentLightingOptions& options) {
+    m_options = options;
+    m_options.specularMipLevels = std::max(1u, std::min(m_options.specularMipLevels,
+        static_cast<uint32_t>(std::log2(m_options.specularSize)) + 1));
+
+    createTargets(device);
+
+    std::string cachePath;
+    if (m_options.useDiskCache && sourceKey != 0) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.ibl", static_cast<unsigned long long>(sourceKey));
+        cachePath = m_options.cacheDirectory + "/" + name;
+        if (loadFromCache(device, commandPool, queue, cachePath, sourceKey, source.faceSize())) {
+            std::cout << "IBL: loaded from " << cachePath << std::endl;
+            return;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bake(device, commandPool, queue, pipelineCache, source, shaders);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "IBL: baked " << m_options.specularSize << "px specular (" << m_options.specularMipLevels
+              << " mips), SH9 irradiance and " << m_options.brdfLutSize << "px BRDF LUT in " << ms << " ms"
+              << std::endl;
+
+    if (!cachePath.empty()) {
+        saveToCache(device, commandPool, queue, cachePath, sourceKey, source.faceSize());
+    }
+}
+
+void EnvironmentLighting::createTargets(const Device& device) {
+    createImage(device, m_options.specularSize, m_options.specularMipLevels, 6, VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT,
+                m_specular.image, m_specular.memory);
+    m_specular.view = createView(device, m_specular.image, VK_IMAGE_VIEW_TYPE_CUBE, 0, m_options.specularMipLevels, 6);
+
+    createImage(device, m_options.brdfLutSize, 1, 1, 0, m_brdfLut.image, m_brdfLut.memory);
+    m_brdfLut.view = createView(device, m_brdfLut.image, VK_IMAGE_VIEW_TYPE_2D, 0, 1, 1);
+
+    m_irradiance.createAndMap(device, kIrradianceBufferSize,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    VkSamplerCreateInfo samplerInfo{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxAnisotropy = 1.0f;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+    samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+    if (vkCreateSampler(device.get(), &samplerInfo, nullptr, &m_sampler) != VK_SUCCESS) {
+        throw std::runtime_error("EnvironmentLighting: create sampler failed");
+    }
+}
+
+void EnvironmentLighting::destroy(const Device& device) {
+    for (Image* image : { &m_specular, &m_brdfLut }) {
+        if (image->view != VK_NULL_HANDLE) vkDestroyImageView(device.get(), image->view, nullptr);
+        if (image->image != VK_NULL_HANDLE) vkDestroyImage(device.get(), image->image, nullptr);
+        if (image->memory != VK_NULL_HANDLE) vkFreeMemory(device.get(), image->memory, nullptr);
+        *image = {};
+    }
+    m_irradiance.destroy(device);
+    if (m_sampler != VK_NULL_HANDLE) {
+        vkDestroySampler(device.get(), m_sampler, nullptr);
+        m_sampler = VK_NULL_HANDLE;
+    }
+}
+
+uint64_t EnvironmentLighting::hashFiles(const std::vector<std::string>& paths) {
+    uint64_t hash = 14695981039346656037ull;   // FNV-1a
+    std::vector<char> data;
+    for (const std::string& path : paths) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return 0;
+        }
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(data.data(), static_cast<std::streamsize>(data.size()));
+        for (char c : data) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash == 0 ? 1 : hash;
+}
+
+// ============================================================================
+// Bake
+// ============================================================================
+
+void EnvironmentLighting::bake(const Device& device,
+                               VkCommandPool commandPool,
+                               VkQueue queue,
+                               PipelineCache& pipelineCache,
+                               const Cubemap& source,
+                               const BakeShaders& shaders) {
+    const uint32_t mips = m_options.specularMipLevels;
+
+    // ---- Layouts, pipelines and one descriptor set per dispatch ----
+    VkDescriptorSetLayout prefilterSetLayout = createSetLayout(device,
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE });
+    VkDescriptorSetLayout irradianceSetLayout = createSetLayout(device,
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER });
+    VkDescriptorSetLayout lutSetLayout = createSetLayout(device, { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE });
+
+    PipelineLayoutRAII prefilterLayout, irradianceLayout, lutLayout;
+    prefilterLayout.create(device, { prefilterSetLayout },
+        { { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PrefilterParams) } });
+    irradianceLayout.create(device, { irradianceSetLayout },
+        { { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(IrradianceParams) } });
+    lutLayout.create(device, { lutSetLayout },
+        { { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(BrdfLutParams) } });
+
+    VkPipeline prefilterPipeline = createComputePipeline(device, pipelineCache, prefilterLayout.get(),
+                                                         shaders.prefilter, "ibl prefilter");
+    VkPipeline irradiancePipeline = createComputePipeline(device, pipelineCache, irradianceLayout.get(),
+                                                          shaders.irradiance, "ibl irradiance");
+    VkPipeline lutPipeline = createComputePipeline(device, pipelineCache, lutLayout.get(),
+                                                   shaders.brdfLut, "ibl brdf lut");
+
+    std::array<VkDescriptorPoolSize, 3> poolSizes{ {
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, mips + 1 },
+        { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, mips + 1 },
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1 },
+    } };
+    VkDescriptorPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.maxSets = mips + 2;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    if (vkCreateDescriptorPool(device.get(), &poolInfo, nullptr, &pool) != VK_SUCCESS) {
+        throw std::runtime_error("EnvironmentLighting: create descriptor pool failed");
+    }
+
+    std::vector<VkDescriptorSetLayout> setLayouts(mips, prefilterSetLayout);
+    setLayouts.push_back(irradianceSetLayout);
+    setLayouts.push_back(lutSetLayout);
+    std::vector<VkDescriptorSet> sets(setLayouts.size());
+    VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocInfo.descriptorPool = pool;
+    allocInfo.descriptorSetCount = static_cast<uint32_t>(sets.size());
+    allocInfo.pSetLayouts = setLayouts.data();
+    if (vkAllocateDescriptorSets(device.get(), &allocInfo, sets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("EnvironmentLighting: allocate descriptor sets failed");
+    }
+    VkDescriptorSet irradianceSet = sets[mips];
+    VkDescriptorSet lutSet = sets[mips + 1];
+
+    // Each prefilter dispatch writes one mip through a 2D-array view of it
+    std::vector<VkImageView> mipViews(mips);
+    for (uint32_t mip = 0; mip < mips; ++mip) {
+        mipViews[mip] = createView(device, m_specular.image, VK_IMAGE_VIEW_TYPE_2D_ARRAY, mip, 1, 6);
+    }
+
+    VkDescriptorImageInfo sourceInfo{ source.sampler(), source.view(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    std::vector<VkDescriptorImageInfo> mipInfos(mips);
+    VkDescriptorImageInfo lutInfo{ VK_NULL_HANDLE, m_brdfLut.view, VK_IMAGE_LAYOUT_GENERAL };
+    VkDescriptorBufferInfo irradianceInfo{ m_irradiance.get(), 0, kIrradianceBufferSize };
+
+    std::vector<VkWriteDescriptorSet> writes;
+    auto addWrite = [&writes](VkDescriptorSet set, uint32_t binding, VkDescriptorType type,
+                              const VkDescriptorImageInfo* image, const VkDescriptorBufferInfo* buffer) {
+        VkWriteDescriptorSet write{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        write.dstSet = set;
+        write.dstBinding = binding;
+        write.descriptorCount = 1;
+        write.descriptorType = type;
+        write.pImageInfo = image;
+        write.pBufferInfo = buffer;
+        writes.push_back(write);
+    };
+    for (uint32_t mip = 0; mip < mips; ++mip) {
+        mipInfos[mip] = { VK_NULL_HANDLE, mipViews[mip], VK_IMAGE_LAYOUT_GENERAL };
+        addWrite(sets[mip], 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, &sourceInfo, nullptr);
+        addWrite(sets[mip], 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &mipInfos[mip], nullptr);
+    }
+    addWrite(irradianceSet, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, &sourceInfo, nullptr);
+    addWrite(irradianceSet, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, nullptr, &irradianceInfo);
+    addWrite(lutSet, 0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &lutInfo, nullptr);
+    vkUpdateDescriptorSets(device.get(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+    // ---- Dispatches ----
+    VkCommandBuffer cmd = beginSingleTimeCommands(device, commandPool);
+
+    for (VkImage image : { m_specular.image, m_brdfLut.image }) {
+        transition(cmd, image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+                   0, VK_ACCESS_SHADER_WRITE_BIT,
+                   VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    }
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, prefilterPipeline);
+    for (uint32_t mip = 0; mip < mips; ++mip) {
+        PrefilterParams params{};
+        params.roughness = mips > 1 ? static_cast<float>(mip) / static_cast<float>(mips - 1) : 0.0f;
+        params.mipSize = std::max(m_options.specularSize >> mip, 1u);
+        params.sourceSize = source.faceSize();
+        params.sampleCount = m_options.specularSamples;
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, prefilterLayout.get(), 0, 1, &sets[mip], 0, nullptr);
+        vkCmdPushConstants(cmd, prefilterLayout.get(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+        vkCmdDispatch(cmd, groupCount(params.mipSize), groupCount(params.mipSize), 6);
+    }
+
+    IrradianceParams irradianceParams{};
+    irradianceParams.faceSize = std::min(kIrradianceFaceSize, source.faceSize());
+    irradianceParams.sourceLod = std::log2(static_cast<float>(source.faceSize()) /
+                                           static_cast<float>(irradianceParams.faceSize));
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, irradiancePipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, irradianceLayout.get(), 0, 1, &irradianceSet, 0, nullptr);
+    vkCmdPushConstants(cmd, irradianceLayout.get(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(irradianceParams),
+                       &irradianceParams);
+    vkCmdDispatch(cmd, 1, 1, 1);
+
+    BrdfLutParams lutParams{ m_options.brdfLutSize, m_options.brdfLutSamples };
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, lutPipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, lutLayout.get(), 0, 1, &lutSet, 0, nullptr);
+    vkCmdPushConstants(cmd, lutLayout.get(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(lutParams), &lutParams);
+    vkCmdDispatch(cmd, groupCount(lutParams.size), groupCount(lutParams.size), 1);
+
+    for (VkImage image : { m_specular.image, m_brdfLut.image }) {
+        transition(cmd, image, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                   VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                   VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+    }
+    VkMemoryBarrier shBarrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    shBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    shBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                         0, 1, &shBarrier, 0, nullptr, 0, nullptr);
+
+    endSingleTimeCommands(device, cmd, commandPool, queue);
+
+    // ---- Bake-only objects ----
+    for (VkImageView view : mipViews) {
+        vkDestroyImageView(device.get(), view, nullptr);
+    }
+    vkDestroyDescriptorPool(device.get(), pool, nullptr);
+    for (VkPipeline pipeline : { prefilterPipeline, irradiancePipeline, lutPipeline }) {
+        vkDestroyPipeline(device.get(), pipeline, nullptr);
+    }
+    prefilterLayout.destroy(device);
+    irradianceLayout.destroy(device);
+    lutLayout.destroy(device);
+    for (VkDescriptorSetLayout layout : { prefilterSetLayout, irradianceSetLayout, lutSetLayout }) {
+        vkDestroyDescriptorSetLayout(device.get(), layout, nullptr);
+    }
+}
+
+// ============================================================================
+// Disk Cache
+// ============================================================================
+
+VkDeviceSize EnvironmentLighting::imageBytes() const {
+    VkDeviceSize bytes = VkDeviceSize(m_options.brdfLutSize) * m_options.brdfLutSize * kTexelBytes;
+    for (uint32_t mip = 0; mip < m_options.specularMipLevels; ++mip) {
+        VkDeviceSize size = std::max(m_options.specularSize >> mip, 1u);
+        bytes += size * size * kTexelBytes * 6;
+    }
+    return bytes;
+}
+
+void EnvironmentLighting::recordImageCopies(VkCommandBuffer cmd, VkBuffer staging, bool upload) const {
+    VkImageLayout copyLayout = upload ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL : VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    VkAccessFlags copyAccess = upload ? VK_ACCESS_TRANSFER_WRITE_BIT : VK_ACCESS_TRANSFER_READ_BIT;
+    VkImageLayout oldLayout = upload ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    VkAccessFlags oldAccess = upload ? VkAccessFlags{ 0 } : VkAccessFlags{ VK_ACCESS_SHADER_READ_BIT };
+    VkPipelineStageFlags oldStage = upload ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+    std::vector<VkBufferImageCopy> specularRegions;
+    VkBufferImageCopy lutRegion{};
+    lutRegion.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    lutRegion.imageExtent = { m_options.brdfLutSize, m_options.brdfLutSize, 1 };
+    VkDeviceSize offset = VkDeviceSize(m_options.brdfLutSize) * m_options.brdfLutSize * kTexelBytes;
+    for (uint32_t mip = 0; mip < m_options.specularMipLevels; ++mip) {
+        uint32_t size = std::max(m_options.specularSize >> mip, 1u);
+        VkBufferImageCopy region{};
+        region.bufferOffset = offset;
+        region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, mip, 0, 6 };
+        region.imageExtent = { size, size, 1 };
+        specularRegions.push_back(region);
+        offset += VkDeviceSize(size) * size * kTexelBytes * 6;
+    }
+
+    for (VkImage image : { m_specular.image, m_brdfLut.image }) {
+        transition(cmd, image, oldLayout, copyLayout, oldAccess, copyAccess, oldStage, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    }
+    if (upload) {
+        vkCmdCopyBufferToImage(cmd, staging, m_brdfLut.image, copyLayout, 1, &lutRegion);
+        vkCmdCopyBufferToImage(cmd, staging, m_specular.image, copyLayout,
+                               static_cast<uint32_t>(specularRegions.size()), specularRegions.data());
+    } else {
+        vkCmdCopyImageToBuffer(cmd, m_brdfLut.image, copyLayout, staging, 1, &lutRegion);
+        vkCmdCopyImageToBuffer(cmd, m_specular.image, copyLayout, staging,
+                               static_cast<uint32_t>(specularRegions.size()), specularRegions.data());
+    }
+    for (VkImage image : { m_specular.image, m_brdfLut.image }) {
+        transition(cmd, image, copyLayout, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                   copyAccess, VK_ACCESS_SHADER_READ_BIT,
+                   VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+    }
+    if (!upload) {
+        VkMemoryBarrier hostBarrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+        hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                             0, 1, &hostBarrier, 0, nullptr, 0, nullptr);
+    }
+}
+
+bool EnvironmentLighting::loadFromCache(const Device& device, VkCommandPool commandPool, VkQueue queue,
+                                        const std::string& path, uint64_t sourceKey, uint32_t sourceFaceSize) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    CacheHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+        header.version != kCacheVersion ||
+        header.specularSize != m_options.specularSize ||
+        header.specularMipLevels != m_options.specularMipLevels ||
+        header.specularSamples != m_options.specularSamples ||
+        header.brdfLutSize != m_options.brdfLutSize ||
+        header.brdfLutSamples != m_options.brdfLutSamples) {
+        std::cout << "IBL: discarding " << path << " (different bake settings)" << std::endl;
+        return false;
+    }
+    if (header.sourceKey != sourceKey || header.sourceFaceSize != sourceFaceSize) {
+        std::cout << "IBL: discarding " << path << " (baked from a different environment map)" << std::endl;
+        return false;
+    }
+
+    float irradiance[9 * 4];
+    file.read(reinterpret_cast<char*>(irradiance), sizeof(irradiance));
+
+    Buffer staging;
+    staging.createAndMap(device, imageBytes(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    file.read(static_cast<char*>(staging.mappedPtrRaw()), static_cast<std::streamsize>(imageBytes()));
+    if (!file) {
+        staging.destroy(device);
+        std::cout << "IBL: discarding " << path << " (truncated)" << std::endl;
+        return false;
+    }
+
+    std::memcpy(m_irradiance.mappedPtrRaw(), irradiance, sizeof(irradiance));
+
+    VkCommandBuffer cmd = beginSingleTimeCommands(device, commandPool);
+    recordImageCopies(cmd, staging.get(), true);
+    endSingleTimeCommands(device, cmd, commandPool, queue);
+    staging.destroy(device);
+    return true;
+}
+
+void EnvironmentLighting::saveToCache(const Device& device, VkCommandPool commandPool, VkQueue queue,
+                                      const std::string& path, uint64_t sourceKey, uint32_t sourceFaceSize) const {
+    Buffer staging;
+    staging.createAndMap(device, imageBytes(), VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    VkCommandBuffer cmd = beginSingleTimeCommands(device, commandPool);
+    recordImageCopies(cmd, staging.get(), false);
+    endSingleTimeCommands(device, cmd, commandPool, queue);
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_options.cacheDirectory, ec);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Warning: could not write IBL cache " << path << std::endl;
+        staging.destroy(device);
+        return;
+    }
+
+    CacheHeader header{};
+    std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+    header.version = kCacheVersion;
+    header.specularSize = m_options.specularSize;
+    header.specularMipLevels = m_options.specularMipLevels;
+    header.specularSamples = m_options.specularSamples;
+    header.brdfLutSize = m_options.brdfLutSize;
+    header.brdfLutSamples = m_options.brdfLutSamples;
+    header.sourceFaceSize = sourceFaceSize;
+    header.sourceKey = sourceKey;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(static_cast<const char*>(m_irradiance.mappedPtrRaw()), static_cast<std::streamsize>(kIrradianceBufferSize));
+    file.write(static_cast<const char*>(staging.mappedPtrRaw()), static_cast<std::streamsize>(imageBytes()));
+    staging.destroy(device);
+}
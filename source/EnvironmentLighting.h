@@ -0,0 +1,95 @@
+#pragma once
+#include "Buffer.h"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Device;
+class Cubemap;
+class PipelineCache;
+
+// ============================================================================
+// Environment Lighting
+// Split-sum image-based lighting, baked once from the environment cubemap by
+// compute shaders:
+//   - a GGX-prefiltered specular cube; mip m holds perceptual roughness
+//     m / (levels - 1)
+//   - diffuse irradiance as nine SH coefficients, already convolved with the
+//     clamped cosine and divided by pi, so shading only multiplies by albedo
+//   - a BRDF LUT with the split-sum scale and bias for (N.V, roughness)
+// Results are cached on disk, keyed by a hash of the source face files, and
+// later runs only upload them.
+// ============================================================================
+
+struct EnvironmentLightingOptions {
+    bool useDiskCache = true;
+    std::string cacheDirectory = "cache/ibl";
+    uint32_t specularSize = 256;        // face size of prefiltered mip 0
+    uint32_t specularMipLevels = 6;     // 256 .. 8; the last mip is roughness 1
+    uint32_t specularSamples = 512;
+    uint32_t brdfLutSize = 256;
+    uint32_t brdfLutSamples = 1024;
+};
+
+class EnvironmentLighting {
+public:
+    struct BakeShaders {
+        VkShaderModule prefilter = VK_NULL_HANDLE;
+        VkShaderModule irradiance = VK_NULL_HANDLE;
+        VkShaderModule brdfLut = VK_NULL_HANDLE;
+    };
+
+    // Load the bake for `sourceKey` from the disk cache, or bake it from
+    // `source` (sampled through its own sampler) and save it. A zero key
+    // bypasses the cache.
+    void create(const Device& device,
+                VkCommandPool commandPool,
+                VkQueue queue,
+                PipelineCache& pipelineCache,
+                const Cubemap& source,
+                uint64_t sourceKey,
+                const BakeShaders& shaders,
+                const EnvironmentLightingOptions& options = {});
+    void destroy(const Device& device);
+
+    // FNV-1a over the contents of the files, in order; 0 if one cannot be read
+    static uint64_t hashFiles(const std::vector<std::string>& paths);
+
+    // Both images use sampler(): linear, clamp to edge, all mips
+    VkImageView specularView() const { return m_specular.view; }
+    VkImageView brdfLutView() const { return m_brdfLut.view; }
+    VkSampler sampler() const { return m_sampler; }
+
+    // vec4[9] (rgb used), usable as a uniform buffer
+    VkBuffer irradianceBuffer() const { return m_irradiance.get(); }
+    static constexpr VkDeviceSize kIrradianceBufferSize = 9 * 4 * sizeof(float);
+
+private:
+    struct Image {
+        VkImage image = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+    };
+
+    void createTargets(const Device& device);
+    void bake(const Device& device, VkCommandPool commandPool, VkQueue queue, PipelineCache& pipelineCache,
+              const Cubemap& source, const BakeShaders& shaders);
+
+    // Staging layout shared by the cache upload and readback: LUT, then the
+    // specular mips from largest to smallest, six faces each
+    VkDeviceSize imageBytes() const;
+    void recordImageCopies(VkCommandBuffer cmd, VkBuffer staging, bool upload) const;
+
+    // The file must have been written for the same source (key and face size)
+    bool loadFromCache(const Device& device, VkCommandPool commandPool, VkQueue queue, const std::string& path,
+                       uint64_t sourceKey, uint32_t sourceFaceSize);
+    void saveToCache(const Device& device, VkCommandPool commandPool, VkQueue queue, const std::string& path,
+                     uint64_t sourceKey, uint32_t sourceFaceSize) const;
+
+    EnvironmentLightingOptions m_options;
+    Image m_specular;       // cube, RGBA16F
+    Image m_brdfLut;        // 2D, RGBA16F (rg used)
+    Buffer m_irradiance;    // host visible, written by the bake or the cache
+    VkSampler m_sampler = VK_NULL_HANDLE;
+};
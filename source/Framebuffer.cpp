@@ -1,12 +1,13 @@
 #include "Framebuffer.h"
+#include "DeletionQueue.h"
 #include "Utilities.h"
 #include <array>
 #include <stdexcept>
 
 void Framebuffer::createColorResources(const Device& device, VkFormat colorFormat, VkSampleCountFlagBits msaa, VkExtent2D extent)
 {
-    createImage(device, extent.width, extent.height, 1, msaa, colorFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_colorImage, m_colorImageMemory);
-    m_colorImageView = createImageView(device, m_colorImage, colorFormat, VK_IMAGE_ASPECT_COLOR_BIT, 1);
+    createImage(device, extent.width, extent.height, 1, msaa, colorFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_color.image, m_color.memory);
+    m_color.view = createImageView(device, m_color.image, colorFormat, VK_IMAGE_ASPECT_COLOR_BIT, 1);
 }
 
 void Framebuffer::createDepthResources(const Device& device, VkFormat depthFormat, VkSampleCountFlagBits msaa, VkExtent2D extent)
@@ -15,41 +16,56 @@ void Framebuffer::createDepthResources(const Device& device, VkFormat depthForma
         depthFormat, VK_IMAGE_TILING_OPTIMAL,
         VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        m_depthImage, m_depthImageMemory);
-    m_depthImageView = createImageView(device, m_depthImage, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, 1);
+        m_depth.image, m_depth.memory);
+    m_depth.view = createImageView(device, m_depth.image, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, 1);
 }
 
-bool hasStencilComponent(VkFormat format) {
-    return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
+void Framebuffer::createOitResources(const Device& device, VkSampleCountFlagBits msaa, VkExtent2D extent)
+{
+    // Written and read back within the render pass only
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                              VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+    createImage(device, extent.width, extent.height, 1, msaa, RenderPass::kOitAccumFormat, VK_IMAGE_TILING_OPTIMAL,
+        usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_oitAccum.image, m_oitAccum.memory);
+    m_oitAccum.view = createImageView(device, m_oitAccum.image, RenderPass::kOitAccumFormat, VK_IMAGE_ASPECT_COLOR_BIT, 1);
+
+    createImage(device, extent.width, extent.height, 1, msaa, RenderPass::kOitRevealageFormat, VK_IMAGE_TILING_OPTIMAL,
+        usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_oitRevealage.image, m_oitRevealage.memory);
+    m_oitRevealage.view = createImageView(device, m_oitRevealage.image, RenderPass::kOitRevealageFormat,
+        VK_IMAGE_ASPECT_COLOR_BIT, 1);
 }
 
-void Framebuffer::destroyColorResources(const Device& device)
-{
-    vkDestroyImageView(device.get(), m_colorImageView, nullptr);
-    vkDestroyImage(device.get(), m_colorImage, nullptr);
-    vkFreeMemory(device.get(), m_colorImageMemory, nullptr);
+bool hasStencilComponent(VkFormat format) {
+    return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
 }
 
-void Framebuffer::destroyDepthResources(const Device& device)
+void Framebuffer::destroyAttachment(VkDevice device, const Attachment& attachment)
 {
-    vkDestroyImageView(device.get(), m_depthImageView, nullptr);
-    vkDestroyImage(device.get(), m_depthImage, nullptr);
-    vkFreeMemory(device.get(), m_depthImageMemory, nullptr);
+    vkDestroyImageView(device, attachment.view, nullptr);
+    vkDestroyImage(device, attachment.image, nullptr);
+    vkFreeMemory(device, attachment.memory, nullptr);
 }
 
-void Framebuffer::create(const Device& device, const Swapchain& swapchain, const RenderPass& renderPass)
+void Framebuffer::createAttachments(const Device& device, const Swapchain& swapchain)
 {
     createColorResources(device, swapchain.imageFormat(), swapchain.msaa(), swapchain.extent());
 
     VkFormat depthFormat = findDepthFormat(device);
     createDepthResources(device, depthFormat, swapchain.msaa(), swapchain.extent());
+    createOitResources(device, swapchain.msaa(), swapchain.extent());
+    m_extent = swapchain.extent();
+}
 
+void Framebuffer::createFramebuffers(const Device& device, const Swapchain& swapchain, const RenderPass& renderPass)
+{
     m_framebuffers.resize(swapchain.imageViews().size());
     for (size_t i = 0; i < swapchain.imageViews().size(); i++) {
-        std::array<VkImageView, 3> attachments = {
-            m_colorImageView,
-            m_depthImageView,
-            swapchain.imageViews()[i]
+        std::array<VkImageView, 5> attachments = {
+            m_color.view,
+            m_depth.view,
+            swapchain.imageViews()[i],
+            m_oitAccum.view,
+            m_oitRevealage.view
         };
 
         VkFramebufferCreateInfo framebufferInfo{};
@@ -67,10 +83,52 @@ void Framebuffer::create(const Device& device, const Swapchain& swapchain, const
     }
 }
 
+void Framebuffer::create(const Device& device, const Swapchain& swapchain, const RenderPass& renderPass)
+{
+    createAttachments(device, swapchain);
+    createFramebuffers(device, swapchain, renderPass);
+}
+
+bool Framebuffer::recreate(const Device& device, const Swapchain& swapchain, const RenderPass& renderPass,
+                           DeletionQueue& deletionQueue, uint64_t retireValue)
+{
+    VkDevice handle = device.get();
+    std::vector<VkFramebuffer> oldFramebuffers = std::move(m_framebuffers);
+    m_framebuffers.clear();
+    deletionQueue.push(retireValue, [handle, oldFramebuffers]() {
+        for (VkFramebuffer framebuffer : oldFramebuffers) {
+            vkDestroyFramebuffer(handle, framebuffer, nullptr);
+        }
+    });
+
+    // The swapchain can be recreated at the same size (suboptimal, present
+    // mode or transform changes); the attachments only depend on the extent
+    bool resized = swapchain.extent().width != m_extent.width || swapchain.extent().height != m_extent.height;
+    if (resized) {
+        std::array<Attachment, 4> oldAttachments = { m_color, m_depth, m_oitAccum, m_oitRevealage };
+        deletionQueue.push(retireValue, [handle, oldAttachments]() {
+            for (const Attachment& attachment : oldAttachments) {
+                destroyAttachment(handle, attachment);
+            }
+        });
+        createAttachments(device, swapchain);
+    }
+
+    createFramebuffers(device, swapchain, renderPass);
+    return resized;
+}
+
 void Framebuffer::destroy(const Device& device)
 {
-    destroyColorResources(device);
-    destroyDepthResources(device);
+    destroyAttachment(device.get(), m_color);
+    destroyAttachment(device.get(), m_depth);
+    destroyAttachment(device.get(), m_oitAccum);
+    destroyAttachment(device.get(), m_oitRevealage);
+    m_color = {};
+    m_depth = {};
+    m_oitAccum = {};
+    m_oitRevealage = {};
+    m_extent = {};
 
     for (auto framebuffer : m_framebuffers) {
         vkDestroyFramebuffer(device.get(), framebuffer, nullptr);
@@ -3,24 +3,44 @@
 #include "Device.h"
 #include "Swapchain.h"
 #include "RenderPass.h"
+#include <cstdint>
 #include <vector>
 
+class DeletionQueue;
+
 class Framebuffer {
 public:
     void create(const Device& device, const Swapchain& swapchain, const RenderPass& renderPass);
     void destroy(const Device& device);
+
+    // After Swapchain::recreate: new framebuffers for the new image views, new
+    // attachments only if the extent changed. The old objects are destroyed
+    // through `deletionQueue` at `retireValue`. Returns whether the attachments
+    // (and so the OIT views) changed.
+    bool recreate(const Device& device, const Swapchain& swapchain, const RenderPass& renderPass,
+                  DeletionQueue& deletionQueue, uint64_t retireValue);
+
     std::vector<VkFramebuffer> get() const { return m_framebuffers; }
+    VkImageView oitAccumView() const { return m_oitAccum.view; }
+    VkImageView oitRevealageView() const { return m_oitRevealage.view; }
 private:
+    struct Attachment {
+        VkImage image = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+    };
+
     std::vector<VkFramebuffer> m_framebuffers;
-    VkImage m_colorImage;
-    VkDeviceMemory m_colorImageMemory;
-    VkImageView m_colorImageView;
-    VkImage m_depthImage;
-    VkDeviceMemory m_depthImageMemory;
-    VkImageView m_depthImageView;
+    Attachment m_color;
+    Attachment m_depth;
+    Attachment m_oitAccum;
+    Attachment m_oitRevealage;
+    VkExtent2D m_extent{};
+    void createAttachments(const Device& device, const Swapchain& swapchain);
+    void createFramebuffers(const Device& device, const Swapchain& swapchain, const RenderPass& renderPass);
     void createColorResources(const Device& device, VkFormat colorFormat, VkSampleCountFlagBits msaa, VkExtent2D extent);
     void createDepthResources(const Device& device, VkFormat colorFormat, VkSampleCountFlagBits msaa, VkExtent2D extent);
-    void destroyColorResources(const Device& device);
-    void destroyDepthResources(const Device& device);
+    void createOitResources(const Device& device, VkSampleCountFlagBits msaa, VkExtent2D extent);
+    static void destroyAttachment(VkDevice device, const Attachment& attachment);
 };
 
@@ -1,14 +1,15 @@
 #include "GltfDescriptors.h"
+#include "BindlessTextureHeap.h"
 #include <stdexcept>
 
 // ============================================================================
 // GltfDescriptorSetLayouts Implementation
 // ============================================================================
 
-void GltfDescriptorSetLayouts::create(const Device& device) {
+void GltfDescriptorSetLayouts::create(const Device& device, VkDescriptorSetLayout texturesLayout) {
     createPerFrameLayout(device);
     createPerModelLayout(device);
-    createTexturesLayout(device);
+    m_texturesLayout = texturesLayout;
     createEnvironmentLayout(device);
 }
 
@@ -21,10 +22,7 @@ void GltfDescriptorSetLayouts::destroy(const Device& device) {
         vkDestroyDescriptorSetLayout(device.get(), m_perModelLayout, nullptr);
         m_perModelLayout = VK_NULL_HANDLE;
     }
-    if (m_texturesLayout != VK_NULL_HANDLE) {
-        vkDestroyDescriptorSetLayout(device.get(), m_texturesLayout, nullptr);
-        m_texturesLayout = VK_NULL_HANDLE;
-    }
+    m_texturesLayout = VK_NULL_HANDLE;
     if (m_environmentLayout != VK_NULL_HANDLE) {
         vkDestroyDescriptorSetLayout(device.get(), m_environmentLayout, nullptr);
         m_environmentLayout = VK_NULL_HANDLE;
@@ -40,10 +38,20 @@ void GltfDescriptorSetLayouts::createPerFrameLayout(const Device& device) {
     uboBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
     uboBinding.pImmutableSamplers = nullptr;
 
+    // Set 0, Binding 1: Texture feedback buffer written by the fragment shader
+    VkDescriptorSetLayoutBinding feedbackBinding{};
+    feedbackBinding.binding = 1;
+    feedbackBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    feedbackBinding.descriptorCount = 1;
+    feedbackBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    feedbackBinding.pImmutableSamplers = nullptr;
+
+    VkDescriptorSetLayoutBinding bindings[] = { uboBinding, feedbackBinding };
+
     VkDescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = 1;
-    layoutInfo.pBindings = &uboBinding;
+    layoutInfo.bindingCount = 2;
+    layoutInfo.pBindings = bindings;
 
     if (vkCreateDescriptorSetLayout(device.get(), &layoutInfo, nullptr, &m_perFrameLayout) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create glTF per-frame descriptor set layout");
@@ -79,38 +87,27 @@ void GltfDescriptorSetLayouts::createPerModelLayout(const Device& device) {
     }
 }
 
-void GltfDescriptorSetLayouts::createTexturesLayout(const Device& device) {
-    // Set 2, Binding 0: Array of texture samplers (up to 32)
-    VkDescriptorSetLayoutBinding textureArrayBinding{};
-    textureArrayBinding.binding = 0;
-    textureArrayBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    textureArrayBinding.descriptorCount = 32;  // Support up to 32 textures
-    textureArrayBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-    textureArrayBinding.pImmutableSamplers = nullptr;
-
-    VkDescriptorSetLayoutCreateInfo layoutInfo{};
-    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = 1;
-    layoutInfo.pBindings = &textureArrayBinding;
-
-    if (vkCreateDescriptorSetLayout(device.get(), &layoutInfo, nullptr, &m_texturesLayout) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create glTF textures descriptor set layout");
-    }
-}
-
 void GltfDescriptorSetLayouts::createEnvironmentLayout(const Device& device) {
-    // Set 3, Binding 0: Environment cubemap for IBL
-    VkDescriptorSetLayoutBinding cubemapBinding{};
-    cubemapBinding.binding = 0;
-    cubemapBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    cubemapBinding.descriptorCount = 1;
-    cubemapBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-    cubemapBinding.pImmutableSamplers = nullptr;
+    // Set 3: Binding 0 = prefiltered specular cube, Binding 1 = BRDF LUT,
+    // Binding 2 = SH9 irradiance (see EnvironmentLighting)
+    VkDescriptorSetLayoutBinding bindings[3]{};
+    const VkDescriptorType types[3] = {
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+    };
+    for (uint32_t i = 0; i < 3; ++i) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = types[i];
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        bindings[i].pImmutableSamplers = nullptr;
+    }
 
     VkDescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = 1;
-    layoutInfo.pBindings = &cubemapBinding;
+    layoutInfo.bindingCount = 3;
+    layoutInfo.pBindings = bindings;
 
     if (vkCreateDescriptorSetLayout(device.get(), &layoutInfo, nullptr, &m_environmentLayout) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create glTF environment descriptor set layout");
@@ -121,33 +118,28 @@ void GltfDescriptorSetLayouts::createEnvironmentLayout(const Device& device) {
 // GltfDescriptorPool Implementation
 // ============================================================================
 
-void GltfDescriptorPool::create(const Device& device, uint32_t maxTextures) {
-    constexpr uint32_t kMaxFramesInFlight = 2;
-
+void GltfDescriptorPool::create(const Device& device, uint32_t framesInFlight, uint32_t maxModels) {
     // Pool sizes for all descriptor types we'll use
-    VkDescriptorPoolSize poolSizes[4];
+    VkDescriptorPoolSize poolSizes[3];
 
-    // Uniform buffers (per-frame UBO)
+    // Uniform buffers (per-frame UBO + environment SH irradiance)
     poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = kMaxFramesInFlight;
+    poolSizes[0].descriptorCount = framesInFlight * 2;
 
-    // Storage buffers (transform + material buffers)
+    // Storage buffers (texture feedback, plus transform + material per model)
     poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    poolSizes[1].descriptorCount = kMaxFramesInFlight * 2;  // 2 storage buffers per frame
+    poolSizes[1].descriptorCount = framesInFlight * (1 + 2 * maxModels);
 
-    // Texture array (one array per frame)
+    // Specular cube + BRDF LUT (material textures live in the bindless heap's pool)
     poolSizes[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[2].descriptorCount = kMaxFramesInFlight * maxTextures;
-
-    // Environment cubemap
-    poolSizes[3].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[3].descriptorCount = kMaxFramesInFlight;
+    poolSizes[2].descriptorCount = framesInFlight * 2;
 
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.poolSizeCount = 4;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    poolInfo.poolSizeCount = 3;
     poolInfo.pPoolSizes = poolSizes;
-    poolInfo.maxSets = kMaxFramesInFlight * 4;  // 4 descriptor sets per frame
+    poolInfo.maxSets = framesInFlight * (2 + maxModels);  // per-frame + environment, set 1 per model
 
     if (vkCreateDescriptorPool(device.get(), &poolInfo, nullptr, &m_pool) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create glTF descriptor pool");
@@ -168,10 +160,10 @@ void GltfDescriptorPool::destroy(const Device& device) {
 void GltfDescriptorSets::allocate(const Device& device,
                                    VkDescriptorPool pool,
                                    const GltfDescriptorSetLayouts& layouts,
+                                   const BindlessTextureHeap& textureHeap,
                                    uint32_t framesInFlight) {
     // Resize vectors to hold one set per frame
     m_perFrameSets.resize(framesInFlight);
-    m_perModelSets.resize(framesInFlight);
     m_texturesSets.resize(framesInFlight);
     m_environmentSets.resize(framesInFlight);
 
@@ -189,32 +181,9 @@ void GltfDescriptorSets::allocate(const Device& device,
         }
     }
 
-    // Allocate per-model sets
-    {
-        std::vector<VkDescriptorSetLayout> setLayouts(framesInFlight, layouts.getPerModelLayout());
-        VkDescriptorSetAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.descriptorPool = pool;
-        allocInfo.descriptorSetCount = framesInFlight;
-        allocInfo.pSetLayouts = setLayouts.data();
-
-        if (vkAllocateDescriptorSets(device.get(), &allocInfo, m_perModelSets.data()) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to allocate glTF per-model descriptor sets");
-        }
-    }
-
-    // Allocate texture sets
-    {
-        std::vector<VkDescriptorSetLayout> setLayouts(framesInFlight, layouts.getTexturesLayout());
-        VkDescriptorSetAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.descriptorPool = pool;
-        allocInfo.descriptorSetCount = framesInFlight;
-        allocInfo.pSetLayouts = setLayouts.data();
-
-        if (vkAllocateDescriptorSets(device.get(), &allocInfo, m_texturesSets.data()) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to allocate glTF texture descriptor sets");
-        }
+    // Texture sets are the heap's per-frame sets
+    for (uint32_t i = 0; i < framesInFlight; ++i) {
+        m_texturesSets[i] = textureHeap.set(i);
     }
 
     // Allocate environment sets
@@ -235,7 +204,24 @@ void GltfDescriptorSets::allocate(const Device& device,
 void GltfDescriptorSets::destroy() {
     // Descriptor sets are automatically freed when the pool is destroyed
     m_perFrameSets.clear();
-    m_perModelSets.clear();
     m_texturesSets.clear();
     m_environmentSets.clear();
 }
+
+std::vector<VkDescriptorSet> GltfDescriptorSets::allocatePerModelSets(const Device& device,
+                                                                      VkDescriptorPool pool,
+                                                                      const GltfDescriptorSetLayouts& layouts,
+                                                                      uint32_t framesInFlight) {
+    std::vector<VkDescriptorSet> sets(framesInFlight);
+    std::vector<VkDescriptorSetLayout> setLayouts(framesInFlight, layouts.getPerModelLayout());
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = pool;
+    allocInfo.descriptorSetCount = framesInFlight;
+    allocInfo.pSetLayouts = setLayouts.data();
+
+    if (vkAllocateDescriptorSets(device.get(), &allocInfo, sets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate glTF per-model descriptor sets");
+    }
+    return sets;
+}
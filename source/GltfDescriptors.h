@@ -8,18 +8,21 @@
 // Manages multiple descriptor set layouts and pools for glTF rendering
 // ============================================================================
 
-// Set 0: Per-frame data (camera, lights)
+// Set 0: Per-frame data (camera, lights) + texture feedback buffer
 // Set 1: Per-model data (transform and material buffers)
-// Set 2: Textures (array of samplers)
-// Set 3: Environment cubemap
+// Set 2: Bindless texture heap (owned by BindlessTextureHeap, shared by all models)
+// Set 3: Environment lighting (prefiltered specular cube, BRDF LUT, SH irradiance)
+
+class BindlessTextureHeap;
 
 class GltfDescriptorSetLayouts {
 public:
     GltfDescriptorSetLayouts() = default;
     ~GltfDescriptorSetLayouts() = default;
 
-    // Create all four descriptor set layouts
-    void create(const Device& device);
+    // Create the per-frame, per-model and environment layouts; set 2 is the
+    // heap's own layout and is not owned here
+    void create(const Device& device, VkDescriptorSetLayout texturesLayout);
     void destroy(const Device& device);
 
     // Accessors for individual layouts
@@ -36,12 +39,11 @@ public:
 private:
     VkDescriptorSetLayout m_perFrameLayout = VK_NULL_HANDLE;       // Set 0
     VkDescriptorSetLayout m_perModelLayout = VK_NULL_HANDLE;       // Set 1
-    VkDescriptorSetLayout m_texturesLayout = VK_NULL_HANDLE;       // Set 2
+    VkDescriptorSetLayout m_texturesLayout = VK_NULL_HANDLE;       // Set 2 (not owned)
     VkDescriptorSetLayout m_environmentLayout = VK_NULL_HANDLE;    // Set 3
 
     void createPerFrameLayout(const Device& device);
     void createPerModelLayout(const Device& device);
-    void createTexturesLayout(const Device& device);
     void createEnvironmentLayout(const Device& device);
 };
 
@@ -50,9 +52,10 @@ public:
     GltfDescriptorPool() = default;
     ~GltfDescriptorPool() = default;
 
-    // Create descriptor pool sized for glTF rendering
-    // maxTextures: maximum number of textures to support (default 32)
-    void create(const Device& device, uint32_t maxTextures = 32);
+    // Create descriptor pool sized for glTF rendering with up to `maxModels`
+    // models loaded at once (textures live in the heap's pool). Sets can be
+    // freed individually, so models come and go without resetting it.
+    void create(const Device& device, uint32_t framesInFlight, uint32_t maxModels);
     void destroy(const Device& device);
 
     VkDescriptorPool get() const { return m_pool; }
@@ -66,25 +69,34 @@ public:
     GltfDescriptorSets() = default;
     ~GltfDescriptorSets() = default;
 
-    // Allocate all descriptor sets from the pool
+    // Allocate the shared descriptor sets from the pool; set 2 is taken from
+    // the heap, set 1 is allocated per model with allocatePerModelSets()
     void allocate(const Device& device,
                   VkDescriptorPool pool,
                   const GltfDescriptorSetLayouts& layouts,
+                  const BindlessTextureHeap& textureHeap,
                   uint32_t framesInFlight);
 
     void destroy();
 
+    // One model's set 1 (transforms + materials), one per frame in flight;
+    // hand them back with vkFreeDescriptorSets when the model is unloaded
+    static std::vector<VkDescriptorSet> allocatePerModelSets(const Device& device,
+                                                             VkDescriptorPool pool,
+                                                             const GltfDescriptorSetLayouts& layouts,
+                                                             uint32_t framesInFlight);
+
     // Get descriptor sets for a specific frame
     VkDescriptorSet getPerFrameSet(uint32_t frameIndex) const { return m_perFrameSets[frameIndex]; }
-    VkDescriptorSet getPerModelSet(uint32_t frameIndex) const { return m_perModelSets[frameIndex]; }
     VkDescriptorSet getTexturesSet(uint32_t frameIndex) const { return m_texturesSets[frameIndex]; }
     VkDescriptorSet getEnvironmentSet(uint32_t frameIndex) const { return m_environmentSets[frameIndex]; }
 
-    // Get all sets for a frame as array (for vkCmdBindDescriptorSets)
-    std::vector<VkDescriptorSet> getAllSets(uint32_t frameIndex) const {
+    // Get all sets for a frame as array (for vkCmdBindDescriptorSets), with
+    // the per-model set of the model being drawn
+    std::vector<VkDescriptorSet> getAllSets(uint32_t frameIndex, VkDescriptorSet perModelSet) const {
         return {
             m_perFrameSets[frameIndex],
-            m_perModelSets[frameIndex],
+            perModelSet,
             m_texturesSets[frameIndex],
             m_environmentSets[frameIndex]
         };
@@ -92,7 +104,6 @@ public:
 
 private:
     std::vector<VkDescriptorSet> m_perFrameSets;       // One per frame in flight
-    std::vector<VkDescriptorSet> m_perModelSets;       // One per frame in flight
-    std::vector<VkDescriptorSet> m_texturesSets;       // One per frame in flight
+    std::vector<VkDescriptorSet> m_texturesSets;       // One per frame in flight (heap sets)
     std::vector<VkDescriptorSet> m_environmentSets;    // One per frame in flight
 };
@@ -34,3 +34,72 @@ GltfMaterial::GltfMaterial() {
 
     name = "default";
 }
+
+MaterialFeatureFlags materialFeatures(const MaterialData& data) {
+    MaterialFeatureFlags features = 0;
+    bool usesUv1 = false;
+    auto useMap = [&](int handle, int texCoord, MaterialFeatureBits bit) {
+        if (handle < 0) return;
+        features |= bit;
+        usesUv1 |= texCoord != 0;
+    };
+
+    useMap(data.baseColorTextureIndex, data.baseColorTexCoord, MATERIAL_FEATURE_BASE_COLOR_MAP);
+    useMap(data.normalTextureIndex, data.normalTexCoord, MATERIAL_FEATURE_NORMAL_MAP);
+    useMap(data.metallicRoughnessTextureIndex, data.metallicRoughnessTexCoord, MATERIAL_FEATURE_METALLIC_ROUGHNESS_MAP);
+
+    // Zero strength leaves ao at 1, so the map is never read
+    if (data.occlusionTextureIndex >= 0 && data.occlusionStrength != 0.0f) {
+        bool packed = data.occlusionTextureIndex == data.metallicRoughnessTextureIndex &&
+                      data.occlusionTexCoord == data.metallicRoughnessTexCoord;
+        useMap(data.occlusionTextureIndex, data.occlusionTexCoord,
+               packed ? MATERIAL_FEATURE_OCCLUSION_PACKED : MATERIAL_FEATURE_OCCLUSION_MAP);
+    }
+
+    // An emissive map only matters when the factor it is multiplied by is non-zero
+    if (glm::any(glm::notEqual(glm::vec3(data.emissiveFactor), glm::vec3(0.0f)))) {
+        features |= MATERIAL_FEATURE_EMISSIVE;
+        useMap(data.emissiveTextureIndex, data.emissiveTexCoord, MATERIAL_FEATURE_EMISSIVE_MAP);
+    }
+
+    if (data.alphaMode == static_cast<int>(AlphaMode::Mask)) {
+        features |= MATERIAL_FEATURE_ALPHA_MASK;
+    } else if (data.alphaMode == static_cast<int>(AlphaMode::Blend)) {
+        features |= MATERIAL_FEATURE_ALPHA_BLEND;
+    }
+    if (usesUv1) {
+        features |= MATERIAL_FEATURE_UV1;
+    }
+    if (data.doubleSided != 0) {
+        features |= MATERIAL_FEATURE_DOUBLE_SIDED;
+    }
+    return features;
+}
+
+std::string materialFeatureName(MaterialFeatureFlags features) {
+    static const struct {
+        MaterialFeatureBits bit;
+        const char* label;
+    } kLabels[] = {
+        { MATERIAL_FEATURE_BASE_COLOR_MAP, "BC" },
+        { MATERIAL_FEATURE_NORMAL_MAP, "N" },
+        { MATERIAL_FEATURE_METALLIC_ROUGHNESS_MAP, "MR" },
+        { MATERIAL_FEATURE_OCCLUSION_MAP, "AO" },
+        { MATERIAL_FEATURE_OCCLUSION_PACKED, "ORM" },
+        { MATERIAL_FEATURE_EMISSIVE, "E" },
+        { MATERIAL_FEATURE_EMISSIVE_MAP, "EM" },
+        { MATERIAL_FEATURE_ALPHA_MASK, "MASK" },
+        { MATERIAL_FEATURE_ALPHA_BLEND, "BLEND" },
+        { MATERIAL_FEATURE_UV1, "UV1" },
+        { MATERIAL_FEATURE_DOUBLE_SIDED, "2S" },
+    };
+
+    std::string name;
+    for (const auto& entry : kLabels) {
+        if (features & entry.bit) {
+            if (!name.empty()) name += '+';
+            name += entry.label;
+        }
+    }
+    return name.empty() ? "untextured" : name;
+}
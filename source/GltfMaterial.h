@@ -1,5 +1,6 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <string>
 
 // ============================================================================
@@ -23,7 +24,7 @@ struct MaterialData {
     int doubleSided;                 // 0=false, 1=true (default: 0)
     int padding;                     // Alignment padding
 
-    // Texture indices into texture array (-1 = no texture)
+    // glTF texture indices (-1 = no texture); the GPU copy holds bindless heap handles
     int baseColorTextureIndex;       // Base color (albedo) texture index
     int metallicRoughnessTextureIndex; // Metallic-roughness texture index
     int normalTextureIndex;          // Normal map texture index
@@ -40,13 +41,46 @@ struct MaterialData {
     int padding3;                    // Padding
 };
 
-// Alpha blend modes
+// Alpha blend modes; also the render pass order (opaque, then alpha-tested,
+// then blended)
 enum class AlphaMode {
     Opaque = 0,
     Mask = 1,
     Blend = 2
 };
 
+// Material features that select a gltf.frag permutation through the
+// MATERIAL_FEATURES specialization constant (bits must match the shader).
+// Anything a material does not use is compiled out of its pipeline.
+enum MaterialFeatureBits : uint32_t {
+    MATERIAL_FEATURE_BASE_COLOR_MAP         = 1u << 0,
+    MATERIAL_FEATURE_NORMAL_MAP             = 1u << 1,
+    MATERIAL_FEATURE_METALLIC_ROUGHNESS_MAP = 1u << 2,
+    MATERIAL_FEATURE_OCCLUSION_MAP          = 1u << 3,  // separate occlusion texture
+    MATERIAL_FEATURE_OCCLUSION_PACKED       = 1u << 4,  // occlusion in the metallic-roughness R channel
+    MATERIAL_FEATURE_EMISSIVE               = 1u << 5,  // non-zero emissive factor
+    MATERIAL_FEATURE_EMISSIVE_MAP           = 1u << 6,
+    MATERIAL_FEATURE_ALPHA_MASK             = 1u << 7,
+    MATERIAL_FEATURE_ALPHA_BLEND            = 1u << 8,
+    MATERIAL_FEATURE_UV1                    = 1u << 9,  // some texture reads TEXCOORD_1
+    MATERIAL_FEATURE_DOUBLE_SIDED           = 1u << 10, // no culling, back faces flip the normal
+};
+using MaterialFeatureFlags = uint32_t;
+
+// Features of material data as the shader sees it (texture indices are heap
+// handles, -1 = none)
+MaterialFeatureFlags materialFeatures(const MaterialData& data);
+
+// Short label for logs and pipeline names, e.g. "BC+N+ORM+MASK"
+std::string materialFeatureName(MaterialFeatureFlags features);
+
+// Pass a material variant draws in
+inline AlphaMode featureAlphaMode(MaterialFeatureFlags features) {
+    if (features & MATERIAL_FEATURE_ALPHA_BLEND) return AlphaMode::Blend;
+    if (features & MATERIAL_FEATURE_ALPHA_MASK) return AlphaMode::Mask;
+    return AlphaMode::Opaque;
+}
+
 // CPU-side material with texture references
 class GltfMaterial {
 public:
@@ -67,6 +101,9 @@ public:
     int occlusionTexCoord = 0;
     int emissiveTexCoord = 0;
 
+    // Shader permutation this material renders with (set by GltfModel)
+    MaterialFeatureFlags features = 0;
+
     // Material name (for debugging)
     std::string name;
 
@@ -8,6 +8,14 @@ void GltfMesh::destroy(const Device& device) {
     weights.clear();
 }
 
+void GltfMesh::retire(const Device& device, DeletionQueue& deletionQueue, uint64_t value) {
+    for (auto& primitive : primitives) {
+        primitive.retire(device, deletionQueue, value);
+    }
+    primitives.clear();
+    weights.clear();
+}
+
 uint32_t GltfMesh::getTotalVertexCount() const {
     uint32_t total = 0;
     for (const auto& primitive : primitives) {
@@ -18,8 +18,9 @@ public:
     // Morph target weights (for blend shapes - future use)
     std::vector<float> weights;
 
-    // Destroy all GPU resources
+    // Destroy all GPU resources, now or once the frame timeline reaches `value`
     void destroy(const Device& device);
+    void retire(const Device& device, DeletionQueue& deletionQueue, uint64_t value);
 
     // Check if mesh has any valid primitives
     bool isValid() const { return !primitives.empty(); }
@@ -4,6 +4,7 @@
 // ============================================================================
 
 #include "GltfModel.h"
+#include "TextureFeedback.h"
 #include "Utilities.h"
 
 // Include tinygltf library
@@ -15,24 +16,247 @@
 #include <stdexcept>
 #include <iostream>
 #include <unordered_map>
+#include <map>
 #include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <cstdint>
+#include <limits>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+
+// ============================================================================
+// Helper Functions
+// ============================================================================
+
+namespace {
+
+// Largest top mip of the first streaming step; the full chain follows on a later frame
+constexpr uint32_t kPreviewDimension = 64;
+
+// Added to the upload priority of draws behind the camera, so their textures
+// stream after everything in view
+constexpr float kBehindCameraPriority = 1.0e6f;
+
+// Bound image is a placeholder (or GPU-mipped), so its feedback means nothing
+constexpr uint32_t kUntrackedLevel = 0xFFFFFFFFu;
+
+// Residency summary is logged at most this often, and only after changes
+constexpr uint64_t kResidencyReportFrames = 600;
+
+// FNV-1a over a byte range, used for content-hash deduplication
+uint64_t hashBytes(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Content hash of an encoded image; images tinygltf could not read are only known by path
+uint64_t imageHash(const EncodedImage& image) {
+    return image.bytes.empty()
+        ? hashBytes(image.path.data(), image.path.size())
+        : hashBytes(image.bytes.data(), image.bytes.size());
+}
+
+// Work sizes below which a loop is not worth splitting into jobs
+constexpr size_t kNodesPerJob = 256;
+constexpr size_t kDrawsPerJob = 1024;
+
+// JobSystem::parallelFor, or the whole range inline without a job system
+void parallelFor(JobSystem* jobs, size_t count, size_t grain, const std::function<void(size_t, size_t)>& body,
+                 JobPriority priority = JobPriority::Frame) {
+    if (jobs) {
+        jobs->parallelFor(count, grain, body, priority);
+    } else if (count > 0) {
+        body(0, count);
+    }
+}
+
+// tinygltf image loader that only reads the header and keeps the encoded
+// bytes, so decoding can happen later (and off the render thread)
+bool deferImageDecode(tinygltf::Image* image, const int imageIndex, std::string* err, std::string* /*warn*/,
+                      int /*reqWidth*/, int /*reqHeight*/, const unsigned char* bytes, int size, void* userData) {
+    auto* images = static_cast<std::vector<std::shared_ptr<EncodedImage>>*>(userData);
+
+    int width, height, channels;
+    if (!stbi_info_from_memory(bytes, size, &width, &height, &channels)) {
+        if (err) *err += "Unknown image format for image " + std::to_string(imageIndex) + "\n";
+        return false;
+    }
+
+    auto encoded = std::make_shared<EncodedImage>();
+    encoded->bytes.assign(bytes, bytes + size);
+    encoded->width = static_cast<uint32_t>(width);
+    encoded->height = static_cast<uint32_t>(height);
+    encoded->channels = static_cast<uint32_t>(channels);
+    if (imageIndex >= static_cast<int>(images->size())) images->resize(imageIndex + 1);
+    (*images)[imageIndex] = std::move(encoded);
+
+    image->width = width;
+    image->height = height;
+    image->component = 4;
+    image->bits = 8;
+    image->pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+    return true;
+}
+
+// Neutral 1x1 texel shown until a texture has streamed in; uploaded on
+// `uploadQueue` when given, so a model loaded while frames are in flight
+// does not idle the graphics queue once per texture
+void createPlaceholder(Texture& texture, TextureUsageFlags usage, VkSampler sampler,
+                       const Device& device, VkCommandPool cmdPool, VkQueue queue, AsyncQueue* uploadQueue) {
+    TextureMipLevel texel;
+    texel.width = 1;
+    texel.height = 1;
+    texel.data = { 255, 255, 255, 255 };                              // base color / unused
+    if (usage & TEXTURE_USAGE_NORMAL) {
+        texel.data[0] = 128; texel.data[1] = 128;                     // flat tangent-space normal
+    } else if (usage == TEXTURE_USAGE_EMISSIVE) {
+        texel.data[0] = texel.data[1] = texel.data[2] = 0;            // no emission
+    } else if (usage != 0 && !(usage & TEXTURE_USAGE_BASE_COLOR)) {
+        texel.data[2] = 0;                                            // AO 1, roughness 1, metallic 0
+    }
+    texture.createFromMipChain(device, cmdPool, queue, { texel },
+                               VK_FORMAT_R8G8B8A8_UNORM,
+                               VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT, {}, sampler, uploadQueue);
+}
+
+// Upload levels [firstLevel, end) of a cooked texture
+void uploadCooked(Texture& texture, const CookedTexture& cooked, size_t firstLevel, VkSampler sampler,
+                  const Device& device, VkCommandPool cmdPool, VkQueue queue, MipGenerator* mipGenerator,
+                  AsyncQueue* uploadQueue) {
+    if (cooked.generateMipmapsOnGpu) {
+        const TextureMipLevel& top = cooked.levels[0];
+        texture.createFromPixels(device, cmdPool, queue,
+                                 top.data.data(), top.width, top.height,
+                                 cooked.format, true,
+                                 VK_FILTER_LINEAR,
+                                 VK_SAMPLER_ADDRESS_MODE_REPEAT,
+                                 cooked.components, sampler, mipGenerator);
+    } else if (firstLevel == 0) {
+        texture.createFromMipChain(device, cmdPool, queue,
+                                   cooked.levels, cooked.format,
+                                   VK_FILTER_LINEAR,
+                                   VK_SAMPLER_ADDRESS_MODE_REPEAT,
+                                   cooked.components, sampler, uploadQueue);
+    } else {
+        std::vector<TextureMipLevel> tail(cooked.levels.begin() + firstLevel, cooked.levels.end());
+        texture.createFromMipChain(device, cmdPool, queue,
+                                   tail, cooked.format,
+                                   VK_FILTER_LINEAR,
+                                   VK_SAMPLER_ADDRESS_MODE_REPEAT,
+                                   cooked.components, sampler, uploadQueue);
+    }
+}
+
+uint64_t cookedBytes(const CookedTexture& cooked, size_t firstLevel = 0) {
+    uint64_t bytes = 0;
+    for (size_t l = firstLevel; l < cooked.levels.size(); ++l) bytes += cooked.levels[l].data.size();
+    return bytes;
+}
+
+// First level no larger than kPreviewDimension
+uint32_t previewLevel(const CookedTexture& cooked) {
+    uint32_t level = 0;
+    while (level + 1 < cooked.levels.size() &&
+           std::max(cooked.levels[level].width, cooked.levels[level].height) > kPreviewDimension) {
+        level++;
+    }
+    return level;
+}
+
+// Resident bytes for each possible top level
+std::vector<uint64_t> chainBytes(const CookedTexture& cooked) {
+    std::vector<uint64_t> bytes(cooked.levels.size(), 0);
+    uint64_t total = 0;
+    for (size_t l = cooked.levels.size(); l-- > 0;) {
+        total += cooked.levels[l].data.size();
+        bytes[l] = total;
+    }
+    return bytes;
+}
+
+} // namespace
 
 // ============================================================================
 // Main Loading Function
 // ============================================================================
 
+struct GltfModel::PendingLoad {
+    enum class Stage { TexturePlan, Textures, TextureSlots, Meshes, Buffers };
+
+    tinygltf::Model model;  // buffers are dropped once the geometry is extracted
+    std::vector<std::shared_ptr<EncodedImage>> images;
+    std::vector<TextureUsageFlags> textureUsage;
+
+    struct Primitive {
+        std::vector<GltfVertex> vertices;
+        std::vector<uint32_t> indices;
+        int material = -1;  // glTF material index
+    };
+    std::vector<std::vector<Primitive>> primitives;  // per mesh, freed as they upload
+
+    // First error of the per-mesh extraction jobs, rethrown by parse()
+    std::mutex extractionMutex;
+    std::exception_ptr extractionError;
+
+    // Texture steps. Without streaming, background jobs cook the textures
+    // ahead of their steps, each with its own forked cooker.
+    TextureCooker cooker;
+    std::vector<TextureStreamRequest> requests;
+    std::vector<TextureBudgetEntry> budgetEntries;  // per request
+    std::vector<int> textureRequest;                // per texture: its request, or -1
+    std::vector<TextureCooker> cookers;             // per request, with cook jobs
+    std::vector<StreamedTexture> results;           // per request, without streaming
+    std::vector<JobCounter> cooking;                // per request, with cook jobs
+    std::atomic<bool> cancelled{ false };           // cook jobs not yet started skip their texture
+    size_t texture = 0;                             // next texture to upload or give a placeholder
+
+    Stage stage = Stage::TexturePlan;
+    size_t mesh = 0;        // next primitive to upload
+    size_t primitive = 0;
+    int defaultMaterial = -1;
+};
+
+GltfModel::GltfModel() = default;
+GltfModel::~GltfModel() = default;
+
 void GltfModel::loadFromFile(const Device& device,
                                VkCommandPool cmdPool,
                                VkQueue queue,
-                               const std::string& filename) {
+                               BindlessTextureHeap& textureHeap,
+                               SamplerCache& samplerCache,
+                               MipGenerator* mipGenerator,
+                               AsyncQueue* transferQueue,
+                               const std::string& filename,
+                               const GltfLoadOptions& options,
+                               JobSystem* jobs) {
+    parse(filename, jobs);
+    upload(device, cmdPool, queue, textureHeap, samplerCache, mipGenerator, transferQueue, options, nullptr);
+}
+
+void GltfModel::parse(const std::string& filename, JobSystem* jobs) {
     m_modelPath = filename;
+    m_jobs = jobs;
+    m_pending = std::make_unique<PendingLoad>();
 
     // Parse glTF file using tinygltf
-    tinygltf::Model model;
+    tinygltf::Model& model = m_pending->model;
     tinygltf::TinyGLTF loader;
     std::string err, warn;
 
+    // Keep images encoded; they are decoded by the texture streamer
+    std::vector<std::shared_ptr<EncodedImage>>& images = m_pending->images;
+    loader.SetImageLoader(deferImageDecode, &images);
+
     // Determine if binary (.glb) or ASCII (.gltf)
     bool isBinary = (filename.substr(filename.find_last_of(".") + 1) == "glb");
 
@@ -62,37 +286,203 @@ void GltfModel::loadFromFile(const Device& device,
     std::cout << "  Materials: " << model.materials.size() << std::endl;
     std::cout << "  Textures: " << model.textures.size() << std::endl;
 
-    // First, determine texture usage from materials
-    std::vector<bool> isColorTexture(model.textures.size(), false);
-    std::cout << "Determining texture formats..." << std::endl;
-    for (const auto& gltfMat : model.materials) {
-        // Base color and emissive textures should use SRGB
-        if (gltfMat.pbrMetallicRoughness.baseColorTexture.index >= 0) {
-            int idx = gltfMat.pbrMetallicRoughness.baseColorTexture.index;
-            isColorTexture[idx] = true;
-            std::cout << "  Texture " << idx << " is base color (SRGB)" << std::endl;
+    // Geometry is extracted by per-mesh jobs, and the node hierarchy by a job
+    // that follows them, while the images and materials are worked out here;
+    // the jobs read `model`, so every exit waits for them
+    JobCounter meshesExtracted;
+    JobCounter nodesLoaded;
+    loadMeshes(model, meshesExtracted);
+    auto loadHierarchy = [this, &model] {
+        PendingLoad& pending = *m_pending;
+        try {
+            {
+                std::lock_guard<std::mutex> lock(pending.extractionMutex);
+                if (pending.extractionError) return;
+            }
+            loadNodes(model);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(pending.extractionMutex);
+            if (!pending.extractionError) pending.extractionError = std::current_exception();
         }
-        if (gltfMat.emissiveTexture.index >= 0) {
-            int idx = gltfMat.emissiveTexture.index;
-            isColorTexture[idx] = true;
-            std::cout << "  Texture " << idx << " is emissive (SRGB)" << std::endl;
+    };
+    if (m_jobs) {
+        m_jobs->runAfter(meshesExtracted, loadHierarchy, &nodesLoaded, JobPriority::Background);
+    } else {
+        loadHierarchy();
+    }
+    std::exception_ptr parseError;
+    try {
+        parseImagesAndMaterials(model, baseDir);
+    } catch (...) {
+        parseError = std::current_exception();
+    }
+
+    // The hierarchy job only runs once every mesh job has, so this covers both
+    if (m_jobs) m_jobs->wait(nodesLoaded, JobPriority::Background);
+    if (parseError) {
+        std::rethrow_exception(parseError);
+    }
+    if (m_pending->extractionError) {
+        std::rethrow_exception(m_pending->extractionError);
+    }
+
+    // Geometry is extracted; upload() only needs the document's tables
+    model.buffers.clear();
+    model.buffers.shrink_to_fit();
+}
+
+void GltfModel::parseImagesAndMaterials(const tinygltf::Model& model, const std::string& baseDir) {
+    std::vector<std::shared_ptr<EncodedImage>>& images = m_pending->images;
+
+    // Per image: external files tinygltf could not read are retried from disk
+    // by the streamer (only their header is read here), and every payload is
+    // hashed for deduplication
+    images.resize(model.images.size());
+    std::vector<uint64_t> imageHashes(images.size(), 0);
+    parallelFor(m_jobs, images.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (!images[i] && !model.images[i].uri.empty()) {
+                auto external = std::make_shared<EncodedImage>();
+                external->path = baseDir + model.images[i].uri;
+                int width, height, channels;
+                if (stbi_info(external->path.c_str(), &width, &height, &channels)) {
+                    external->width = static_cast<uint32_t>(width);
+                    external->height = static_cast<uint32_t>(height);
+                    external->channels = static_cast<uint32_t>(channels);
+                    images[i] = std::move(external);
+                } else {
+                    std::cerr << ("Warning: Failed to load external image: " + external->path + "\n");
+                }
+            }
+            if (images[i]) imageHashes[i] = imageHash(*images[i]);
+        }
+    }, JobPriority::Background);
+
+    m_dedup = DedupStats{};
+    deduplicateImages(images, imageHashes);
+
+    // Merge separate occlusion maps into their metallic-roughness texture
+    // (R = occlusion, G = roughness, B = metallic) where materials allow it
+    planOrmPacking(model, images);
+    deduplicateTextures(model, images);
+
+    // First, determine texture usage from materials; the cooker picks the
+    // storage format (sRGB vs linear, BCn, R8/RG8) from these flags
+    std::vector<TextureUsageFlags>& textureUsage = m_pending->textureUsage;
+    textureUsage.assign(model.textures.size(), 0);
+    auto markUsage = [&](int textureIndex, TextureUsageFlags usage) {
+        if (textureIndex >= 0 && textureIndex < static_cast<int>(textureUsage.size())) {
+            textureUsage[textureIndex] |= usage;
+        }
+    };
+    for (const auto& gltfMat : model.materials) {
+        markUsage(gltfMat.pbrMetallicRoughness.baseColorTexture.index, TEXTURE_USAGE_BASE_COLOR);
+        markUsage(gltfMat.emissiveTexture.index, TEXTURE_USAGE_EMISSIVE);
+        markUsage(gltfMat.normalTexture.index, TEXTURE_USAGE_NORMAL);
+        markUsage(gltfMat.pbrMetallicRoughness.metallicRoughnessTexture.index, TEXTURE_USAGE_METALLIC_ROUGHNESS);
+        markUsage(resolveOcclusionTexture(gltfMat.occlusionTexture.index,
+                                          gltfMat.pbrMetallicRoughness.metallicRoughnessTexture.index),
+                  TEXTURE_USAGE_OCCLUSION);
+    }
+
+    // A texture sharing another's image is cooked once, for the union of their uses
+    for (size_t i = 0; i < textureUsage.size(); ++i) {
+        int shared = m_sharedImageTexture[i];
+        if (shared != static_cast<int>(i)) {
+            textureUsage[shared] |= textureUsage[i];
+            textureUsage[i] = 0;
         }
-        // Normal, metallic-roughness, and occlusion textures are NOT color textures (use LINEAR)
     }
 
-    loadTextures(model, device, cmdPool, queue, baseDir, isColorTexture);
-    loadSamplers(model, device);
     loadMaterials(model);
-    loadMeshes(model, device, cmdPool, queue);
-    loadNodes(model);
+}
+
+bool GltfModel::upload(const Device& device,
+                         VkCommandPool cmdPool,
+                         VkQueue queue,
+                         BindlessTextureHeap& textureHeap,
+                         SamplerCache& samplerCache,
+                         MipGenerator* mipGenerator,
+                         AsyncQueue* transferQueue,
+                         const GltfLoadOptions& options,
+                         UploadScheduler* scheduler) {
+    if (!m_pending) return true;
+    PendingLoad& pending = *m_pending;
+
+    // A step runs only if the frame's upload budget still has room for it
+    auto step = [&](uint64_t bytes, auto&& work) {
+        if (!scheduler) {
+            work();
+            return true;
+        }
+        if (!scheduler->hasBudget(bytes)) return false;
+        scheduler->charge(bytes, work);
+        return true;
+    };
+
+    // Steps: the texture plan, one texture at a time (a placeholder when
+    // streaming), the heap slots, one primitive at a time, then the material
+    // and transform buffers
+    for (;;) {
+        switch (pending.stage) {
+        case PendingLoad::Stage::TexturePlan:
+            if (!step(0, [&] {
+                    planTextures(device, textureHeap, samplerCache, mipGenerator, transferQueue, options);
+                })) return false;
+            pending.stage = PendingLoad::Stage::Textures;
+            break;
+        case PendingLoad::Stage::Textures:
+            if (pending.texture == m_textures.size()) {
+                pending.stage = PendingLoad::Stage::TextureSlots;
+                break;
+            }
+            // A load without a scheduler finishes now, so it waits for the cook
+            if (!nextTextureCooked(scheduler == nullptr)) return false;
+            if (!step(nextTextureBytes(options.streamTextures), [&] {
+                    uploadNextTexture(device, cmdPool, queue, options.streamTextures);
+                })) return false;
+            break;
+        case PendingLoad::Stage::TextureSlots:
+            if (!step(0, [&] { finishTextures(device, samplerCache, options); })) return false;
+            pending.stage = PendingLoad::Stage::Meshes;
+            break;
+        case PendingLoad::Stage::Meshes: {
+            while (pending.mesh < pending.primitives.size() && pending.primitives[pending.mesh].empty()) {
+                ++pending.mesh;
+            }
+            if (pending.mesh == pending.primitives.size()) {
+                pending.stage = PendingLoad::Stage::Buffers;
+                break;
+            }
+            const PendingLoad::Primitive& next = pending.primitives[pending.mesh][pending.primitive];
+            uint64_t bytes = next.vertices.size() * sizeof(GltfVertex) + next.indices.size() * sizeof(uint32_t);
+            if (!step(bytes, [&] { uploadNextPrimitive(device, cmdPool, queue); })) return false;
+            break;
+        }
+        case PendingLoad::Stage::Buffers: {
+            uint64_t bytes = m_materials.size() * sizeof(MaterialData) + m_nodes.size() * sizeof(glm::mat4);
+            if (!step(bytes, [&] { finishUpload(device); })) return false;
+            m_pending.reset();
+            return true;
+        }
+        }
+    }
+}
 
-    // Create GPU buffers
+void GltfModel::finishUpload(const Device& device) {
+    const tinygltf::Model& model = m_pending->model;
     createMaterialBuffer(device);
     createTransformBuffer(device);
-
-    // Initialize transforms
+    buildDrawLists();
     updateTransforms(device);
 
+    const double mb = 1.0 / (1024.0 * 1024.0);
+    std::cout << "Deduplication: " << m_dedup.images << " of " << model.images.size() << " images ("
+              << m_dedup.imageBytes * mb << " MB encoded), "
+              << m_dedup.textures << " of " << model.textures.size() << " textures share a GPU image ("
+              << m_dedup.textureBytes * mb << " MB decoded), "
+              << m_dedup.materials << " of " << m_materialRemap.size() << " materials merged" << std::endl;
+
     std::cout << "glTF model loaded successfully!" << std::endl;
 }
 
@@ -101,111 +491,607 @@ void GltfModel::loadFromFile(const Device& device,
 // ============================================================================
 
 void GltfModel::destroy(const Device& device) {
+    release(device, nullptr, 0);
+}
+
+void GltfModel::retire(const Device& device, DeletionQueue& deletionQueue, uint64_t value) {
+    release(device, &deletionQueue, value);
+}
+
+void GltfModel::release(const Device& device, DeletionQueue* deletionQueue, uint64_t value) {
+    auto releaseResource = [&](auto& resource) {
+        if (deletionQueue) {
+            resource.retire(device, *deletionQueue, value);
+        } else {
+            resource.destroy(device);
+        }
+    };
+
+    // Stop streaming before the textures it would replace go away, and let
+    // cook jobs of an unfinished load return before their state does
+    m_textureStreamer.stop();
+    if (m_pending) {
+        m_pending->cancelled = true;
+        for (const JobCounter& cooking : m_pending->cooking) {
+            m_jobs->wait(cooking);
+        }
+    }
+    m_pending.reset();
+    if (m_uploadScheduler) {
+        m_uploadScheduler->cancel(this);
+        m_uploadScheduler = nullptr;
+    }
+    m_pendingFullUploads.clear();
+    m_texturePriority.clear();
+    m_streamingComplete = true;
+    m_residencyEnabled = false;
+    m_cookedTextures.clear();
+    m_residentTopLevel.clear();
+    m_frameTopLevel.clear();
+
     // Destroy meshes (which destroys primitives)
     for (auto& mesh : m_meshes) {
-        mesh.destroy(device);
+        releaseResource(mesh);
     }
     m_meshes.clear();
 
     // Destroy textures
+    if (m_textureHeap) {
+        for (size_t i = 0; i < m_textureSlots.size(); ++i) {
+            if (m_sharedImageTexture[i] == static_cast<int>(i)) {
+                m_textureHeap->remove(m_textureSlots[i]);
+            }
+        }
+    }
+    m_textureSlots.clear();
+    m_textureHandles.clear();
+    m_sharedImageTexture.clear();
+    m_textureHeap = nullptr;
+    m_mipGenerator = nullptr;
+    m_transferQueue = nullptr;
     for (auto& texture : m_textures) {
-        texture.destroy(device);
+        releaseResource(texture);
     }
     m_textures.clear();
 
-    // Destroy samplers
-    for (auto sampler : m_samplers) {
-        if (sampler != VK_NULL_HANDLE) {
-            vkDestroySampler(device.get(), sampler, nullptr);
-        }
-    }
+    // Samplers belong to the SamplerCache
     m_samplers.clear();
+    m_textureSamplers.clear();
 
     // Destroy GPU buffers
-    m_materialBuffer.destroy(device);
-    m_transformBuffer.destroy(device);
+    releaseResource(m_materialBuffer);
+    releaseResource(m_transformBuffer);
 
     // Clear data
     m_nodes.clear();
     m_rootNodes.clear();
+    m_nodeLevels.clear();
     m_materials.clear();
+    m_materialRemap.clear();
+    m_materialVariants.clear();
+    m_draws.clear();
+    m_drawList.clear();
+    m_primitiveGeometry.clear();
+    m_worldMatrices.clear();
 }
 
 // ============================================================================
 // Texture Loading
 // ============================================================================
 
-void GltfModel::loadTextures(const tinygltf::Model& model,
-                               const Device& device,
-                               VkCommandPool cmdPool,
-                               VkQueue queue,
-                               const std::string& baseDir,
-                               const std::vector<bool>& isColorTexture) {
+void GltfModel::planTextures(const Device& device,
+                               BindlessTextureHeap& textureHeap,
+                               SamplerCache& samplerCache,
+                               MipGenerator* mipGenerator,
+                               AsyncQueue* transferQueue,
+                               const GltfLoadOptions& options) {
+    PendingLoad& pending = *m_pending;
+    const tinygltf::Model& model = pending.model;
+    const std::vector<TextureUsageFlags>& textureUsage = pending.textureUsage;
+    m_textureHeap = &textureHeap;
+    m_mipGenerator = mipGenerator;
+    m_transferQueue = transferQueue;
+    loadSamplers(model, device, samplerCache);
     m_textures.resize(model.textures.size());
 
-    std::cout << "Loading " << model.textures.size() << " textures:" << std::endl;
-
+    // Streaming cuts its preview from the CPU mip chain, so build one for every format
+    TextureCookOptions cookOptions = options.textureCook;
+    cookOptions.cpuMipChain = options.streamTextures;
+    pending.cooker.init(device, cookOptions);
+
+    // Pass 1: describe every used texture from its image header (nothing is decoded yet)
+    std::vector<TextureStreamRequest>& requests = pending.requests;
+    std::vector<TextureBudgetEntry>& budgetEntries = pending.budgetEntries;
+    pending.textureRequest.assign(model.textures.size(), -1);
+    auto imageFor = [&](int textureIndex) -> std::shared_ptr<const EncodedImage> {
+        int source = model.textures[textureIndex].source;
+        if (source < 0 || source >= static_cast<int>(pending.images.size())) return nullptr;
+        return pending.images[source];
+    };
     for (size_t i = 0; i < model.textures.size(); ++i) {
-        const tinygltf::Texture& gltfTex = model.textures[i];
-        if (gltfTex.source < 0 || gltfTex.source >= static_cast<int>(model.images.size())) {
-            std::cerr << "Warning: Texture " << i << " has invalid image reference" << std::endl;
+        if (textureUsage[i] == 0) {
+            // Not referenced by any material (or fully merged into an ORM texture)
             continue;
         }
+        std::shared_ptr<const EncodedImage> image = imageFor(static_cast<int>(i));
+        if (!image) {
+            std::cerr << "Warning: Texture " << i << " has no loadable image" << std::endl;
+            continue;
+        }
+
+        TextureStreamRequest request;
+        request.textureIndex = static_cast<uint32_t>(i);
+        request.image = image;
+        request.usage = textureUsage[i];
+        if (m_packedOcclusionSource[i] >= 0) {
+            request.occlusion = imageFor(m_packedOcclusionSource[i]);
+        }
+        pending.textureRequest[i] = static_cast<int>(requests.size());
+        requests.push_back(std::move(request));
+
+        // The file's channel count stands in for the alpha scan cook() does later
+        bool mayHaveAlpha = (textureUsage[i] & TEXTURE_USAGE_BASE_COLOR) &&
+                            (image->channels == 2 || image->channels == 4);
+        const tinygltf::Image& gltfImage = model.images[model.textures[i].source];
+        TextureBudgetEntry entry;
+        entry.name = gltfImage.uri.empty() ? ("texture " + std::to_string(i)) : gltfImage.uri;
+        entry.width = image->width;
+        entry.height = image->height;
+        entry.usage = textureUsage[i];
+        entry.format = pending.cooker.chooseFormat(entry.usage, mayHaveAlpha);
+        budgetEntries.push_back(std::move(entry));
+    }
+    pending.images.clear();
+
+    // Pass 2: fit the set into the texture budget by dropping top mips
+    TextureBudget budget(options.textureBudget);
+    budget.plan(budgetEntries);
+    for (size_t r = 0; r < requests.size(); ++r) {
+        requests[r].skipMips = budgetEntries[r].droppedMips;
+    }
 
-        const tinygltf::Image& gltfImage = model.images[gltfTex.source];
-        std::cout << "  Texture " << i << ": " << (gltfImage.uri.empty() ? "embedded" : gltfImage.uri);
+    // Residency needs the CPU chains that only the streaming path keeps
+    m_residentTopLevel.assign(model.textures.size(), kUntrackedLevel);
+    m_residencyEnabled = options.streamTextures && options.textureFeedback;
+    if (m_residencyEnabled) {
+        m_residency.init(static_cast<uint32_t>(model.textures.size()), budget.budgetBytes());
+        m_cookedTextures.resize(model.textures.size());
+    }
+    if (options.streamTextures) return;
 
-        // Use SRGB for color textures (base color, emissive), LINEAR for data textures (normal, metallic-roughness, occlusion)
-        VkFormat format = isColorTexture[i] ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
-        std::cout << " [" << (isColorTexture[i] ? "SRGB" : "LINEAR") << "]" << std::endl;
+    // Pass 3 without streaming: decode and cook one texture per background
+    // job, each with a cooker forked here before any job runs; the texture
+    // steps upload them on this thread as they finish
+    std::cout << "Loading " << model.textures.size() << " textures:" << std::endl;
+    pending.results.resize(requests.size());
+    if (!m_jobs || m_jobs->threadCount() == 1) return;
+    pending.cookers.reserve(requests.size());
+    for (size_t r = 0; r < requests.size(); ++r) {
+        pending.cookers.push_back(pending.cooker.fork());
+    }
+    pending.cooking = std::vector<JobCounter>(requests.size());
+    for (size_t r = 0; r < requests.size(); ++r) {
+        m_jobs->run([&pending, r] {
+            if (pending.cancelled) return;
+            pending.results[r] = TextureStreamer::process(pending.cookers[r], pending.requests[r]);
+        }, &pending.cooking[r], JobPriority::Background);
+    }
+}
 
-        // Load from embedded data or external file
-        if (!gltfImage.image.empty()) {
-            // Image data is embedded
-            int width = gltfImage.width;
-            int height = gltfImage.height;
-            const unsigned char* pixels = gltfImage.image.data();
+bool GltfModel::nextTextureCooked(bool wait) const {
+    const PendingLoad& pending = *m_pending;
+    int request = pending.textureRequest[pending.texture];
+    if (request < 0 || pending.cooking.empty()) return true;
+
+    const JobCounter& cooking = pending.cooking[request];
+    if (!cooking.done() && !wait) return false;
+    // At once for a finished cook, where it makes the counter safe to drop;
+    // at frame priority, so the other cooks stay on the workers
+    m_jobs->wait(cooking);
+    return true;
+}
 
-            m_textures[i].createFromPixels(device, cmdPool, queue,
-                                            pixels, width, height,
-                                            format, true,
-                                            VK_FILTER_LINEAR,
-                                            VK_SAMPLER_ADDRESS_MODE_REPEAT);
-        } else if (!gltfImage.uri.empty()) {
-            // Image is external file - load using stb_image
-            std::string imagePath = baseDir + gltfImage.uri;
+uint64_t GltfModel::nextTextureBytes(bool streaming) const {
+    const PendingLoad& pending = *m_pending;
+    size_t i = pending.texture;
+    if (m_sharedImageTexture[i] != static_cast<int>(i)) return 0;
+    int request = pending.textureRequest[i];
+    if (streaming || request < 0) return 4;    // a 1x1 placeholder
+    return pending.budgetEntries[request].residentBytes;
+}
 
-            int width, height, channels;
-            stbi_uc* pixels = stbi_load(imagePath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+void GltfModel::uploadNextTexture(const Device& device, VkCommandPool cmdPool, VkQueue queue, bool streaming) {
+    PendingLoad& pending = *m_pending;
+    const size_t i = pending.texture++;
+    if (m_sharedImageTexture[i] != static_cast<int>(i)) return;
 
-            if (!pixels) {
-                std::cerr << "Warning: Failed to load external image: " << imagePath << std::endl;
-                continue;
+    int request = pending.textureRequest[i];
+    if (!streaming && request >= 0) {
+        StreamedTexture& result = pending.results[request];
+        if (pending.cooking.empty()) {
+            result = TextureStreamer::process(pending.cooker, pending.requests[request]);
+        } else {
+            pending.cooker.mergeStats(pending.cookers[request]);
+        }
+        if (!result.failed) {
+            const TextureMipLevel& top = result.cooked.levels[0];
+            std::cout << "  Texture " << i << ": " << top.width << "x" << top.height
+                      << (pending.requests[request].occlusion ? " +occlusion" : "")
+                      << " [" << textureFormatName(result.cooked.format) << "]" << std::endl;
+            uploadCooked(m_textures[i], result.cooked, 0, m_textureSamplers[i], device, cmdPool, queue,
+                         m_mipGenerator, m_transferQueue);
+            result.cooked = CookedTexture{};
+            return;
+        }
+    }
+
+    // Streamed textures start from a placeholder; unused and unloadable
+    // slots keep one, as their heap slot still needs a valid view
+    createPlaceholder(m_textures[i], pending.textureUsage[i], m_textureSamplers[i], device, cmdPool, queue,
+                      m_transferQueue);
+}
+
+void GltfModel::finishTextures(const Device& device, SamplerCache& samplerCache, const GltfLoadOptions& options) {
+    PendingLoad& pending = *m_pending;
+    std::vector<TextureStreamRequest>& requests = pending.requests;
+    std::vector<TextureBudgetEntry>& budgetEntries = pending.budgetEntries;
+
+    if (options.streamTextures) {
+        // Most visible textures first, small before large within a class
+        std::vector<uint64_t> residentBytes(m_textures.size(), 0);
+        for (size_t r = 0; r < requests.size(); ++r) {
+            residentBytes[requests[r].textureIndex] = budgetEntries[r].residentBytes;
+        }
+        std::stable_sort(requests.begin(), requests.end(),
+            [&](const TextureStreamRequest& a, const TextureStreamRequest& b) {
+                uint32_t importanceA = textureUsageImportance(a.usage);
+                uint32_t importanceB = textureUsageImportance(b.usage);
+                if (importanceA != importanceB) return importanceA > importanceB;
+                return residentBytes[a.textureIndex] < residentBytes[b.textureIndex];
+            });
+
+        std::cout << "Streaming " << requests.size() << " textures in the background" << std::endl;
+        m_streamingComplete = requests.empty();
+        m_textureStreamer.start(std::move(pending.cooker), std::move(requests), m_jobs);
+    } else {
+        pending.cooker.printStats();
+        m_streamingComplete = true;
+    }
+    TextureBudget(options.textureBudget).printReport(budgetEntries);
+
+    // Every texture has a view by now (final or placeholder); streaming
+    // replaces the image behind a slot, never the slot itself
+    m_textureSlots.resize(m_textures.size());
+    m_textureHandles.resize(m_textures.size());
+    for (size_t i = 0; i < m_textures.size(); ++i) {
+        int shared = m_sharedImageTexture[i];
+        m_textureSlots[i] = (shared == static_cast<int>(i))
+            ? m_textureHeap->add(device, m_textures[i])
+            : m_textureSlots[shared];
+        m_textureHandles[i] = BindlessTextureHeap::handle(
+            m_textureSlots[i], m_textureHeap->samplerSlot(device, m_textureSamplers[i]));
+    }
+    samplerCache.printStats();
+    deduplicateMaterials();
+}
+
+// ============================================================================
+// Texture Streaming
+// ============================================================================
+
+void GltfModel::updateStreaming(const UploadFrame& uploadFrame,
+                                  UploadScheduler& scheduler,
+                                  uint32_t framesInFlight,
+                                  uint32_t frame) {
+    const Device& device = uploadFrame.device;
+    m_frameNumber++;
+    m_uploadScheduler = &scheduler;
+
+    if (!m_streamingComplete) {
+        // Newly cooked textures: show the small end of the chain as soon as
+        // the frame's budget allows and queue the full chain, which uploads
+        // nearest-first. Previews that do not fit wait for the next frame.
+        std::vector<StreamedTexture> completed = m_textureStreamer.takeCompleted();
+        size_t taken = 0;
+        for (; taken < completed.size(); ++taken) {
+            StreamedTexture& item = completed[taken];
+            if (item.failed) continue;
+
+            uint32_t preview = previewLevel(item.cooked);
+            uint64_t previewBytes = cookedBytes(item.cooked, preview);
+            if (!scheduler.hasBudget(previewBytes)) break;
+            Texture texture;
+            scheduler.charge(previewBytes, [&] {
+                uploadCooked(texture, item.cooked, preview, m_textureSamplers[item.textureIndex], device,
+                             uploadFrame.cmdPool, uploadFrame.queue, m_mipGenerator, m_transferQueue);
+            });
+            swapInTexture(uploadFrame, item.textureIndex, texture, preview);
+            if (preview > 0) {
+                uint32_t textureIndex = item.textureIndex;
+                scheduler.enqueue(this, cookedBytes(item.cooked),
+                    [this, textureIndex] {
+                        return textureIndex < m_texturePriority.size() ? m_texturePriority[textureIndex] : 0.0f;
+                    },
+                    [this, textureIndex](const UploadFrame& queued) { uploadFullChain(queued, textureIndex); });
+                m_pendingFullUploads.push_back(std::move(item));
+            } else if (m_residencyEnabled) {
+                m_residency.track(item.textureIndex, chainBytes(item.cooked), 0, 0);
+                m_cookedTextures[item.textureIndex] = std::move(item.cooked);
             }
+        }
+        if (taken < completed.size()) {
+            completed.erase(completed.begin(), completed.begin() + static_cast<std::ptrdiff_t>(taken));
+            m_textureStreamer.returnCompleted(std::move(completed));
+        }
+
+        if (m_pendingFullUploads.empty() && m_textureStreamer.isFinished()) {
+            m_textureStreamer.cooker().printStats();
+            m_textureStreamer.stop();
+            m_streamingComplete = true;
+        }
+    }
+
+    if (m_residencyEnabled) {
+        // Evictions first: they are cheap and free room for the loads
+        std::vector<TextureResidency::Change> changes = m_residency.plan(m_frameNumber);
+        std::stable_sort(changes.begin(), changes.end(),
+            [&](const TextureResidency::Change& a, const TextureResidency::Change& b) {
+                bool evictA = a.topLevel > m_residentTopLevel[a.textureIndex];
+                bool evictB = b.topLevel > m_residentTopLevel[b.textureIndex];
+                return evictA && !evictB;
+            });
+        // Loads take what the frame's upload budget has left; the rest are
+        // planned again next frame
+        for (const auto& change : changes) {
+            const CookedTexture& cooked = m_cookedTextures[change.textureIndex];
+            uint64_t bytes = cookedBytes(cooked, change.topLevel);
+            if (!scheduler.hasBudget(bytes)) break;
+            Texture texture;
+            scheduler.charge(bytes, [&] {
+                uploadCooked(texture, cooked, change.topLevel, m_textureSamplers[change.textureIndex], device,
+                             uploadFrame.cmdPool, uploadFrame.queue, m_mipGenerator, m_transferQueue);
+            });
+            swapInTexture(uploadFrame, change.textureIndex, texture, change.topLevel);
+            m_residency.setResident(change.textureIndex, change.topLevel);
+        }
+
+        if (!changes.empty() && m_frameNumber >= m_lastResidencyReport + kResidencyReportFrames) {
+            m_lastResidencyReport = m_frameNumber;
+            const double mb = 1.0 / (1024.0 * 1024.0);
+            std::cout << "Texture residency: " << m_residency.residentBytes() * mb << " MB resident of "
+                      << m_residency.fullBytes() * mb << " MB";
+            if (m_residency.budgetBytes() != 0) std::cout << " (budget " << m_residency.budgetBytes() * mb << " MB)";
+            std::cout << ", " << m_residency.loads() << " loads, " << m_residency.evictions() << " evictions"
+                      << std::endl;
+        }
+    }
+
+    // Remember which levels this frame binds, to interpret its feedback later
+    if (m_frameTopLevel.size() < framesInFlight) {
+        m_frameTopLevel.resize(framesInFlight);
+    }
+    m_frameTopLevel[frame] = m_residentTopLevel;
+}
+
+void GltfModel::swapInTexture(const UploadFrame& uploadFrame, uint32_t textureIndex,
+                                const Texture& texture, uint32_t topLevel) {
+    // The frame about to be recorded binds the new image (its heap copy is
+    // rewritten in beginFrame); only frames already submitted see the old one.
+    // Other slots' heap copies are rewritten before those slots record again.
+    m_textures[textureIndex].retire(uploadFrame.device, uploadFrame.deletionQueue, uploadFrame.retireValue);
+    m_textures[textureIndex] = texture;
+    m_residentTopLevel[textureIndex] = topLevel;
+    m_textureHeap->replace(m_textureSlots[textureIndex], texture);
+}
+
+void GltfModel::uploadFullChain(const UploadFrame& uploadFrame, uint32_t textureIndex) {
+    auto it = std::find_if(m_pendingFullUploads.begin(), m_pendingFullUploads.end(),
+                           [&](const StreamedTexture& item) { return item.textureIndex == textureIndex; });
+    if (it == m_pendingFullUploads.end()) return;
+
+    Texture texture;
+    uploadCooked(texture, it->cooked, 0, m_textureSamplers[textureIndex], uploadFrame.device,
+                 uploadFrame.cmdPool, uploadFrame.queue, m_mipGenerator, m_transferQueue);
+    swapInTexture(uploadFrame, textureIndex, texture, 0);
+
+    if (m_residencyEnabled) {
+        m_residency.track(textureIndex, chainBytes(it->cooked), previewLevel(it->cooked), 0);
+        m_cookedTextures[textureIndex] = std::move(it->cooked);
+    }
+    m_pendingFullUploads.erase(it);
+}
+
+void GltfModel::applyTextureFeedback(uint32_t frame, const std::vector<uint32_t>& minMips) {
+    if (!m_residencyEnabled || frame >= m_frameTopLevel.size()) return;
+
+    const std::vector<uint32_t>& boundTop = m_frameTopLevel[frame];
+    size_t count = std::min(m_textureSlots.size(), boundTop.size());
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t slot = m_textureSlots[i];
+        if (slot >= minMips.size() || minMips[slot] == TextureFeedback::kNotSampled ||
+            boundTop[i] == kUntrackedLevel) continue;
+        int level = static_cast<int>(boundTop[i]) + static_cast<int>(minMips[slot]) - TextureFeedback::kLodBias;
+        m_residency.recordRequest(static_cast<uint32_t>(i), static_cast<uint32_t>(std::max(level, 0)), m_frameNumber);
+    }
+}
+
+// ============================================================================
+// ORM Channel Packing
+// ============================================================================
 
-            m_textures[i].createFromPixels(device, cmdPool, queue,
-                                            pixels, width, height,
-                                            format, true,
-                                            VK_FILTER_LINEAR,
-                                            VK_SAMPLER_ADDRESS_MODE_REPEAT);
+void GltfModel::planOrmPacking(const tinygltf::Model& model,
+                               const std::vector<std::shared_ptr<EncodedImage>>& images) {
+    const size_t textureCount = model.textures.size();
+    m_packedOcclusionSource.assign(textureCount, -1);
+    std::vector<bool> rejected(textureCount, false);
+
+    auto sourceImage = [&](int textureIndex) -> const EncodedImage* {
+        int source = model.textures[textureIndex].source;
+        if (source < 0 || source >= static_cast<int>(images.size())) return nullptr;
+        return images[source].get();
+    };
+    auto valid = [&](int textureIndex) {
+        return textureIndex >= 0 && textureIndex < static_cast<int>(textureCount);
+    };
 
-            stbi_image_free(pixels);
+    for (const auto& gltfMat : model.materials) {
+        int occlusion = gltfMat.occlusionTexture.index;
+        int metallicRoughness = gltfMat.pbrMetallicRoughness.metallicRoughnessTexture.index;
+
+        // A texture sampled through any other slot (including an ORM whose
+        // R is already read as occlusion) cannot have its R channel rewritten
+        for (int other : { gltfMat.pbrMetallicRoughness.baseColorTexture.index,
+                           gltfMat.emissiveTexture.index,
+                           gltfMat.normalTexture.index,
+                           occlusion }) {
+            if (valid(other)) rejected[other] = true;
+        }
+
+        if (!valid(occlusion) || !valid(metallicRoughness) || occlusion == metallicRoughness) continue;
+
+        const EncodedImage* occlusionImage = sourceImage(occlusion);
+        const EncodedImage* mrImage = sourceImage(metallicRoughness);
+        bool compatible = occlusionImage && mrImage &&
+                          occlusionImage->width == mrImage->width &&
+                          occlusionImage->height == mrImage->height &&
+                          gltfMat.occlusionTexture.texCoord == gltfMat.pbrMetallicRoughness.metallicRoughnessTexture.texCoord &&
+                          model.textures[occlusion].sampler == model.textures[metallicRoughness].sampler;
+        int& packed = m_packedOcclusionSource[metallicRoughness];
+        if (!compatible || (packed >= 0 && packed != occlusion)) {
+            rejected[metallicRoughness] = true;
+        } else {
+            packed = occlusion;
         }
     }
+
+    uint32_t packedCount = 0;
+    for (size_t i = 0; i < textureCount; ++i) {
+        if (rejected[i]) m_packedOcclusionSource[i] = -1;
+        if (m_packedOcclusionSource[i] >= 0) packedCount++;
+    }
+    if (packedCount > 0) {
+        std::cout << "  Packed " << packedCount << " occlusion map(s) into metallic-roughness textures" << std::endl;
+    }
+}
+
+int GltfModel::resolveOcclusionTexture(int occlusionIndex, int metallicRoughnessIndex) const {
+    if (occlusionIndex >= 0 && metallicRoughnessIndex >= 0 &&
+        metallicRoughnessIndex < static_cast<int>(m_packedOcclusionSource.size()) &&
+        m_packedOcclusionSource[metallicRoughnessIndex] == occlusionIndex) {
+        return metallicRoughnessIndex;
+    }
+    return occlusionIndex;
+}
+
+// ============================================================================
+// Content-Hash Deduplication
+// ============================================================================
+
+void GltfModel::deduplicateImages(std::vector<std::shared_ptr<EncodedImage>>& images,
+                                    const std::vector<uint64_t>& hashes) {
+    // Hash matches are confirmed byte for byte before two images are merged
+    std::unordered_map<uint64_t, std::vector<size_t>> byHash;
+    for (size_t i = 0; i < images.size(); ++i) {
+        std::shared_ptr<EncodedImage> image = images[i];
+        if (!image) continue;
+
+        std::vector<size_t>& candidates = byHash[hashes[i]];
+        auto match = std::find_if(candidates.begin(), candidates.end(), [&](size_t j) {
+            return images[j]->bytes == image->bytes && images[j]->path == image->path;
+        });
+        if (match == candidates.end()) {
+            candidates.push_back(i);
+            continue;
+        }
+        images[i] = images[*match];
+        m_dedup.images++;
+        m_dedup.imageBytes += image->bytes.size();
+    }
+}
+
+void GltfModel::deduplicateTextures(const tinygltf::Model& model,
+                                    const std::vector<std::shared_ptr<EncodedImage>>& images) {
+    auto imageFor = [&](int textureIndex) -> const EncodedImage* {
+        if (textureIndex < 0) return nullptr;
+        int source = model.textures[textureIndex].source;
+        if (source < 0 || source >= static_cast<int>(images.size())) return nullptr;
+        return images[source].get();
+    };
+
+    // After deduplicateImages, equal content means equal EncodedImage pointers;
+    // a packed occlusion map changes the cooked result, so it is part of the key
+    std::map<std::pair<const EncodedImage*, const EncodedImage*>, int> firstTexture;
+    m_sharedImageTexture.resize(model.textures.size());
+    for (size_t i = 0; i < model.textures.size(); ++i) {
+        m_sharedImageTexture[i] = static_cast<int>(i);
+        const EncodedImage* image = imageFor(static_cast<int>(i));
+        if (!image) continue;
+
+        const EncodedImage* occlusion = imageFor(m_packedOcclusionSource[i]);
+        auto inserted = firstTexture.emplace(std::make_pair(image, occlusion), static_cast<int>(i));
+        if (!inserted.second) {
+            m_sharedImageTexture[i] = inserted.first->second;
+            m_dedup.textures++;
+            m_dedup.textureBytes += static_cast<uint64_t>(image->width) * image->height * 4;
+        }
+    }
+}
+
+void GltfModel::deduplicateMaterials() {
+    std::vector<GltfMaterial> unique;
+    std::vector<MaterialData> uniqueData;
+    std::unordered_map<uint64_t, std::vector<int>> byHash;
+    m_materialRemap.assign(m_materials.size(), -1);
+
+    for (size_t i = 0; i < m_materials.size(); ++i) {
+        // Compare what the shader sees: textures that share an image and a
+        // sampler have equal handles even when their glTF indices differ
+        MaterialData data = gpuMaterialData(m_materials[i].data);
+        std::vector<int>& candidates = byHash[hashBytes(&data, sizeof(data))];
+        auto match = std::find_if(candidates.begin(), candidates.end(), [&](int j) {
+            return memcmp(&uniqueData[j], &data, sizeof(MaterialData)) == 0;
+        });
+        if (match != candidates.end()) {
+            m_materialRemap[i] = *match;
+            m_dedup.materials++;
+            continue;
+        }
+        int slot = static_cast<int>(unique.size());
+        candidates.push_back(slot);
+        m_materialRemap[i] = slot;
+        unique.push_back(std::move(m_materials[i]));
+        uniqueData.push_back(data);
+    }
+    m_materials = std::move(unique);
+}
+
+MaterialData GltfModel::gpuMaterialData(const MaterialData& data) const {
+    // glTF texture indices become bindless heap handles (-1 stays "no texture")
+    auto toHandle = [&](int textureIndex) {
+        if (textureIndex < 0 || textureIndex >= static_cast<int>(m_textureHandles.size())) return -1;
+        return static_cast<int>(m_textureHandles[textureIndex]);
+    };
+
+    MaterialData gpu = data;
+    gpu.baseColorTextureIndex = toHandle(data.baseColorTextureIndex);
+    gpu.metallicRoughnessTextureIndex = toHandle(data.metallicRoughnessTextureIndex);
+    gpu.normalTextureIndex = toHandle(data.normalTextureIndex);
+    gpu.occlusionTextureIndex = toHandle(data.occlusionTextureIndex);
+    gpu.emissiveTextureIndex = toHandle(data.emissiveTextureIndex);
+    return gpu;
 }
 
 // ============================================================================
 // Sampler Loading
 // ============================================================================
 
-void GltfModel::loadSamplers(const tinygltf::Model& model, const Device& device) {
+void GltfModel::loadSamplers(const tinygltf::Model& model, const Device& device, SamplerCache& samplerCache) {
     m_samplers.resize(model.samplers.size(), VK_NULL_HANDLE);
 
     for (size_t i = 0; i < model.samplers.size(); ++i) {
         const tinygltf::Sampler& gltfSampler = model.samplers[i];
 
-        VkSamplerCreateInfo samplerInfo{};
-        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        SamplerKey key;
 
         // Convert glTF filter modes to Vulkan
         auto getFilter = [](int gltfFilter) -> VkFilter {
@@ -229,24 +1115,38 @@ void GltfModel::loadSamplers(const tinygltf::Model& model, const Device& device)
             }
         };
 
-        samplerInfo.magFilter = getFilter(gltfSampler.magFilter);
-        samplerInfo.minFilter = getFilter(gltfSampler.minFilter);
-        samplerInfo.addressModeU = getWrapMode(gltfSampler.wrapS);
-        samplerInfo.addressModeV = getWrapMode(gltfSampler.wrapT);
-        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-        samplerInfo.anisotropyEnable = VK_TRUE;
-        samplerInfo.maxAnisotropy = 16.0f;
-        samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-        samplerInfo.unnormalizedCoordinates = VK_FALSE;
-        samplerInfo.compareEnable = VK_FALSE;
-        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-        samplerInfo.minLod = 0.0f;
-        samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
-        samplerInfo.mipLodBias = 0.0f;
-
-        if (vkCreateSampler(device.get(), &samplerInfo, nullptr, &m_samplers[i]) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to create glTF sampler");
+        key.magFilter = getFilter(gltfSampler.magFilter);
+        key.minFilter = getFilter(gltfSampler.minFilter);
+        key.addressModeU = getWrapMode(gltfSampler.wrapS);
+        key.addressModeV = getWrapMode(gltfSampler.wrapT);
+
+        // The *_MIPMAP_NEAREST min filters pick one level; plain NEAREST and
+        // LINEAR mean no mipmapping, so only level 0 is sampled
+        switch (gltfSampler.minFilter) {
+            case 9984:
+            case 9985:
+                key.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+                break;
+            case 9728:
+            case 9729:
+                key.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+                key.maxLod = 0.0f;
+                break;
+            default:
+                key.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+                break;
         }
+
+        m_samplers[i] = samplerCache.get(device, key);
+    }
+
+    // Textures without a sampler use glTF's default: linear, mipmapped, repeat
+    m_textureSamplers.resize(model.textures.size());
+    for (size_t i = 0; i < model.textures.size(); ++i) {
+        int samplerIndex = model.textures[i].sampler;
+        m_textureSamplers[i] = (samplerIndex >= 0 && samplerIndex < static_cast<int>(m_samplers.size()))
+            ? m_samplers[samplerIndex]
+            : samplerCache.get(device, SamplerKey{});
     }
 }
 
@@ -321,9 +1221,11 @@ void GltfModel::loadMaterials(const tinygltf::Model& model) {
         }
 
         if (gltfMat.occlusionTexture.index >= 0) {
-            material.occlusionTextureIndex = gltfMat.occlusionTexture.index;
+            int occlusionIndex = resolveOcclusionTexture(gltfMat.occlusionTexture.index,
+                                                         pbr.metallicRoughnessTexture.index);
+            material.occlusionTextureIndex = occlusionIndex;
             material.occlusionTexCoord = gltfMat.occlusionTexture.texCoord;
-            material.data.occlusionTextureIndex = gltfMat.occlusionTexture.index;
+            material.data.occlusionTextureIndex = occlusionIndex;
             material.data.occlusionTexCoord = gltfMat.occlusionTexture.texCoord;
             material.data.occlusionStrength = static_cast<float>(gltfMat.occlusionTexture.strength);
         }
@@ -346,11 +1248,9 @@ void GltfModel::loadMaterials(const tinygltf::Model& model) {
 // Mesh Loading (Vertex Extraction is CRITICAL)
 // ============================================================================
 
-void GltfModel::loadMeshes(const tinygltf::Model& model,
-                             const Device& device,
-                             VkCommandPool cmdPool,
-                             VkQueue queue) {
+void GltfModel::loadMeshes(const tinygltf::Model& model, JobCounter& extracted) {
     m_meshes.resize(model.meshes.size());
+    m_pending->primitives.resize(model.meshes.size());
 
     for (size_t i = 0; i < model.meshes.size(); ++i) {
         const tinygltf::Mesh& gltfMesh = model.meshes[i];
@@ -358,21 +1258,60 @@ void GltfModel::loadMeshes(const tinygltf::Model& model,
 
         mesh.name = gltfMesh.name;
         mesh.primitives.resize(gltfMesh.primitives.size());
+        m_pending->primitives[i].resize(gltfMesh.primitives.size());
+
+        // One job per mesh; it writes only this mesh's slots of m_pending
+        auto extractMesh = [this, &model, i] {
+            PendingLoad& pending = *m_pending;
+            try {
+                const tinygltf::Mesh& gltfMesh = model.meshes[i];
+                for (size_t p = 0; p < gltfMesh.primitives.size(); ++p) {
+                    const tinygltf::Primitive& gltfPrim = gltfMesh.primitives[p];
+                    PendingLoad::Primitive& primitive = pending.primitives[i][p];
+
+                    // Extract vertex and index data
+                    extractVertexData(model, gltfPrim, primitive.vertices, primitive.indices);
+                    primitive.material = gltfPrim.material;
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(pending.extractionMutex);
+                if (!pending.extractionError) pending.extractionError = std::current_exception();
+            }
+        };
+        if (m_jobs) {
+            m_jobs->run(extractMesh, &extracted, JobPriority::Background);
+        } else {
+            extractMesh();
+        }
+    }
+}
 
-        for (size_t p = 0; p < gltfMesh.primitives.size(); ++p) {
-            const tinygltf::Primitive& gltfPrim = gltfMesh.primitives[p];
-            GltfPrimitive& primitive = mesh.primitives[p];
+void GltfModel::uploadNextPrimitive(const Device& device, VkCommandPool cmdPool, VkQueue queue) {
+    PendingLoad& pending = *m_pending;
+    PendingLoad::Primitive& extracted = pending.primitives[pending.mesh][pending.primitive];
+    GltfPrimitive& primitive = m_meshes[pending.mesh].primitives[pending.primitive];
 
-            // Extract vertex and index data
-            std::vector<GltfVertex> vertices;
-            std::vector<uint32_t> indices;
+    if (extracted.material >= 0 && extracted.material < static_cast<int>(m_materialRemap.size())) {
+        primitive.materialIndex = m_materialRemap[extracted.material];
+    } else {
+        // glTF default material; appended once, after deduplication
+        if (pending.defaultMaterial < 0) {
+            pending.defaultMaterial = static_cast<int>(m_materials.size());
+            m_materials.push_back(GltfMaterial());
+        }
+        primitive.materialIndex = pending.defaultMaterial;
+    }
 
-            extractVertexData(model, gltfPrim, vertices, indices);
+    // Create GPU buffers for this primitive; alpha-tested materials
+    // also get a position+UV stream for the depth pre-pass
+    const GltfMaterial& material = m_materials[primitive.materialIndex];
+    int alphaTestTexCoord = material.getAlphaMode() == AlphaMode::Mask ? material.baseColorTexCoord : -1;
+    primitive.create(device, cmdPool, queue, m_transferQueue, extracted.vertices, extracted.indices, alphaTestTexCoord);
+    extracted = PendingLoad::Primitive{};
 
-            // Create GPU buffers for this primitive
-            primitive.create(device, cmdPool, queue, vertices, indices);
-            primitive.materialIndex = gltfPrim.material;
-        }
+    if (++pending.primitive == pending.primitives[pending.mesh].size()) {
+        pending.primitive = 0;
+        ++pending.mesh;
     }
 }
 
@@ -693,6 +1632,28 @@ void GltfModel::loadNodes(const tinygltf::Model& model) {
     for (size_t i = 0; i < scene.nodes.size(); ++i) {
         m_rootNodes[i] = scene.nodes[i];
     }
+
+    // Group nodes by depth for updateWorldMatrices(); a node on a parent
+    // cycle (invalid glTF) is treated as a root
+    std::vector<int> depth(m_nodes.size(), -1);
+    m_nodeLevels.clear();
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        int level = 0;
+        int steps = 0;
+        for (int parent = m_nodes[i].parent; parent >= 0 && steps <= static_cast<int>(m_nodes.size());
+             parent = m_nodes[parent].parent, ++steps) {
+            ++level;
+        }
+        if (steps > static_cast<int>(m_nodes.size())) {
+            m_nodes[i].parent = -1;
+            level = 0;
+        }
+        depth[i] = level;
+    }
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        if (m_nodeLevels.size() <= static_cast<size_t>(depth[i])) m_nodeLevels.resize(depth[i] + 1);
+        m_nodeLevels[depth[i]].push_back(static_cast<uint32_t>(i));
+    }
 }
 
 // ============================================================================
@@ -713,14 +1674,15 @@ void GltfModel::createMaterialBuffer(const Device& device) {
     // Copy material data directly to storage buffer
     void* dest = m_materialBuffer.map(device);
     for (size_t i = 0; i < m_materials.size(); ++i) {
+        MaterialData data = gpuMaterialData(m_materials[i].data);
+        m_materials[i].features = materialFeatures(data);
+
         std::cout << "Uploading material " << i << " (" << m_materials[i].name << "):" << std::endl;
-        std::cout << "  baseColorTexIdx: " << m_materials[i].data.baseColorTextureIndex << std::endl;
-        std::cout << "  metalRoughTexIdx: " << m_materials[i].data.metallicRoughnessTextureIndex << std::endl;
-        std::cout << "  normalTexIdx: " << m_materials[i].data.normalTextureIndex << std::endl;
+        std::cout << "  baseColorTexHandle: " << data.baseColorTextureIndex << std::endl;
+        std::cout << "  metalRoughTexHandle: " << data.metallicRoughnessTextureIndex << std::endl;
+        std::cout << "  normalTexHandle: " << data.normalTextureIndex << std::endl;
 
-        memcpy(static_cast<char*>(dest) + i * sizeof(MaterialData),
-               &m_materials[i].data,
-               sizeof(MaterialData));
+        memcpy(static_cast<char*>(dest) + i * sizeof(MaterialData), &data, sizeof(MaterialData));
     }
     m_materialBuffer.unmap(device);
 }
@@ -749,71 +1711,395 @@ void GltfModel::createTransformBuffer(const Device& device) {
 void GltfModel::updateTransforms(const Device& device) {
     if (m_nodes.empty() || !m_transformBuffer.get()) return;
 
-    // Mark all nodes as needing transform update
-    for (auto& node : m_nodes) {
-        node.markDirty();
-    }
-
-    // Compute world transforms for all nodes
-    std::vector<glm::mat4> worldMatrices(m_nodes.size());
-    for (size_t i = 0; i < m_nodes.size(); ++i) {
-        worldMatrices[i] = m_nodes[i].getWorldMatrix(m_nodes);
-    }
+    // Compute world transforms for all nodes (kept for draw sorting)
+    updateWorldMatrices();
 
     // Upload to GPU buffer
     void* data = m_transformBuffer.map(device);
-    memcpy(data, worldMatrices.data(), sizeof(glm::mat4) * worldMatrices.size());
+    memcpy(data, m_worldMatrices.data(), sizeof(glm::mat4) * m_worldMatrices.size());
     m_transformBuffer.unmap(device);
 }
 
+void GltfModel::updateWorldMatrices() {
+    // Level by level from the roots: parents are always done before their
+    // children, and the nodes of one level are independent
+    m_worldMatrices.resize(m_nodes.size());
+    for (const std::vector<uint32_t>& level : m_nodeLevels) {
+        parallelFor(m_jobs, level.size(), kNodesPerJob, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const GltfNode& node = m_nodes[level[i]];
+                glm::mat4 local = node.getLocalMatrix();
+                m_worldMatrices[level[i]] = node.parent >= 0 ? m_worldMatrices[node.parent] * local : local;
+            }
+        });
+    }
+}
+
 // ============================================================================
 // Rendering
 // ============================================================================
 
-void GltfModel::draw(VkCommandBuffer cmd,
-                      VkPipelineLayout pipelineLayout,
-                      uint32_t currentFrame) const {
-    // Draw all root nodes (which recursively draws children)
+void GltfModel::buildDrawLists() {
+    // One variant per distinct feature set, grouped by pass so that
+    // pipelines of one pass are adjacent
+    m_materialVariants.clear();
+    for (const GltfMaterial& material : m_materials) {
+        m_materialVariants.push_back(material.features);
+    }
+    auto byPass = [](MaterialFeatureFlags a, MaterialFeatureFlags b) {
+        AlphaMode passA = featureAlphaMode(a);
+        AlphaMode passB = featureAlphaMode(b);
+        return passA != passB ? passA < passB : a < b;
+    };
+    std::sort(m_materialVariants.begin(), m_materialVariants.end(), byPass);
+    m_materialVariants.erase(std::unique(m_materialVariants.begin(), m_materialVariants.end()),
+                             m_materialVariants.end());
+
+    std::vector<uint32_t> materialVariant(m_materials.size());
+    for (size_t i = 0; i < m_materials.size(); ++i) {
+        materialVariant[i] = static_cast<uint32_t>(
+            std::lower_bound(m_materialVariants.begin(), m_materialVariants.end(), m_materials[i].features, byPass) -
+            m_materialVariants.begin());
+    }
+
+    // Primitives own their buffers, so the geometry id is just a flat primitive index
+    m_primitiveGeometry.resize(m_meshes.size());
+    uint32_t primitiveCount = 0;
+    for (size_t m = 0; m < m_meshes.size(); ++m) {
+        m_primitiveGeometry[m] = primitiveCount;
+        primitiveCount += static_cast<uint32_t>(m_meshes[m].primitives.size());
+    }
+
+    m_draws.clear();
     for (int rootIndex : m_rootNodes) {
-        if (rootIndex >= 0 && rootIndex < static_cast<int>(m_nodes.size())) {
-            drawNode(cmd, pipelineLayout, rootIndex);
-        }
+        collectDraws(rootIndex, materialVariant);
+    }
+
+    uint32_t passDraws[3] = {};
+    for (const DrawItem& item : m_draws) {
+        passDraws[static_cast<int>(featureAlphaMode(m_materialVariants[item.variant]))]++;
+    }
+    std::cout << "Material variants: " << m_materialVariants.size() << " for " << m_materials.size()
+              << " materials; draws: " << passDraws[0] << " opaque, " << passDraws[1] << " mask, "
+              << passDraws[2] << " blend" << std::endl;
+    for (MaterialFeatureFlags features : m_materialVariants) {
+        std::cout << "  " << materialFeatureName(features) << std::endl;
     }
 }
 
-void GltfModel::drawNode(VkCommandBuffer cmd,
-                          VkPipelineLayout pipelineLayout,
-                          int nodeIndex) const {
+void GltfModel::collectDraws(int nodeIndex, const std::vector<uint32_t>& materialVariant) {
     if (nodeIndex < 0 || nodeIndex >= static_cast<int>(m_nodes.size())) {
         return;
     }
 
     const GltfNode& node = m_nodes[nodeIndex];
-
-    // Draw mesh if this node has one
     if (node.meshIndex >= 0 && node.meshIndex < static_cast<int>(m_meshes.size())) {
         const GltfMesh& mesh = m_meshes[node.meshIndex];
+        for (size_t p = 0; p < mesh.primitives.size(); ++p) {
+            DrawItem item{};
+            item.nodeIndex = nodeIndex;
+            item.meshIndex = node.meshIndex;
+            item.primitiveIndex = static_cast<int>(p);
+            item.variant = materialVariant[mesh.primitives[p].materialIndex];
+            item.geometry = m_primitiveGeometry[node.meshIndex] + static_cast<uint32_t>(p);
+            m_draws.push_back(item);
+        }
+    }
 
-        for (const GltfPrimitive& primitive : mesh.primitives) {
-            // Set push constants for node index and material index
-            struct PushConstants {
-                int nodeIndex;
-                int materialIndex;
-            } pushConstants;
+    for (int childIndex : node.children) {
+        collectDraws(childIndex, materialVariant);
+    }
+}
 
-            pushConstants.nodeIndex = nodeIndex;
-            pushConstants.materialIndex = primitive.materialIndex;
+void GltfModel::sortDraws(const glm::vec3& cameraPosition, const glm::vec3& viewDirection, bool sortBlendByDepth) {
+    if (m_worldMatrices.size() != m_nodes.size()) return;
+
+    m_drawDepths.resize(m_draws.size());
+    parallelFor(m_jobs, m_draws.size(), kDrawsPerJob, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const DrawItem& item = m_draws[i];
+            const GltfPrimitive& primitive = m_meshes[item.meshIndex].primitives[item.primitiveIndex];
+            glm::vec3 center = 0.5f * (primitive.boundsMin + primitive.boundsMax);
+            glm::vec3 worldCenter = glm::vec3(m_worldMatrices[item.nodeIndex] * glm::vec4(center, 1.0f));
+            m_drawDepths[i] = glm::dot(worldCenter - cameraPosition, viewDirection);
+        }
+    });
+    float nearest = std::numeric_limits<float>::max();
+    float farthest = std::numeric_limits<float>::lowest();
+    for (float depth : m_drawDepths) {
+        nearest = std::min(nearest, depth);
+        farthest = std::max(farthest, depth);
+    }
+
+    // Depth is quantized over this frame's range. Opaque and mask draws keep
+    // their pipeline/material/buffer runs and go front-to-back inside each, so
+    // early-Z rejects most hidden fragments; blend draws go strictly
+    // back-to-front, as compositing needs (see DrawList.h).
+    float depthScale = farthest > nearest ? 1.0f / (farthest - nearest) : 0.0f;
+    m_drawList.resize(m_draws.size());
+    parallelFor(m_jobs, m_draws.size(), kDrawsPerJob, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const DrawItem& item = m_draws[i];
+            AlphaMode pass = featureAlphaMode(m_materialVariants[item.variant]);
+            int materialIndex = m_meshes[item.meshIndex].primitives[item.primitiveIndex].materialIndex;
+            bool backToFront = pass == AlphaMode::Blend && sortBlendByDepth;
+            uint64_t key = drawkey::make(static_cast<uint32_t>(pass), item.variant,
+                                         static_cast<uint32_t>(materialIndex), item.geometry,
+                                         (m_drawDepths[i] - nearest) * depthScale, backToFront);
+            m_drawList.set(i, key, static_cast<uint32_t>(i));
+        }
+    });
+    m_drawList.sort();
 
-            vkCmdPushConstants(cmd, pipelineLayout,
-                               VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                               0, sizeof(PushConstants), &pushConstants);
+    if (!m_pendingFullUploads.empty()) {
+        updateTexturePriorities(cameraPosition);
+    }
+}
 
-            primitive.draw(cmd);
+void GltfModel::updateTexturePriorities(const glm::vec3& cameraPosition) {
+    // A texture ranks by its nearest draw; textures sharing an image upload
+    // under the owner's index, so they rank there
+    m_texturePriority.assign(m_textures.size(), std::numeric_limits<float>::max());
+    for (size_t i = 0; i < m_draws.size(); ++i) {
+        const DrawItem& item = m_draws[i];
+        const GltfPrimitive& primitive = m_meshes[item.meshIndex].primitives[item.primitiveIndex];
+        glm::vec3 center = 0.5f * (primitive.boundsMin + primitive.boundsMax);
+        glm::vec3 worldCenter = glm::vec3(m_worldMatrices[item.nodeIndex] * glm::vec4(center, 1.0f));
+        float priority = glm::length(worldCenter - cameraPosition);
+        if (m_drawDepths[i] < 0.0f) priority += kBehindCameraPriority;
+
+        const GltfMaterial& material = m_materials[primitive.materialIndex];
+        for (int textureIndex : { material.baseColorTextureIndex, material.metallicRoughnessTextureIndex,
+                                  material.normalTextureIndex, material.occlusionTextureIndex,
+                                  material.emissiveTextureIndex }) {
+            if (textureIndex < 0 || textureIndex >= static_cast<int>(m_texturePriority.size())) continue;
+            float& ranked = m_texturePriority[m_sharedImageTexture[textureIndex]];
+            ranked = std::min(ranked, priority);
         }
     }
+}
 
-    // Recursively draw children
-    for (int childIndex : node.children) {
-        drawNode(cmd, pipelineLayout, childIndex);
+void GltfModel::draw(VkCommandBuffer cmd,
+                      VkPipelineLayout pipelineLayout,
+                      const std::vector<VkPipeline>& variantPipelines,
+                      uint32_t currentFrame,
+                      uint32_t passes,
+                      size_t firstEntry,
+                      size_t lastEntry) const {
+    // Set push constants for node index and material index
+    struct PushConstants {
+        int nodeIndex;
+        int materialIndex;
+    } pushConstants;
+
+    // Linear walk of the sorted list; pipelines and vertex/index buffers are
+    // only bound when they change from the previous draw
+    const std::vector<DrawList::Entry>& entries = m_drawList.entries();
+    lastEntry = std::min(lastEntry, entries.size());
+    uint32_t boundVariant = UINT32_MAX;
+    uint32_t boundGeometry = UINT32_MAX;
+    for (size_t i = firstEntry; i < lastEntry; ++i) {
+        const DrawItem& item = m_draws[entries[i].draw];
+        if (!(passes & (1u << static_cast<uint32_t>(featureAlphaMode(m_materialVariants[item.variant]))))) {
+            continue;
+        }
+        if (item.variant != boundVariant) {
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, variantPipelines[item.variant]);
+            boundVariant = item.variant;
+        }
+
+        const GltfPrimitive& primitive = m_meshes[item.meshIndex].primitives[item.primitiveIndex];
+
+        pushConstants.nodeIndex = item.nodeIndex;
+        pushConstants.materialIndex = primitive.materialIndex;
+
+        vkCmdPushConstants(cmd, pipelineLayout,
+                           VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                           0, sizeof(PushConstants), &pushConstants);
+
+        primitive.draw(cmd, GltfPrimitive::VertexStream::Full, item.geometry != boundGeometry);
+        boundGeometry = item.geometry;
+    }
+}
+
+bool GltfModel::hasBlendDraws() const {
+    // Blend keys sort last
+    return !m_drawList.entries().empty() &&
+           featureAlphaMode(m_materialVariants[m_draws[m_drawList.entries().back().draw].variant]) == AlphaMode::Blend;
+}
+
+size_t GltfModel::firstBlendEntry() const {
+    const std::vector<DrawList::Entry>& entries = m_drawList.entries();
+    auto firstBlend = std::partition_point(entries.begin(), entries.end(), [this](const DrawList::Entry& entry) {
+        return featureAlphaMode(m_materialVariants[m_draws[entry.draw].variant]) != AlphaMode::Blend;
+    });
+    return static_cast<size_t>(firstBlend - entries.begin());
+}
+
+void GltfModel::drawDepthPrepass(VkCommandBuffer cmd,
+                                 VkPipelineLayout pipelineLayout,
+                                 const DepthPipelines& depthPipelines,
+                                 size_t firstEntry,
+                                 size_t lastEntry) const {
+    struct PushConstants {
+        int nodeIndex;
+        int materialIndex;
+    } pushConstants;
+
+    // Opaque then mask keys sort first, so the walk stops at the first blend
+    // draw. Opaque draws read the position stream; mask draws read
+    // position+UV for the alpha test, or are left to the main pass when the
+    // primitive has no such stream.
+    const std::vector<DrawList::Entry>& entries = m_drawList.entries();
+    lastEntry = std::min(lastEntry, entries.size());
+    VkPipeline boundPipeline = VK_NULL_HANDLE;
+    uint32_t boundGeometry = UINT32_MAX;
+    for (size_t i = firstEntry; i < lastEntry; ++i) {
+        const DrawItem& item = m_draws[entries[i].draw];
+        MaterialFeatureFlags features = m_materialVariants[item.variant];
+        AlphaMode pass = featureAlphaMode(features);
+        if (pass == AlphaMode::Blend) {
+            break;
+        }
+
+        const GltfPrimitive& primitive = m_meshes[item.meshIndex].primitives[item.primitiveIndex];
+        bool masked = pass == AlphaMode::Mask;
+        if (masked && !primitive.hasPositionUvStream()) {
+            continue;
+        }
+
+        int pipelineIndex = (masked ? DEPTH_PIPELINE_MASK : DEPTH_PIPELINE_OPAQUE) +
+                            ((features & MATERIAL_FEATURE_DOUBLE_SIDED) ? 1 : 0);
+        VkPipeline pipeline = depthPipelines[pipelineIndex];
+        if (pipeline != boundPipeline) {
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+            boundPipeline = pipeline;
+        }
+
+        pushConstants.nodeIndex = item.nodeIndex;
+        pushConstants.materialIndex = primitive.materialIndex;
+
+        vkCmdPushConstants(cmd, pipelineLayout,
+                           VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                           0, sizeof(PushConstants), &pushConstants);
+
+        primitive.draw(cmd,
+                       masked ? GltfPrimitive::VertexStream::PositionUv : GltfPrimitive::VertexStream::Position,
+                       item.geometry != boundGeometry);
+        boundGeometry = item.geometry;
+    }
+}
+
+// ============================================================================
+// Job Scaling Benchmark
+// ============================================================================
+
+void GltfModel::benchmarkJobScaling(const std::string& modelPath) {
+    using Clock = std::chrono::steady_clock;
+    auto msSince = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+
+    std::vector<uint32_t> threadCounts;
+    const uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (uint32_t threads = 1; threads < hardwareThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(hardwareThreads);
+
+    // Synthetic frame: 100 roots x 10 children x 50 leaves, one draw per leaf
+    constexpr int kRoots = 100, kChildren = 10, kLeaves = 50;
+    GltfModel scene;
+    scene.m_nodeLevels.resize(3);
+    auto addNode = [&](int parent, uint32_t level, int n) {
+        GltfNode node;
+        node.index = static_cast<int>(scene.m_nodes.size());
+        node.parent = parent;
+        node.translation = glm::vec3(static_cast<float>(n % 7), static_cast<float>(n % 5), static_cast<float>(n % 3));
+        node.rotation = glm::angleAxis(0.01f * static_cast<float>(n), glm::vec3(0.0f, 1.0f, 0.0f));
+        scene.m_nodeLevels[level].push_back(static_cast<uint32_t>(node.index));
+        scene.m_nodes.push_back(node);
+        return node.index;
+    };
+    scene.m_meshes.resize(1);
+    scene.m_meshes[0].primitives.resize(1);
+    scene.m_meshes[0].primitives[0].materialIndex = 0;
+    scene.m_meshes[0].primitives[0].boundsMin = glm::vec3(-0.5f);
+    scene.m_meshes[0].primitives[0].boundsMax = glm::vec3(0.5f);
+    scene.m_materials.push_back(GltfMaterial());
+    scene.m_materialVariants.push_back(scene.m_materials[0].features);
+    for (int r = 0; r < kRoots; ++r) {
+        int root = addNode(-1, 0, r);
+        for (int c = 0; c < kChildren; ++c) {
+            int child = addNode(root, 1, c);
+            for (int l = 0; l < kLeaves; ++l) {
+                int leaf = addNode(child, 2, l);
+                scene.m_draws.push_back({ leaf, 0, 0, 0, 0 });
+            }
+        }
+    }
+
+    std::cout << "Job scaling: parse() of " << modelPath << ", and transforms + draw keys for "
+              << scene.m_draws.size() << " draws (" << scene.m_nodes.size() << " nodes)" << std::endl;
+
+    struct Result {
+        uint32_t threads;
+        double loadMs;    // < 0: the model could not be parsed
+        double frameMs;
+    };
+    std::vector<Result> results;
+    bool canParse = !modelPath.empty();
+    for (uint32_t threads : threadCounts) {
+        JobSystem jobs;
+        jobs.start(threads);
+
+        double loadMs = -1.0;
+        if (canParse) {
+            try {
+                // The first run also warms the file cache for the others
+                if (results.empty()) GltfModel().parse(modelPath, &jobs);
+                auto start = Clock::now();
+                GltfModel model;
+                model.parse(modelPath, &jobs);
+                loadMs = msSince(start);
+            } catch (const std::exception& e) {
+                std::cerr << "Skipping the loader benchmark: " << e.what() << std::endl;
+                canParse = false;
+            }
+        }
+
+        constexpr int kWarmup = 10, kFrames = 200;
+        scene.m_jobs = &jobs;
+        glm::vec3 cameraPosition(0.0f, 2.0f, -20.0f);
+        glm::vec3 viewDirection(0.0f, 0.0f, 1.0f);
+        for (int i = 0; i < kWarmup; ++i) {
+            scene.updateWorldMatrices();
+            scene.sortDraws(cameraPosition, viewDirection);
+        }
+        auto start = Clock::now();
+        for (int i = 0; i < kFrames; ++i) {
+            scene.updateWorldMatrices();
+            scene.sortDraws(cameraPosition, viewDirection);
+        }
+        double frameMs = msSince(start) / kFrames;
+        scene.m_jobs = nullptr;
+
+        results.push_back({ threads, loadMs, frameMs });
+    }
+
+    std::cout << std::setw(10) << "threads" << std::setw(12) << "parse ms" << std::setw(10) << "speedup"
+              << std::setw(12) << "frame ms" << std::setw(10) << "speedup" << std::endl;
+    const Result& base = results.front();
+    for (const Result& result : results) {
+        std::cout << std::setw(10) << result.threads << std::fixed;
+        if (result.loadMs >= 0.0 && base.loadMs >= 0.0) {
+            std::cout << std::setprecision(1) << std::setw(12) << result.loadMs
+                      << std::setprecision(2) << std::setw(9) << base.loadMs / result.loadMs << "x";
+        } else {
+            std::cout << std::setw(12) << "-" << std::setw(10) << "-";
+        }
+        std::cout << std::setprecision(3) << std::setw(12) << result.frameMs
+                  << std::setprecision(2) << std::setw(9) << base.frameMs / result.frameMs << "x" << std::endl;
+        std::cout.unsetf(std::ios::fixed);
     }
 }
@@ -4,12 +4,28 @@
 #include "GltfMaterial.h"
 #include "GltfVertex.h"
 #include "Texture.h"
+#include "TextureCooker.h"
+#include "TextureBudget.h"
+#include "TextureStreamer.h"
+#include "TextureResidency.h"
 #include "Buffer.h"
 #include "Device.h"
+#include "BindlessTextureHeap.h"
+#include "SamplerCache.h"
+#include "DrawList.h"
+#include "JobSystem.h"
+#include "UploadScheduler.h"
 #include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
+class AsyncQueue;
+class DeletionQueue;
+class MipGenerator;
+
 // Forward declare tinygltf types to avoid including in header
 namespace tinygltf {
     class Model;
@@ -17,6 +33,14 @@ namespace tinygltf {
     struct Accessor;
 }
 
+// Texture processing settings applied while loading a model
+struct GltfLoadOptions {
+    TextureCookOptions textureCook;
+    TextureBudgetSettings textureBudget;
+    bool streamTextures = true;   // start on placeholders and stream textures in after load
+    bool textureFeedback = true;  // let shader feedback pick resident mips (needs streamTextures)
+};
+
 // ============================================================================
 // glTF Model Loader and Manager
 // Main class for loading and rendering glTF 2.0 models
@@ -24,40 +48,159 @@ namespace tinygltf {
 
 class GltfModel {
 public:
-    GltfModel() = default;
-    ~GltfModel() = default;
+    GltfModel();
+    ~GltfModel();
+
+    GltfModel(const GltfModel&) = delete;
+    GltfModel& operator=(const GltfModel&) = delete;
 
-    // Load glTF model from file (.gltf or .glb)
+    // Load glTF model from file (.gltf or .glb). Textures are registered in
+    // `textureHeap` and their samplers come from `samplerCache`; both must
+    // outlive the model, as must `mipGenerator` (optional, for GPU-built mip
+    // chains) and `transferQueue` (optional: geometry and streamed textures
+    // upload there instead of on `queue`). Materials refer to textures by
+    // heap handle. `jobs` (optional, must outlive the model too) spreads
+    // mesh extraction, texture cooking and the per-frame transform and
+    // draw-key work over its threads.
     void loadFromFile(const Device& device,
                       VkCommandPool cmdPool,
                       VkQueue queue,
-                      const std::string& filename);
+                      BindlessTextureHeap& textureHeap,
+                      SamplerCache& samplerCache,
+                      MipGenerator* mipGenerator,
+                      AsyncQueue* transferQueue,
+                      const std::string& filename,
+                      const GltfLoadOptions& options = {},
+                      JobSystem* jobs = nullptr);
 
-    // Destroy all GPU resources
+    // loadFromFile() in two halves, for loading while frames are rendered.
+    // parse() is the CPU side (file I/O, deduplication, vertex extraction)
+    // and touches no Vulkan object, so it may run on any thread. upload()
+    // then creates the GPU resources in small steps on the render thread,
+    // each charged to `scheduler` and taken only while its frame budget
+    // lasts (all of them without one), and returns true once the model is
+    // complete; isLoaded() stays false until then.
+    void parse(const std::string& filename, JobSystem* jobs = nullptr);
+    bool upload(const Device& device,
+                VkCommandPool cmdPool,
+                VkQueue queue,
+                BindlessTextureHeap& textureHeap,
+                SamplerCache& samplerCache,
+                MipGenerator* mipGenerator,
+                AsyncQueue* transferQueue,
+                const GltfLoadOptions& options,
+                UploadScheduler* scheduler);
+
+    // Destroy all GPU resources, now or once the frame timeline reaches
+    // `value` (SyncObjects::submittedValue() when frames may still draw it)
     void destroy(const Device& device);
+    void retire(const Device& device, DeletionQueue& deletionQueue, uint64_t value);
+
+    // Build and radix-sort this frame's draw keys: opaque, then mask draws
+    // grouped by pipeline, material and buffers and front-to-back inside a
+    // group, then blend draws back-to-front. Order-independent blending
+    // (sortBlendByDepth = false) groups blend draws like opaque ones instead.
+    // While textures stream, also ranks them by distance for the upload
+    // scheduler. Call after updateTransforms().
+    void sortDraws(const glm::vec3& cameraPosition, const glm::vec3& viewDirection, bool sortBlendByDepth = true);
 
-    // Render the model
+    // Which alpha-mode passes a draw() call records
+    enum DrawPassBits : uint32_t {
+        DRAW_PASS_OPAQUE = 1u << static_cast<uint32_t>(AlphaMode::Opaque),
+        DRAW_PASS_MASK = 1u << static_cast<uint32_t>(AlphaMode::Mask),
+        DRAW_PASS_BLEND = 1u << static_cast<uint32_t>(AlphaMode::Blend),
+        DRAW_PASS_ALL = DRAW_PASS_OPAQUE | DRAW_PASS_MASK | DRAW_PASS_BLEND
+    };
+
+    // Record the draws of `passes` in sorted order: variantPipelines[i] is
+    // the pipeline built for getMaterialVariants()[i]. [firstEntry,
+    // lastEntry) limits the walk to a slice of the sorted draw list, so
+    // slices can be recorded into separate command buffers; each slice binds
+    // its own pipeline and vertex buffers.
     void draw(VkCommandBuffer cmd,
               VkPipelineLayout pipelineLayout,
-              uint32_t currentFrame) const;
+              const std::vector<VkPipeline>& variantPipelines,
+              uint32_t currentFrame,
+              uint32_t passes = DRAW_PASS_ALL,
+              size_t firstEntry = 0,
+              size_t lastEntry = SIZE_MAX) const;
+
+    // True if this frame's draw list has any blend draw
+    bool hasBlendDraws() const;
+
+    // This frame's sorted draw list: its length, and the index of its first
+    // blend draw (blend keys sort last; the length if there is none)
+    size_t drawListSize() const { return m_drawList.size(); }
+    size_t firstBlendEntry() const;
+
+    // Depth pre-pass pipelines: opaque ones read the position stream, mask
+    // ones the position+UV stream with an alpha-test fragment shader
+    enum DepthPipeline {
+        DEPTH_PIPELINE_OPAQUE = 0,
+        DEPTH_PIPELINE_OPAQUE_DOUBLE_SIDED,
+        DEPTH_PIPELINE_MASK,
+        DEPTH_PIPELINE_MASK_DOUBLE_SIDED,
+        DEPTH_PIPELINE_COUNT
+    };
+    using DepthPipelines = std::array<VkPipeline, DEPTH_PIPELINE_COUNT>;
+
+    // Record the opaque and alpha-tested draws depth-only, in the same order
+    // as draw(); blend draws (and mask primitives without a position+UV
+    // stream) are left to the main pass
+    void drawDepthPrepass(VkCommandBuffer cmd,
+                          VkPipelineLayout pipelineLayout,
+                          const DepthPipelines& depthPipelines,
+                          size_t firstEntry = 0,
+                          size_t lastEntry = SIZE_MAX) const;
 
     // Update all node world transforms (call before rendering if nodes changed)
     void updateTransforms(const Device& device);
 
+    // Upload textures finished by the streaming thread and apply residency
+    // changes, swapping the new images into their heap slots. Call once per
+    // frame after frame slot `frame`'s timeline wait, before the scheduler's
+    // runQueued() and the heap's beginFrame(). Previews go up at once;
+    // residency changes take what is left of the scheduler's frame budget;
+    // full chains are queued on it, nearest to the camera first. Replaced
+    // textures retire through `uploadFrame`'s deletion queue.
+    void updateStreaming(const UploadFrame& uploadFrame,
+                         UploadScheduler& scheduler,
+                         uint32_t framesInFlight,
+                         uint32_t frame);
+
+    // Feed frame slot `frame`'s readback from TextureFeedback, indexed by heap
+    // slot (mips relative to the images that frame had bound). Call before
+    // updateStreaming().
+    void applyTextureFeedback(uint32_t frame, const std::vector<uint32_t>& minMips);
+
+    // All textures have streamed in at their budgeted resolution
+    bool isStreamingComplete() const { return m_streamingComplete; }
+    bool usesTextureFeedback() const { return m_residencyEnabled; }
+
     // Accessors
     const std::vector<GltfNode>& getNodes() const { return m_nodes; }
     const std::vector<GltfMesh>& getMeshes() const { return m_meshes; }
     const std::vector<GltfMaterial>& getMaterials() const { return m_materials; }
     const std::vector<Texture>& getTextures() const { return m_textures; }
+    const std::vector<uint32_t>& getTextureSlots() const { return m_textureSlots; }
     const std::vector<int>& getRootNodes() const { return m_rootNodes; }
 
+    // Distinct material feature sets in use, one pipeline each, ordered by
+    // pass (opaque, mask, blend)
+    const std::vector<MaterialFeatureFlags>& getMaterialVariants() const { return m_materialVariants; }
+
     // Buffer accessors
     VkBuffer getMaterialBuffer() const { return m_materialBuffer.get(); }
     VkBuffer getTransformBuffer() const { return m_transformBuffer.get(); }
 
     // Model info
     std::string getModelPath() const { return m_modelPath; }
-    bool isLoaded() const { return !m_nodes.empty(); }
+    bool isLoaded() const { return !m_nodes.empty() && !m_pending; }
+
+    // Time parse() of `modelPath` and a frame's updateTransforms() and
+    // sortDraws() CPU work on a synthetic 50k-draw scene at 1..N job threads
+    // and print the speedups (run with --benchmark-jobs)
+    static void benchmarkJobScaling(const std::string& modelPath);
 
 private:
     // Scene data
@@ -66,7 +209,65 @@ private:
     std::vector<GltfMesh> m_meshes;
     std::vector<GltfMaterial> m_materials;
     std::vector<Texture> m_textures;
-    std::vector<VkSampler> m_samplers;
+    std::vector<uint32_t> m_textureSlots;          // bindless heap image slot of each texture
+    std::vector<int32_t> m_textureHandles;         // image + sampler slot, as stored in materials
+    BindlessTextureHeap* m_textureHeap = nullptr;
+    MipGenerator* m_mipGenerator = nullptr;
+    AsyncQueue* m_transferQueue = nullptr;
+    std::vector<VkSampler> m_samplers;             // per glTF sampler, owned by the SamplerCache
+    std::vector<VkSampler> m_textureSamplers;      // per texture: its glTF sampler or the default
+    std::vector<int> m_packedOcclusionSource;  // per texture: occlusion texture merged into R, or -1
+    std::vector<int> m_sharedImageTexture;     // per texture: texture whose GPU image it uses (itself if unique)
+    std::vector<int> m_materialRemap;          // per glTF material: index into the deduplicated m_materials
+
+    // One entry per (node, primitive), collected once after loading (the
+    // node hierarchy is static); sortDraws() keys them into m_drawList
+    // every frame and draw() records that list in order
+    struct DrawItem {
+        int nodeIndex;
+        int meshIndex;
+        int primitiveIndex;
+        uint32_t variant;     // index into m_materialVariants
+        uint32_t geometry;    // identifies the vertex/index buffers
+    };
+    std::vector<MaterialFeatureFlags> m_materialVariants;
+    std::vector<DrawItem> m_draws;
+    std::vector<uint32_t> m_primitiveGeometry;  // per mesh: geometry id of its first primitive
+    DrawList m_drawList;
+    std::vector<float> m_drawDepths;            // sortDraws() scratch, per draw
+    std::vector<std::vector<uint32_t>> m_nodeLevels;  // node indices by depth in the hierarchy
+    JobSystem* m_jobs = nullptr;
+    std::vector<glm::mat4> m_worldMatrices;     // from the last updateTransforms()
+
+    // Content-hash deduplication results, printed with the load report
+    struct DedupStats {
+        uint32_t images = 0;          // images with the same payload as an earlier one
+        uint64_t imageBytes = 0;      // their encoded bytes
+        uint32_t textures = 0;        // textures using another texture's GPU image
+        uint64_t textureBytes = 0;    // RGBA8 texels not decoded and cooked again
+        uint32_t materials = 0;       // materials identical to an earlier one on the GPU
+    };
+    DedupStats m_dedup;
+
+    // Texture streaming
+    TextureStreamer m_textureStreamer;
+    std::vector<StreamedTexture> m_pendingFullUploads;  // preview is shown, full chain queued for upload
+    bool m_streamingComplete = true;
+    UploadScheduler* m_uploadScheduler = nullptr;       // holds the queued full chains
+    // Per texture: distance from the camera to the nearest draw using it as
+    // of the last sortDraws(), draws behind the camera counting as farther
+    // than any in front; the order queued full chains upload in
+    std::vector<float> m_texturePriority;
+
+    // Feedback-driven residency; keeps each streamed texture's cooked chain
+    // in system memory so evicted mips can be uploaded again
+    bool m_residencyEnabled = false;
+    TextureResidency m_residency;
+    std::vector<CookedTexture> m_cookedTextures;
+    std::vector<uint32_t> m_residentTopLevel;            // cooked-chain level of each bound image's level 0
+    std::vector<std::vector<uint32_t>> m_frameTopLevel;  // m_residentTopLevel as bound by each frame slot
+    uint64_t m_frameNumber = 0;
+    uint64_t m_lastResidencyReport = 0;
 
     // GPU buffers
     Buffer m_materialBuffer;   // Storage buffer: array of MaterialData
@@ -75,27 +276,78 @@ private:
     // Model info
     std::string m_modelPath;
 
+    // Between parse() and the end of upload(): the parsed document, its
+    // still-encoded images, extracted geometry and upload progress
+    struct PendingLoad;
+    std::unique_ptr<PendingLoad> m_pending;
+
+    // destroy() without a queue, retire() with one
+    void release(const Device& device, DeletionQueue* deletionQueue, uint64_t value);
+
+    // upload() steps besides the per-primitive ones. Textures take one step
+    // each: planTextures() sizes and (without streaming) starts cooking them,
+    // uploadNextTexture() places one texture or placeholder, and
+    // finishTextures() starts the streamer and fills the heap slots.
+    void planTextures(const Device& device,
+                      BindlessTextureHeap& textureHeap,
+                      SamplerCache& samplerCache,
+                      MipGenerator* mipGenerator,
+                      AsyncQueue* transferQueue,
+                      const GltfLoadOptions& options);
+    bool nextTextureCooked(bool wait) const;
+    uint64_t nextTextureBytes(bool streaming) const;
+    void uploadNextTexture(const Device& device, VkCommandPool cmdPool, VkQueue queue, bool streaming);
+    void finishTextures(const Device& device, SamplerCache& samplerCache, const GltfLoadOptions& options);
+    void finishUpload(const Device& device);
+
+    // Streaming: bind a new image for a texture, retiring the old one
+    void swapInTexture(const UploadFrame& uploadFrame, uint32_t textureIndex,
+                       const Texture& texture, uint32_t topLevel);
+    // Queued by updateStreaming(): the full chain behind a shown preview
+    void uploadFullChain(const UploadFrame& uploadFrame, uint32_t textureIndex);
+    void updateTexturePriorities(const glm::vec3& cameraPosition);
+
     // Loading helper methods
-    void loadTextures(const tinygltf::Model& model,
-                      const Device& device,
-                      VkCommandPool cmdPool,
-                      VkQueue queue,
-                      const std::string& baseDir,
-                      const std::vector<bool>& isColorTexture);
 
-    void loadSamplers(const tinygltf::Model& model, const Device& device);
+    // Content-hash deduplication: identical image payloads share one
+    // EncodedImage, textures with the same image content share one GPU image
+    // (each keeps its own sampler), identical materials share one slot
+    void deduplicateImages(std::vector<std::shared_ptr<EncodedImage>>& images,
+                           const std::vector<uint64_t>& hashes);
+    void deduplicateTextures(const tinygltf::Model& model,
+                             const std::vector<std::shared_ptr<EncodedImage>>& images);
+    void deduplicateMaterials();
+
+    // Material data as the shader sees it (texture indices become heap handles)
+    MaterialData gpuMaterialData(const MaterialData& data) const;
+
+    // Decide which occlusion maps get merged into a metallic-roughness texture
+    void planOrmPacking(const tinygltf::Model& model,
+                        const std::vector<std::shared_ptr<EncodedImage>>& images);
+    int resolveOcclusionTexture(int occlusionIndex, int metallicRoughnessIndex) const;
+
+    void loadSamplers(const tinygltf::Model& model, const Device& device, SamplerCache& samplerCache);
 
     void loadMaterials(const tinygltf::Model& model);
 
-    void loadMeshes(const tinygltf::Model& model,
-                    const Device& device,
-                    VkCommandPool cmdPool,
-                    VkQueue queue);
+    // parse() between loading the document and its nodes: images, textures
+    // and materials, while the mesh jobs run
+    void parseImagesAndMaterials(const tinygltf::Model& model, const std::string& baseDir);
+
+    // Extract every primitive's vertices and indices into m_pending, one job
+    // per mesh counted by `extracted` (inline without a job system)
+    void loadMeshes(const tinygltf::Model& model, JobCounter& extracted);
+
+    // Create the GPU buffers of m_pending's next primitive
+    void uploadNextPrimitive(const Device& device, VkCommandPool cmdPool, VkQueue queue);
 
     void loadNodes(const tinygltf::Model& model);
 
     void createMaterialBuffer(const Device& device);
+    void buildDrawLists();
+    void collectDraws(int nodeIndex, const std::vector<uint32_t>& materialVariant);
     void createTransformBuffer(const Device& device);
+    void updateWorldMatrices();
 
     // Vertex extraction from glTF buffers
     void extractVertexData(const tinygltf::Model& model,
@@ -113,8 +365,4 @@ private:
     void generateTangents(std::vector<GltfVertex>& vertices,
                           const std::vector<uint32_t>& indices);
 
-    // Rendering helpers
-    void drawNode(VkCommandBuffer cmd,
-                  VkPipelineLayout pipelineLayout,
-                  int nodeIndex) const;
 };
@@ -1,11 +1,14 @@
 #include "GltfPrimitive.h"
+#include <algorithm>
 #include <stdexcept>
 
 void GltfPrimitive::create(const Device& device,
                             VkCommandPool cmdPool,
                             VkQueue queue,
+                            AsyncQueue* uploadQueue,
                             const std::vector<GltfVertex>& vertices,
-                            const std::vector<uint32_t>& indices) {
+                            const std::vector<uint32_t>& indices,
+                            int alphaTestTexCoord) {
     if (vertices.empty() || indices.empty()) {
         throw std::runtime_error("GltfPrimitive: Cannot create with empty vertex or index data");
     }
@@ -13,21 +16,63 @@ void GltfPrimitive::create(const Device& device,
     vertexCount = static_cast<uint32_t>(vertices.size());
     indexCount = static_cast<uint32_t>(indices.size());
 
+    boundsMin = boundsMax = vertices[0].pos;
+    for (const GltfVertex& vertex : vertices) {
+        boundsMin = glm::min(boundsMin, vertex.pos);
+        boundsMax = glm::max(boundsMax, vertex.pos);
+    }
+
     // Create vertex buffer
     VkDeviceSize vertexBufferSize = sizeof(GltfVertex) * vertices.size();
-    vertexBuffer.createFrom(device, cmdPool, queue, vertices.data(), vertexBufferSize);
+    vertexBuffer.createFrom(device, cmdPool, queue, vertices.data(), vertexBufferSize, uploadQueue);
+
+    // Packed streams for passes that need only positions (and the alpha UV)
+    std::vector<GltfPositionVertex> positions(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        positions[i].pos = vertices[i].pos;
+    }
+    positionBuffer.createFromVector(device, cmdPool, queue, positions, uploadQueue);
+
+    m_hasPositionUvStream = alphaTestTexCoord >= 0 &&
+        std::all_of(vertices.begin(), vertices.end(), [](const GltfVertex& v) { return v.color.a == 1.0f; });
+    if (m_hasPositionUvStream) {
+        std::vector<GltfPositionUvVertex> positionUvs(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            positionUvs[i].pos = vertices[i].pos;
+            positionUvs[i].texCoord = alphaTestTexCoord == 1 ? vertices[i].texCoord1 : vertices[i].texCoord0;
+        }
+        positionUvBuffer.createFromVector(device, cmdPool, queue, positionUvs, uploadQueue);
+    }
 
     // Create index buffer
-    indexBuffer.createFromVector(device, cmdPool, queue, indices);
+    indexBuffer.createFromVector(device, cmdPool, queue, indices, uploadQueue);
 }
 
 void GltfPrimitive::destroy(const Device& device) {
-    vertexBuffer.destroy(device);
-    indexBuffer.destroy(device);
+    release(device, nullptr, 0);
+}
+
+void GltfPrimitive::retire(const Device& device, DeletionQueue& deletionQueue, uint64_t value) {
+    release(device, &deletionQueue, value);
+}
+
+void GltfPrimitive::release(const Device& device, DeletionQueue* deletionQueue, uint64_t value) {
+    auto releaseBuffer = [&](auto& buffer) {
+        if (deletionQueue) {
+            buffer.retire(device, *deletionQueue, value);
+        } else {
+            buffer.destroy(device);
+        }
+    };
+    releaseBuffer(vertexBuffer);
+    releaseBuffer(positionBuffer);
+    releaseBuffer(positionUvBuffer);
+    m_hasPositionUvStream = false;
+    releaseBuffer(indexBuffer);
 
     // Destroy morph target buffers if any
     for (auto& morphBuffer : morphTargetBuffers) {
-        morphBuffer.destroy(device);
+        releaseBuffer(morphBuffer);
     }
     morphTargetBuffers.clear();
     morphWeights.clear();
@@ -36,18 +81,23 @@ void GltfPrimitive::destroy(const Device& device) {
     indexCount = 0;
 }
 
-void GltfPrimitive::draw(VkCommandBuffer cmd) const {
+void GltfPrimitive::draw(VkCommandBuffer cmd, VertexStream stream, bool bindBuffers) const {
     if (!isValid()) {
         return;
     }
 
-    // Bind vertex buffer
-    VkBuffer vertexBuffers[] = { vertexBuffer.get() };
-    VkDeviceSize offsets[] = { 0 };
-    vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, offsets);
+    if (bindBuffers) {
+        // Bind the requested vertex stream
+        const VertexBuffer& source = stream == VertexStream::Position   ? positionBuffer
+                                   : stream == VertexStream::PositionUv ? positionUvBuffer
+                                                                        : vertexBuffer;
+        VkBuffer vertexBuffers[] = { source.get() };
+        VkDeviceSize offsets[] = { 0 };
+        vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, offsets);
 
-    // Bind index buffer
-    vkCmdBindIndexBuffer(cmd, indexBuffer.get(), 0, VK_INDEX_TYPE_UINT32);
+        // Bind index buffer
+        vkCmdBindIndexBuffer(cmd, indexBuffer.get(), 0, VK_INDEX_TYPE_UINT32);
+    }
 
     // Draw indexed
     vkCmdDrawIndexed(cmd, indexCount, 1, firstIndex, vertexOffset, 0);
@@ -6,6 +6,8 @@
 #include <vector>
 #include <cstdint>
 
+class DeletionQueue;
+
 // ============================================================================
 // glTF Primitive
 // Represents a single drawable geometry unit with a material
@@ -14,8 +16,17 @@
 
 class GltfPrimitive {
 public:
+    // Which vertex stream a draw reads; every stream shares indexBuffer
+    enum class VertexStream {
+        Full,         // vertexBuffer: GltfVertex
+        Position,     // positionBuffer: GltfPositionVertex
+        PositionUv    // positionUvBuffer: GltfPositionUvVertex
+    };
+
     // Geometry buffers
     VertexBuffer vertexBuffer;
+    VertexBuffer positionBuffer;     // always present
+    VertexBuffer positionUvBuffer;   // alpha-tested primitives only, see create()
     IndexBuffer indexBuffer;
 
     uint32_t vertexCount = 0;
@@ -26,23 +37,41 @@ public:
     // Material reference
     int materialIndex = -1;  // Index into model's material array
 
+    // Object-space bounding box of the vertices (for draw sorting)
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+
     // Morph targets (for blend shapes - future use)
     std::vector<VertexBuffer> morphTargetBuffers;
     std::vector<float> morphWeights;
 
-    // Create primitive from vertex/index data
+    // Create primitive from vertex/index data, uploaded on `uploadQueue` when
+    // given. alphaTestTexCoord >= 0 also packs that UV set into
+    // positionUvBuffer, unless the vertex colors carry alpha (which the
+    // packed stream cannot reproduce).
     void create(const Device& device,
                 VkCommandPool cmdPool,
                 VkQueue queue,
+                AsyncQueue* uploadQueue,
                 const std::vector<GltfVertex>& vertices,
-                const std::vector<uint32_t>& indices);
+                const std::vector<uint32_t>& indices,
+                int alphaTestTexCoord = -1);
 
-    // Destroy GPU resources
+    // Destroy GPU resources, now or once the frame timeline reaches `value`
     void destroy(const Device& device);
+    void retire(const Device& device, DeletionQueue& deletionQueue, uint64_t value);
 
-    // Draw this primitive
-    void draw(VkCommandBuffer cmd) const;
+    // Draw this primitive from `stream`; bindBuffers = false reuses the
+    // buffers bound by the previous draw of the same primitive and stream
+    void draw(VkCommandBuffer cmd, VertexStream stream = VertexStream::Full, bool bindBuffers = true) const;
 
     // Check if primitive has valid geometry
     bool isValid() const { return vertexCount > 0 && indexCount > 0; }
+    bool hasPositionUvStream() const { return m_hasPositionUvStream; }
+
+private:
+    // destroy() without a queue, retire() with one
+    void release(const Device& device, DeletionQueue* deletionQueue, uint64_t value);
+
+    bool m_hasPositionUvStream = false;
 };
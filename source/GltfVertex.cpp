@@ -61,3 +61,49 @@ std::array<VkVertexInputAttributeDescription, 8> GltfVertex::getAttributeDescrip
 
     return attributeDescriptions;
 }
+
+VkVertexInputBindingDescription GltfPositionVertex::getBindingDescription() {
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding = 0;
+    bindingDescription.stride = sizeof(GltfPositionVertex);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    return bindingDescription;
+}
+
+std::array<VkVertexInputAttributeDescription, 1> GltfPositionVertex::getAttributeDescriptions() {
+    std::array<VkVertexInputAttributeDescription, 1> attributeDescriptions{};
+
+    // Location 0: Position
+    attributeDescriptions[0].binding = 0;
+    attributeDescriptions[0].location = 0;
+    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributeDescriptions[0].offset = offsetof(GltfPositionVertex, pos);
+
+    return attributeDescriptions;
+}
+
+VkVertexInputBindingDescription GltfPositionUvVertex::getBindingDescription() {
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding = 0;
+    bindingDescription.stride = sizeof(GltfPositionUvVertex);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    return bindingDescription;
+}
+
+std::array<VkVertexInputAttributeDescription, 2> GltfPositionUvVertex::getAttributeDescriptions() {
+    std::array<VkVertexInputAttributeDescription, 2> attributeDescriptions{};
+
+    // Location 0: Position
+    attributeDescriptions[0].binding = 0;
+    attributeDescriptions[0].location = 0;
+    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributeDescriptions[0].offset = offsetof(GltfPositionUvVertex, pos);
+
+    // Location 1: TexCoord (base color UV set)
+    attributeDescriptions[1].binding = 0;
+    attributeDescriptions[1].location = 1;
+    attributeDescriptions[1].format = VK_FORMAT_R32G32_SFLOAT;
+    attributeDescriptions[1].offset = offsetof(GltfPositionUvVertex, texCoord);
+
+    return attributeDescriptions;
+}
@@ -38,6 +38,31 @@ struct GltfVertex {
     }
 };
 
+// ============================================================================
+// Reduced Vertex Streams
+// Tightly packed copies of the attributes that depth-style passes read, so
+// they fetch 12 or 20 bytes per vertex instead of the full 104-byte GltfVertex
+// ============================================================================
+
+struct GltfPositionVertex {
+    glm::vec3 pos;
+
+    static VkVertexInputBindingDescription getBindingDescription();
+    static std::array<VkVertexInputAttributeDescription, 1> getAttributeDescriptions();
+};
+
+// For alpha-tested depth: texCoord is whichever UV set the base color reads
+struct GltfPositionUvVertex {
+    glm::vec3 pos;
+    glm::vec2 texCoord;
+
+    static VkVertexInputBindingDescription getBindingDescription();
+    static std::array<VkVertexInputAttributeDescription, 2> getAttributeDescriptions();
+};
+
+static_assert(sizeof(GltfPositionVertex) == 12, "position stream must stay tightly packed");
+static_assert(sizeof(GltfPositionUvVertex) == 20, "position+UV stream must stay tightly packed");
+
 // Hash function for use with unordered_map
 namespace std {
     template<> struct hash<GltfVertex> {
@@ -0,0 +1,115 @@
+// ============================================================================
+// GpuTimer.cpp - Timestamp query scopes
+// ============================================================================
+
+#include "GpuTimer.h"
+#include "Device.h"
+#include <iostream>
+#include <stdexcept>
+
+void GpuTimer::create(const Device& device, uint32_t framesInFlight, const std::vector<std::string>& scopeNames) {
+    if (scopeNames.size() > 32) {
+        throw std::runtime_error("GpuTimer: at most 32 scopes");
+    }
+    m_scopes.clear();
+    for (const std::string& name : scopeNames) {
+        m_scopes.push_back({ name });
+    }
+    m_writtenScopes.assign(framesInFlight, 0);
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device.physical(), &properties);
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device.physical(), &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(device.physical(), &familyCount, families.data());
+    uint32_t validBits = families[device.queues().graphicsFamily.value()].timestampValidBits;
+
+    if (validBits == 0 || properties.limits.timestampPeriod <= 0.0f) {
+        std::cout << "Timestamp queries unsupported on the graphics queue, GPU timings disabled" << std::endl;
+        return;
+    }
+    m_nsPerTick = properties.limits.timestampPeriod;
+    m_validMask = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1);
+
+    VkQueryPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    poolInfo.queryCount = framesInFlight * static_cast<uint32_t>(m_scopes.size()) * 2;
+
+    if (vkCreateQueryPool(device.get(), &poolInfo, nullptr, &m_pool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create timestamp query pool");
+    }
+}
+
+void GpuTimer::destroy(const Device& device) {
+    if (m_pool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(device.get(), m_pool, nullptr);
+        m_pool = VK_NULL_HANDLE;
+    }
+    m_writtenScopes.clear();
+}
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+void GpuTimer::reset(VkCommandBuffer cmd, uint32_t frame) {
+    if (!isEnabled()) return;
+
+    vkCmdResetQueryPool(cmd, m_pool, queryIndex(frame, 0), static_cast<uint32_t>(m_scopes.size()) * 2);
+    m_writtenScopes[frame] = 0;
+}
+
+void GpuTimer::begin(VkCommandBuffer cmd, uint32_t frame, uint32_t scope) {
+    if (!isEnabled()) return;
+
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_pool, queryIndex(frame, scope));
+}
+
+void GpuTimer::end(VkCommandBuffer cmd, uint32_t frame, uint32_t scope) {
+    if (!isEnabled()) return;
+
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_pool, queryIndex(frame, scope) + 1);
+    m_writtenScopes[frame] |= 1u << scope;
+}
+
+// ============================================================================
+// Readback
+// ============================================================================
+
+void GpuTimer::collect(const Device& device, uint32_t frame) {
+    if (!isEnabled() || m_writtenScopes[frame] == 0) return;
+
+    for (uint32_t scope = 0; scope < m_scopes.size(); ++scope) {
+        if (!(m_writtenScopes[frame] & (1u << scope))) continue;
+
+        uint64_t ticks[2] = {};
+        VkResult result = vkGetQueryPoolResults(device.get(), m_pool, queryIndex(frame, scope), 2,
+                                                sizeof(ticks), ticks, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+        if (result != VK_SUCCESS) continue;
+
+        Scope& target = m_scopes[scope];
+        uint64_t elapsed = ((ticks[1] & m_validMask) - (ticks[0] & m_validMask)) & m_validMask;
+        target.totalMs += static_cast<double>(elapsed) * m_nsPerTick * 1e-6;
+        target.samples++;
+        if (target.samples % kReportInterval == 0) {
+            printScope(target);
+        }
+    }
+    m_writtenScopes[frame] = 0;
+}
+
+void GpuTimer::printScope(const Scope& scope) const {
+    std::cout << "GPU " << scope.name << ": " << scope.totalMs / static_cast<double>(scope.samples)
+              << " ms avg over " << scope.samples << " frames" << std::endl;
+}
+
+void GpuTimer::printReport() const {
+    for (const Scope& scope : m_scopes) {
+        if (scope.samples > 0) {
+            printScope(scope);
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Device;
+
+// ============================================================================
+// GPU Timer
+// Named GPU time scopes from timestamp queries, two per (frame in flight,
+// scope). Results are read after the frame's timeline wait and averaged per
+// scope; a scope not written in a frame is simply not sampled, so scopes can
+// stand for alternative modes of the same work (e.g. sorted vs OIT blending).
+// Without timestamp support on the graphics queue every call is a no-op.
+// ============================================================================
+
+class GpuTimer {
+public:
+    void create(const Device& device, uint32_t framesInFlight, const std::vector<std::string>& scopeNames);
+    void destroy(const Device& device);
+
+    bool isEnabled() const { return m_pool != VK_NULL_HANDLE; }
+
+    // Record outside a render pass, before the frame's first begin()
+    void reset(VkCommandBuffer cmd, uint32_t frame);
+    void begin(VkCommandBuffer cmd, uint32_t frame, uint32_t scope);
+    void end(VkCommandBuffer cmd, uint32_t frame, uint32_t scope);
+
+    // Read back frame `frame`'s scopes; only call after that frame's timeline wait
+    void collect(const Device& device, uint32_t frame);
+
+    // Average time of every scope sampled so far
+    void printReport() const;
+
+private:
+    struct Scope {
+        std::string name;
+        uint64_t samples = 0;
+        double totalMs = 0.0;
+    };
+
+    static constexpr uint32_t kReportInterval = 600;   // samples per scope between log lines
+
+    uint32_t queryIndex(uint32_t frame, uint32_t scope) const {
+        return (frame * static_cast<uint32_t>(m_scopes.size()) + scope) * 2;
+    }
+    void printScope(const Scope& scope) const;
+
+    VkQueryPool m_pool = VK_NULL_HANDLE;
+    double m_nsPerTick = 1.0;
+    uint64_t m_validMask = ~0ull;
+    std::vector<Scope> m_scopes;
+    std::vector<uint32_t> m_writtenScopes;   // per frame, bit per scope
+};
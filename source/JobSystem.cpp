@@ -0,0 +1,232 @@
+// ============================================================================
+// JobSystem.cpp - Work-stealing worker pool, job counters and parallel-for
+// ============================================================================
+
+#include "JobSystem.h"
+#include <algorithm>
+#include <exception>
+
+namespace {
+
+// Which pool the current thread works for, and its deque there
+constexpr uint32_t kNotAWorker = 0xFFFFFFFFu;
+thread_local const JobSystem* t_jobSystem = nullptr;
+thread_local uint32_t t_workerIndex = kNotAWorker;
+
+} // namespace
+
+// ============================================================================
+// Thread Control
+// ============================================================================
+
+void JobSystem::start(uint32_t threadCount) {
+    stop();
+
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    m_stopRequested = false;
+    for (uint32_t i = 0; i + 1 < threadCount; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (uint32_t i = 0; i < m_workers.size(); ++i) {
+        m_workers[i]->thread = std::thread(&JobSystem::workerLoop, this, i);
+    }
+}
+
+void JobSystem::stop() {
+    if (m_workers.empty()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopRequested = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers) {
+        worker->thread.join();
+    }
+    m_workers.clear();
+}
+
+void JobSystem::workerLoop(uint32_t index) {
+    t_jobSystem = this;
+    t_workerIndex = index;
+
+    for (;;) {
+        if (tryRun(index, true)) continue;
+
+        // Queued jobs are drained before a stop takes effect
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait(lock, [this] { return m_stopRequested || m_queuedJobs.load() > 0; });
+        if (m_stopRequested && m_queuedJobs.load() == 0) return;
+    }
+}
+
+// ============================================================================
+// Submission
+// ============================================================================
+
+void JobSystem::run(std::function<void()> job, JobCounter* counter, JobPriority priority) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    submit(Job{ std::move(job), counter }, priority);
+}
+
+void JobSystem::runAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter,
+                         JobPriority priority) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        // finish() takes the continuations under the same lock it drops the
+        // count to zero in, so this either sees zero or is picked up there
+        std::lock_guard<std::mutex> lock(dependency.m_mutex);
+        if (!dependency.done()) {
+            dependency.m_continuations.push_back({ std::move(job), counter, priority });
+            return;
+        }
+    }
+    submit(Job{ std::move(job), counter }, priority);
+}
+
+void JobSystem::submit(Job job, JobPriority priority) {
+    if (m_workers.empty()) {
+        // No workers: the pool is the calling thread
+        job.work();
+        finish(job.counter);
+        return;
+    }
+
+    if (priority == JobPriority::Background) {
+        std::lock_guard<std::mutex> lock(m_backgroundMutex);
+        m_backgroundJobs.push_back(std::move(job));
+    } else {
+        uint32_t index = t_jobSystem == this
+            ? t_workerIndex
+            : m_nextWorker.fetch_add(1, std::memory_order_relaxed) % static_cast<uint32_t>(m_workers.size());
+        Worker& worker = *m_workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.frameJobs.push_back(std::move(job));
+    }
+
+    m_queuedJobs.fetch_add(1);
+    {
+        // Pairs with the predicate check in workerLoop so the wakeup is not lost
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+    }
+    m_wake.notify_one();
+}
+
+// ============================================================================
+// Execution
+// ============================================================================
+
+bool JobSystem::tryRun(uint32_t self, bool takeBackground) {
+    Job job;
+    bool found = false;
+
+    // Own deque first, newest job (its data is most likely still in cache)
+    if (self != kNotAWorker) {
+        Worker& worker = *m_workers[self];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.frameJobs.empty()) {
+            job = std::move(worker.frameJobs.back());
+            worker.frameJobs.pop_back();
+            found = true;
+        }
+    }
+
+    // Then steal the oldest job of another worker
+    const size_t workerCount = m_workers.size();
+    const size_t first = self != kNotAWorker ? self + 1 : 0;
+    for (size_t n = 0; n < workerCount && !found; ++n) {
+        size_t victim = (first + n) % workerCount;
+        if (victim == self) continue;
+        Worker& worker = *m_workers[victim];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.frameJobs.empty()) {
+            job = std::move(worker.frameJobs.front());
+            worker.frameJobs.pop_front();
+            found = true;
+        }
+    }
+
+    // Background work only when no frame job is waiting
+    if (!found && takeBackground) {
+        std::lock_guard<std::mutex> lock(m_backgroundMutex);
+        if (!m_backgroundJobs.empty()) {
+            job = std::move(m_backgroundJobs.front());
+            m_backgroundJobs.pop_front();
+            found = true;
+        }
+    }
+
+    if (!found) return false;
+    m_queuedJobs.fetch_sub(1);
+    job.work();
+    finish(job.counter);
+    return true;
+}
+
+void JobSystem::finish(JobCounter* counter) {
+    if (!counter) return;
+
+    std::vector<JobCounter::Continuation> ready;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_mutex);
+        if (counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ready.swap(counter->m_continuations);
+        }
+    }
+    // The counter may be gone from here on; its waiter was free to return
+    for (JobCounter::Continuation& continuation : ready) {
+        submit(Job{ std::move(continuation.job), continuation.counter }, continuation.priority);
+    }
+}
+
+void JobSystem::wait(const JobCounter& counter, JobPriority priority) {
+    const uint32_t self = t_jobSystem == this ? t_workerIndex : kNotAWorker;
+    const bool takeBackground = priority == JobPriority::Background;
+    while (!counter.done()) {
+        if (!tryRun(self, takeBackground)) {
+            std::this_thread::yield();
+        }
+    }
+    // Let the finish() that reached zero leave the counter's lock first
+    std::lock_guard<std::mutex> lock(counter.m_mutex);
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body,
+                            JobPriority priority) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+    const size_t chunks = (count + grain - 1) / grain;
+    if (chunks == 1 || m_workers.empty()) {
+        body(0, count);
+        return;
+    }
+
+    // The first exception is passed on to the caller once every chunk is done
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto runChunk = [&](size_t begin, size_t end) {
+        try {
+            body(begin, end);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) error = std::current_exception();
+        }
+    };
+
+    JobCounter counter;
+    for (size_t c = 1; c < chunks; ++c) {
+        size_t begin = c * grain;
+        size_t end = std::min(begin + grain, count);
+        run([&runChunk, begin, end] { runChunk(begin, end); }, &counter, priority);
+    }
+    runChunk(0, std::min(grain, count));
+    wait(counter, priority);
+
+    if (error) std::rethrow_exception(error);
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// Job System
+// Worker threads shared by loading and per-frame CPU work. Frame jobs go to
+// per-worker deques: a worker pops its own newest job (cache-warm, LIFO) and
+// steals the oldest from the others when it runs dry; jobs submitted from
+// outside the pool are dealt round-robin. Background jobs (parsing, texture
+// cooking) share one FIFO queue, so they run in submission order, and
+// workers only take them when no frame job is waiting.
+//
+// A thread that waits on a counter runs queued jobs meanwhile; a frame-job
+// waiter only ever runs frame jobs, so a long background job never lands on
+// the render thread as long as it only waits at Frame priority (background
+// waits belong on loader threads). Nothing here touches Vulkan objects.
+// ============================================================================
+
+enum class JobPriority {
+    Frame,        // short work the submitter waits on within the frame
+    Background,   // loading work; may run for many milliseconds
+};
+
+// Counts unfinished jobs. Reusable once it has reached zero; wait() on it
+// before it goes out of scope, done() alone does not make that safe.
+class JobCounter {
+public:
+    bool done() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    struct Continuation {
+        std::function<void()> job;
+        JobCounter* counter;
+        JobPriority priority;
+    };
+
+    std::atomic<uint32_t> m_pending{ 0 };
+    mutable std::mutex m_mutex;
+    std::vector<Continuation> m_continuations;   // runAfter() jobs waiting for zero
+};
+
+class JobSystem {
+public:
+    JobSystem() = default;
+    ~JobSystem() { stop(); }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // `threadCount` includes the submitting thread, which helps while it
+    // waits: 1 runs every job inline, 0 uses the hardware concurrency
+    void start(uint32_t threadCount);
+
+    // Finish queued jobs and join the workers
+    void stop();
+
+    uint32_t threadCount() const { return static_cast<uint32_t>(m_workers.size()) + 1; }
+
+    // Queue a job; `counter` (optional) counts it until it has run
+    void run(std::function<void()> job, JobCounter* counter = nullptr,
+             JobPriority priority = JobPriority::Frame);
+
+    // Queue a job once `dependency` reaches zero (at once if it already has)
+    void runAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter = nullptr,
+                  JobPriority priority = JobPriority::Frame);
+
+    // Run other jobs until `counter` reaches zero
+    void wait(const JobCounter& counter, JobPriority priority = JobPriority::Frame);
+
+    // Call body(begin, end) over [0, count) in chunks of at most `grain`
+    // items, on the workers and the calling thread, and return when all are
+    // done. A single chunk runs inline.
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body,
+                     JobPriority priority = JobPriority::Frame);
+
+private:
+    struct Job {
+        std::function<void()> work;
+        JobCounter* counter = nullptr;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Job> frameJobs;   // owner pops the back, thieves take the front
+        std::thread thread;
+    };
+
+    void workerLoop(uint32_t index);
+    void submit(Job job, JobPriority priority);
+    bool tryRun(uint32_t self, bool takeBackground);
+    void finish(JobCounter* counter);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<uint32_t> m_nextWorker{ 0 };       // round-robin for outside submissions
+
+    std::mutex m_backgroundMutex;
+    std::deque<Job> m_backgroundJobs;
+
+    std::atomic<uint32_t> m_queuedJobs{ 0 };
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    bool m_stopRequested = false;
+};
@@ -0,0 +1,548 @@
+// ============================================================================
+// MipGenerator.cpp - Single-dispatch compute mip chains and the blit fallback
+// ============================================================================
+
+#include "MipGenerator.h"
+#include "AsyncQueue.h"
+#include "DeletionQueue.h"
+#include "Device.h"
+#include "GpuTimer.h"
+#include "PipelineCache.h"
+#include "Utilities.h"
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+// ============================================================================
+// Helper Functions
+// ============================================================================
+
+namespace {
+
+constexpr uint32_t kMaxSize = 4096;        // 64x64 tiles of 64x64 texels
+constexpr uint32_t kMaxTargetMips = 12;    // mips 1..12 of a 4096 image
+constexpr uint32_t kTileSize = 64;
+constexpr uint32_t kSetsPerPool = 16;      // descriptor sets per pool; generations in flight each hold one
+constexpr VkDeviceSize kGlobalStateSize = 8 * sizeof(uint32_t) + 6 * 64 * 64 * 4 * sizeof(float);
+
+struct DownsampleParams {
+    uint32_t mipCount;
+    uint32_t width;
+    uint32_t height;
+    uint32_t srgb;
+    uint32_t tileCount;
+};
+
+// Storage images cannot be sRGB: the shader writes sRGB images through a
+// UNORM view of the same bits and encodes itself
+VkFormat storageFormat(VkFormat format) {
+    switch (format) {
+    case VK_FORMAT_R8_UNORM:
+    case VK_FORMAT_R8G8_UNORM:
+    case VK_FORMAT_R8G8B8A8_UNORM: return format;
+    case VK_FORMAT_R8G8B8A8_SRGB: return VK_FORMAT_R8G8B8A8_UNORM;
+    default: return VK_FORMAT_UNDEFINED;
+    }
+}
+
+VkImageView createArrayView(const Device& device, VkImage image, VkFormat format,
+                            uint32_t mipLevel, uint32_t layerCount) {
+    VkImageViewCreateInfo viewInfo{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    viewInfo.image = image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    viewInfo.format = format;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = mipLevel;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = layerCount;
+    VkImageView view = VK_NULL_HANDLE;
+    if (vkCreateImageView(device.get(), &viewInfo, nullptr, &view) != VK_SUCCESS) {
+        throw std::runtime_error("MipGenerator: create image view failed");
+    }
+    return view;
+}
+
+VkImageMemoryBarrier levelBarrier(VkImage image, uint32_t baseMip, uint32_t mipCount, uint32_t layerCount,
+                                  VkImageLayout oldLayout, VkImageLayout newLayout,
+                                  VkAccessFlags srcAccess, VkAccessFlags dstAccess) {
+    VkImageMemoryBarrier barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = baseMip;
+    barrier.subresourceRange.levelCount = mipCount;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = layerCount;
+    return barrier;
+}
+
+// Generated levels (GENERAL) to sampling, on the graphics queue
+void recordSampleTransition(VkCommandBuffer cmd, VkImage image, uint32_t mipLevels, uint32_t layerCount) {
+    VkImageMemoryBarrier barrier = levelBarrier(image, 1, mipLevels - 1, layerCount,
+        VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+uint32_t mipCountFor(uint32_t width, uint32_t height) {
+    uint32_t levels = 1;
+    for (uint32_t size = std::max(width, height); size > 1; size >>= 1) {
+        ++levels;
+    }
+    return levels;
+}
+
+} // namespace
+
+// ============================================================================
+// Blit Path
+// ============================================================================
+
+void recordBlitMipChain(VkCommandBuffer cmd, VkImage image, uint32_t width, uint32_t height,
+                        uint32_t mipLevels, uint32_t layerCount) {
+    int32_t mipWidth = static_cast<int32_t>(width);
+    int32_t mipHeight = static_cast<int32_t>(height);
+    for (uint32_t level = 1; level < mipLevels; ++level) {
+        VkImageMemoryBarrier barrier = levelBarrier(image, level - 1, 1, layerCount,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        int32_t nextWidth = std::max(mipWidth / 2, 1);
+        int32_t nextHeight = std::max(mipHeight / 2, 1);
+
+        VkImageBlit blit{};
+        blit.srcOffsets[0] = { 0, 0, 0 };
+        blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
+        blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, layerCount };
+        blit.dstOffsets[0] = { 0, 0, 0 };
+        blit.dstOffsets[1] = { nextWidth, nextHeight, 1 };
+        blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, layerCount };
+        vkCmdBlitImage(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                       image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       1, &blit, VK_FILTER_LINEAR);
+
+        barrier = levelBarrier(image, level - 1, 1, layerCount,
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT);
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        mipWidth = nextWidth;
+        mipHeight = nextHeight;
+    }
+
+    VkImageMemoryBarrier barrier = levelBarrier(image, mipLevels - 1, 1, layerCount,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+// ============================================================================
+// Creation
+// ============================================================================
+
+void MipGenerator::create(const Device& device, PipelineCache& pipelineCache, VkShaderModule downsampleShader,
+                          AsyncQueue* computeQueue) {
+    m_queue = computeQueue;
+    if (!device.features().shaderStorageImageWriteWithoutFormat) {
+        std::cout << "Mip generation: storage image writes without format unsupported, using blits" << std::endl;
+        return;
+    }
+
+    // Set 0: binding 0 = mip 0, binding 1 = mips 1..12, binding 2 = global state
+    std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[0].descriptorCount = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[1].descriptorCount = kMaxTargetMips;
+    bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[2].descriptorCount = 1;
+    for (uint32_t i = 0; i < bindings.size(); ++i) {
+        bindings[i].binding = i;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    if (vkCreateDescriptorSetLayout(device.get(), &layoutInfo, nullptr, &m_setLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create mip generation descriptor set layout");
+    }
+
+    m_pipelineLayout.create(device, { m_setLayout },
+        { { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(DownsampleParams) } });
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = downsampleShader;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = m_pipelineLayout.get();
+    m_pipeline = pipelineCache.createComputePipeline(device, pipelineInfo, "mip downsample");
+
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxAnisotropy = 1.0f;
+    if (vkCreateSampler(device.get(), &samplerInfo, nullptr, &m_sampler) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create mip generation sampler");
+    }
+
+    m_globalState.create(device, kGlobalStateSize,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    m_available = true;
+}
+
+void MipGenerator::destroy(const Device& device) {
+    m_globalState.destroy(device);
+    if (m_sampler != VK_NULL_HANDLE) {
+        vkDestroySampler(device.get(), m_sampler, nullptr);
+        m_sampler = VK_NULL_HANDLE;
+    }
+    if (m_pipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device.get(), m_pipeline, nullptr);
+        m_pipeline = VK_NULL_HANDLE;
+    }
+    m_pipelineLayout.destroy(device);
+    // Destroying the pools frees the sets; the deletion queue has returned
+    // every set in use by now
+    for (VkDescriptorPool pool : m_pools) {
+        vkDestroyDescriptorPool(device.get(), pool, nullptr);
+    }
+    m_pools.clear();
+    m_poolSetsUsed = 0;
+    m_freeSets.clear();
+    if (m_setLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(device.get(), m_setLayout, nullptr);
+        m_setLayout = VK_NULL_HANDLE;
+    }
+    m_available = false;
+}
+
+bool MipGenerator::supports(const Device& device, VkFormat format, uint32_t width, uint32_t height) const {
+    VkFormat storage = storageFormat(format);
+    if (!m_available || storage == VK_FORMAT_UNDEFINED) return false;
+    if (std::max(width, height) < 2 || std::max(width, height) > kMaxSize) return false;
+
+    VkFormatProperties properties{};
+    vkGetPhysicalDeviceFormatProperties(device.physical(), storage, &properties);
+    return (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+}
+
+VkImageCreateFlags MipGenerator::imageFlags(VkFormat format) {
+    // The UNORM storage view of an sRGB image needs both flags
+    return storageFormat(format) != format
+        ? VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT
+        : 0;
+}
+
+DeletionQueue* MipGenerator::deletionQueue() const {
+    return m_queue ? &m_queue->deletionQueue() : nullptr;
+}
+
+// ============================================================================
+// Descriptor Sets
+// ============================================================================
+
+VkDescriptorSet MipGenerator::acquireSet(const Device& device) {
+    if (!m_freeSets.empty()) {
+        VkDescriptorSet set = m_freeSets.back();
+        m_freeSets.pop_back();
+        return set;
+    }
+
+    if (m_pools.empty() || m_poolSetsUsed == kSetsPerPool) {
+        // Set 0 layout: mip 0, mips 1..12, global state
+        std::array<VkDescriptorPoolSize, 3> poolSizes{ {
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, kSetsPerPool },
+            { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, kSetsPerPool * kMaxTargetMips },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kSetsPerPool },
+        } };
+
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.maxSets = kSetsPerPool;
+        poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        poolInfo.pPoolSizes = poolSizes.data();
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+        if (vkCreateDescriptorPool(device.get(), &poolInfo, nullptr, &pool) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create mip generation descriptor pool");
+        }
+        m_pools.push_back(pool);
+        m_poolSetsUsed = 0;
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_pools.back();
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_setLayout;
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    if (vkAllocateDescriptorSets(device.get(), &allocInfo, &set) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate mip generation descriptor set");
+    }
+    ++m_poolSetsUsed;
+    return set;
+}
+
+// ============================================================================
+// Generation
+// ============================================================================
+
+std::vector<VkImageView> MipGenerator::record(const Device& device, VkCommandBuffer cmd, VkDescriptorSet set,
+                                              VkImage image, VkFormat format, uint32_t width, uint32_t height,
+                                              uint32_t mipLevels, uint32_t layerCount) {
+    const uint32_t targetMips = mipLevels - 1;
+
+    // views[0] reads mip 0 (decoding sRGB), views[1..] write mips 1..
+    std::vector<VkImageView> views;
+    views.push_back(createArrayView(device, image, format, 0, layerCount));
+    for (uint32_t level = 1; level < mipLevels; ++level) {
+        views.push_back(createArrayView(device, image, storageFormat(format), level, layerCount));
+    }
+
+    VkDescriptorImageInfo sourceInfo{ m_sampler, views[0], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    std::array<VkDescriptorImageInfo, kMaxTargetMips> targetInfos{};
+    for (uint32_t i = 0; i < kMaxTargetMips; ++i) {
+        targetInfos[i] = { VK_NULL_HANDLE, views[std::min(i, targetMips - 1) + 1], VK_IMAGE_LAYOUT_GENERAL };
+    }
+    VkDescriptorBufferInfo stateInfo{ m_globalState.get(), 0, kGlobalStateSize };
+
+    std::array<VkWriteDescriptorSet, 3> writes{};
+    for (uint32_t i = 0; i < writes.size(); ++i) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = set;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+    }
+    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    writes[0].pImageInfo = &sourceInfo;
+    writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    writes[1].descriptorCount = kMaxTargetMips;
+    writes[1].pImageInfo = targetInfos.data();
+    writes[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    writes[2].pBufferInfo = &stateInfo;
+    vkUpdateDescriptorSets(device.get(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+    // Counters start at zero; the shader leaves them at zero again
+    vkCmdFillBuffer(cmd, m_globalState.get(), 0, 8 * sizeof(uint32_t), 0);
+
+    std::array<VkImageMemoryBarrier, 2> before{ {
+        levelBarrier(image, 0, 1, layerCount,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT),
+        levelBarrier(image, 1, targetMips, layerCount,
+            VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+            0, VK_ACCESS_SHADER_WRITE_BIT),
+    } };
+    VkMemoryBarrier fillBarrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    fillBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    fillBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &fillBarrier, 0, nullptr, static_cast<uint32_t>(before.size()), before.data());
+
+    uint32_t tilesX = (width + kTileSize - 1) / kTileSize;
+    uint32_t tilesY = (height + kTileSize - 1) / kTileSize;
+    DownsampleParams params{};
+    params.mipCount = targetMips;
+    params.width = width;
+    params.height = height;
+    params.srgb = storageFormat(format) != format ? 1u : 0u;
+    params.tileCount = tilesX * tilesY;
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout.get(), 0, 1, &set, 0, nullptr);
+    vkCmdPushConstants(cmd, m_pipelineLayout.get(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+    vkCmdDispatch(cmd, tilesX, tilesY, layerCount);
+
+    // The global state back to the next generation's fill
+    VkMemoryBarrier stateBarrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    stateBarrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    stateBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 1, &stateBarrier, 0, nullptr, 0, nullptr);
+    return views;
+}
+
+uint64_t MipGenerator::generate(const Device& device, VkCommandPool commandPool, VkQueue queue,
+                                VkBuffer staging, const std::vector<VkBufferImageCopy>& copies,
+                                VkImage image, VkFormat format, uint32_t width, uint32_t height,
+                                uint32_t mipLevels, uint32_t layerCount) {
+    VkCommandBuffer cmd = m_queue ? m_queue->begin(device) : beginSingleTimeCommands(device, commandPool);
+
+    VkImageMemoryBarrier toTransfer = levelBarrier(image, 0, 1, layerCount,
+        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        0, VK_ACCESS_TRANSFER_WRITE_BIT);
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &toTransfer);
+    vkCmdCopyBufferToImage(cmd, staging, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(copies.size()), copies.data());
+
+    VkDescriptorSet set = acquireSet(device);
+    std::vector<VkImageView> views = record(device, cmd, set, image, format, width, height, mipLevels, layerCount);
+
+    if (m_queue) {
+        // Mip 0 only changes owner; the generated levels also go to sampling
+        ImageHandoff source;
+        source.image = image;
+        source.range = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, layerCount };
+        source.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        source.srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        source.srcAccess = 0;
+        ImageHandoff generated = source;
+        generated.range = { VK_IMAGE_ASPECT_COLOR_BIT, 1, mipLevels - 1, 0, layerCount };
+        generated.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+        generated.srcAccess = VK_ACCESS_SHADER_WRITE_BIT;
+        uint64_t value = m_queue->submit(device, cmd, { source, generated });
+
+        // The views and the set stay in use until the dispatch has run
+        VkDevice handle = device.get();
+        m_queue->deletionQueue().push(value, [this, handle, set, views]() {
+            for (VkImageView view : views) {
+                vkDestroyImageView(handle, view, nullptr);
+            }
+            m_freeSets.push_back(set);
+        });
+        return value;
+    }
+
+    recordSampleTransition(cmd, image, mipLevels, layerCount);
+    endSingleTimeCommands(device, cmd, commandPool, queue);
+    for (VkImageView view : views) {
+        vkDestroyImageView(device.get(), view, nullptr);
+    }
+    m_freeSets.push_back(set);
+    return 0;
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+void MipGenerator::benchmark(const Device& device, VkCommandPool commandPool, VkQueue queue) {
+    if (!m_available) {
+        std::cout << "Mip generation benchmark skipped: compute path unavailable" << std::endl;
+        return;
+    }
+
+    struct Case {
+        uint32_t width;
+        uint32_t height;
+        uint32_t layers;
+    };
+    const Case cases[] = {
+        { 1024, 1024, 1 }, { 2048, 2048, 1 }, { 4096, 4096, 1 },
+        { 1920, 1080, 1 },    // non-power-of-two
+        { 1024, 1024, 6 },    // cubemap
+    };
+    constexpr VkFormat kFormat = VK_FORMAT_R8G8B8A8_SRGB;
+    constexpr uint32_t kRuns = 10;
+
+    std::vector<std::string> scopeNames;
+    for (const Case& c : cases) {
+        std::string name = "mips " + std::to_string(c.width) + "x" + std::to_string(c.height) +
+                           (c.layers == 6 ? " cube" : "");
+        scopeNames.push_back(name + " blit");
+        scopeNames.push_back(name + " compute");
+    }
+    GpuTimer timer;
+    timer.create(device, 1, scopeNames);
+    if (!timer.isEnabled()) {
+        timer.destroy(device);
+        return;
+    }
+
+    for (uint32_t c = 0; c < std::size(cases); ++c) {
+        const Case& test = cases[c];
+        uint32_t mipLevels = mipCountFor(test.width, test.height);
+
+        VkImageCreateInfo imageInfo{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+        imageInfo.flags = imageFlags(kFormat) | (test.layers == 6 ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0);
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = kFormat;
+        imageInfo.extent = { test.width, test.height, 1 };
+        imageInfo.mipLevels = mipLevels;
+        imageInfo.arrayLayers = test.layers;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = kImageUsage | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkImage image = VK_NULL_HANDLE;
+        if (vkCreateImage(device.get(), &imageInfo, nullptr, &image) != VK_SUCCESS) {
+            throw std::runtime_error("MipGenerator: create benchmark image failed");
+        }
+        VkMemoryRequirements requirements{};
+        vkGetImageMemoryRequirements(device.get(), image, &requirements);
+        VkMemoryAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+        allocInfo.allocationSize = requirements.size;
+        allocInfo.memoryTypeIndex = findMemoryType(device.physical(), requirements.memoryTypeBits,
+                                                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        if (vkAllocateMemory(device.get(), &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+            throw std::runtime_error("MipGenerator: alloc benchmark image failed");
+        }
+        vkBindImageMemory(device.get(), image, memory, 0);
+
+        // Both paths start from every level in TRANSFER_DST_OPTIMAL, as after an upload
+        VkImageMemoryBarrier reset = levelBarrier(image, 0, mipLevels, test.layers,
+            VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            0, VK_ACCESS_TRANSFER_WRITE_BIT);
+
+        for (uint32_t run = 0; run < kRuns; ++run) {
+            VkCommandBuffer cmd = beginSingleTimeCommands(device, commandPool);
+            timer.reset(cmd, 0);
+
+            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 0, 0, nullptr, 0, nullptr, 1, &reset);
+            timer.begin(cmd, 0, c * 2);
+            recordBlitMipChain(cmd, image, test.width, test.height, mipLevels, test.layers);
+            timer.end(cmd, 0, c * 2);
+
+            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 0, 0, nullptr, 0, nullptr, 1, &reset);
+            timer.begin(cmd, 0, c * 2 + 1);
+            VkDescriptorSet set = acquireSet(device);
+            std::vector<VkImageView> views = record(device, cmd, set, image, kFormat, test.width, test.height,
+                                                    mipLevels, test.layers);
+            recordSampleTransition(cmd, image, mipLevels, test.layers);
+            timer.end(cmd, 0, c * 2 + 1);
+
+            endSingleTimeCommands(device, cmd, commandPool, queue);
+            timer.collect(device, 0);
+            for (VkImageView view : views) {
+                vkDestroyImageView(device.get(), view, nullptr);
+            }
+            m_freeSets.push_back(set);
+        }
+
+        vkDestroyImage(device.get(), image, nullptr);
+        vkFreeMemory(device.get(), memory, nullptr);
+    }
+
+    std::cout << "Mip generation, sRGB RGBA8 (" << kRuns << " runs each)" << std::endl;
+    timer.printReport();
+    timer.destroy(device);
+}
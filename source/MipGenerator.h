@@ -0,0 +1,84 @@
+#pragma once
+#include "Buffer.h"
+#include "Pipeline.h"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+class AsyncQueue;
+class DeletionQueue;
+class Device;
+class PipelineCache;
+
+// ============================================================================
+// Mip Generation
+// Builds a full mip chain from mip 0, for one layer (2D texture) or six
+// (cubemap), in a single compute dispatch (mip_downsample.comp, modelled on
+// AMD's single-pass downsampler) instead of one blit and two barriers per
+// level. Filtering happens in linear space, so sRGB images stay correct.
+//
+// Requirements: R8/RG8/RGBA8 (UNORM or sRGB) up to 4096 texels a side, the
+// shaderStorageImageWriteWithoutFormat feature and storage support for the
+// UNORM format; callers fall back to recordBlitMipChain otherwise. With an
+// async compute queue the upload and the dispatch overlap rendering.
+// ============================================================================
+
+// Blit path: level by level, all layers at once. Expects every level in
+// TRANSFER_DST_OPTIMAL and leaves them in SHADER_READ_ONLY_OPTIMAL.
+void recordBlitMipChain(VkCommandBuffer cmd, VkImage image, uint32_t width, uint32_t height,
+                        uint32_t mipLevels, uint32_t layerCount);
+
+class MipGenerator {
+public:
+    void create(const Device& device, PipelineCache& pipelineCache, VkShaderModule downsampleShader,
+                AsyncQueue* computeQueue = nullptr);
+    void destroy(const Device& device);
+
+    // Whether generate() can build this image's chain
+    bool supports(const Device& device, VkFormat format, uint32_t width, uint32_t height) const;
+
+    // Extra creation flags and usage an image needs for generate()
+    static VkImageCreateFlags imageFlags(VkFormat format);
+    static constexpr VkImageUsageFlags kImageUsage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+
+    // Upload mip 0 of every layer from `staging` through `copies`, then build
+    // levels 1..mipLevels-1. Runs on the compute queue given to create(), or
+    // on `queue` without one. Graphics work submitted afterwards sees every
+    // level SHADER_READ_ONLY_OPTIMAL and owned by the graphics queue family.
+    // Returns the frame timeline value the compute queue's work completes at,
+    // or 0 when it ran on `queue` and has already finished.
+    uint64_t generate(const Device& device, VkCommandPool commandPool, VkQueue queue,
+                      VkBuffer staging, const std::vector<VkBufferImageCopy>& copies,
+                      VkImage image, VkFormat format, uint32_t width, uint32_t height,
+                      uint32_t mipLevels, uint32_t layerCount);
+
+    // Where to retire `staging` at generate()'s value; null when generate()
+    // finishes before returning and staging can be destroyed at once
+    DeletionQueue* deletionQueue() const;
+
+    // Time generate() against recordBlitMipChain with GPU timestamps on a few
+    // 2D and cube sizes and print the results (run with --benchmark-mips)
+    void benchmark(const Device& device, VkCommandPool commandPool, VkQueue queue);
+
+private:
+    // Set for one generation, reused once that generation has executed
+    VkDescriptorSet acquireSet(const Device& device);
+
+    // Record the dispatch and its barriers through `set`, leaving mip 0
+    // SHADER_READ_ONLY and the rest GENERAL; the views it creates stay valid
+    // until the command buffer has executed and are returned for destruction
+    std::vector<VkImageView> record(const Device& device, VkCommandBuffer cmd, VkDescriptorSet set,
+                                    VkImage image, VkFormat format, uint32_t width, uint32_t height,
+                                    uint32_t mipLevels, uint32_t layerCount);
+
+    VkDescriptorSetLayout m_setLayout = VK_NULL_HANDLE;
+    PipelineLayoutRAII m_pipelineLayout;
+    VkPipeline m_pipeline = VK_NULL_HANDLE;
+    std::vector<VkDescriptorPool> m_pools;              // kSetsPerPool sets each
+    uint32_t m_poolSetsUsed = 0;                        // allocated from m_pools.back()
+    std::vector<VkDescriptorSet> m_freeSets;            // sets no generation in flight uses
+    VkSampler m_sampler = VK_NULL_HANDLE;               // nearest, for texelFetch of mip 0
+    Buffer m_globalState;                               // counters + gathered mip 6 (mip_downsample.comp)
+    AsyncQueue* m_queue = nullptr;                      // async compute, or null for the caller's queue
+    bool m_available = false;
+};
@@ -0,0 +1,152 @@
+// ============================================================================
+// ModelLoader.cpp - Background parsing and budgeted upload of glTF models
+// ============================================================================
+
+#include "ModelLoader.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+// ============================================================================
+// Thread Control
+// ============================================================================
+
+void ModelLoader::request(const std::string& filename) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queued.push_back(filename);
+    }
+    if (!m_thread.joinable()) {
+        m_stopRequested = false;
+        m_thread = std::thread(&ModelLoader::run, this);
+    }
+    m_wake.notify_one();
+}
+
+void ModelLoader::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = true;
+        m_queued.clear();
+    }
+    m_wake.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void ModelLoader::run() {
+    for (;;) {
+        std::string filename;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopRequested || !m_queued.empty(); });
+            if (m_stopRequested) return;
+            filename = std::move(m_queued.front());
+            m_queued.pop_front();
+            m_parsing = true;
+        }
+
+        auto model = std::make_unique<GltfModel>();
+        try {
+            model->parse(filename, m_jobs);
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to load " << filename << ": " << e.what() << std::endl;
+            model.reset();
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (model) {
+            m_parsed.push_back(std::move(model));
+        }
+        m_parsing = false;
+    }
+}
+
+// ============================================================================
+// Upload
+// ============================================================================
+
+std::vector<std::unique_ptr<GltfModel>> ModelLoader::update(const Device& device,
+                                                             VkCommandPool cmdPool,
+                                                             VkQueue queue,
+                                                             BindlessTextureHeap& textureHeap,
+                                                             SamplerCache& samplerCache,
+                                                             MipGenerator* mipGenerator,
+                                                             AsyncQueue* transferQueue,
+                                                             const GltfLoadOptions& options,
+                                                             UploadScheduler& scheduler) {
+    std::vector<std::unique_ptr<GltfModel>> completed;
+
+    const auto start = std::chrono::steady_clock::now();
+    bool uploaded = false;
+    for (;;) {
+        if (!m_uploading) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_parsed.empty()) break;
+            m_uploading = std::move(m_parsed.front());
+            m_parsed.pop_front();
+        }
+
+        uploaded = true;
+        if (!m_uploading->upload(device, cmdPool, queue, textureHeap, samplerCache,
+                                 mipGenerator, transferQueue, options, &scheduler)) {
+            break;  // out of budget for this frame
+        }
+        completed.push_back(std::move(m_uploading));
+        ++m_stats.modelsLoaded;
+    }
+
+    if (uploaded) {
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        ++m_stats.uploadFrames;
+        m_stats.uploadMs += ms;
+        m_stats.worstUploadMs = std::max(m_stats.worstUploadMs, ms);
+    }
+    return completed;
+}
+
+size_t ModelLoader::pending() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queued.size() + m_parsed.size() + (m_parsing ? 1 : 0) + (m_uploading ? 1 : 0);
+}
+
+void ModelLoader::destroy(const Device& device) {
+    stop();
+    if (m_uploading) {
+        m_uploading->destroy(device);
+        m_uploading.reset();
+    }
+    m_parsed.clear();  // parsed only: nothing on the GPU yet
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+void ModelLoader::recordFrameTime(double milliseconds) {
+    if (pending() > 0) {
+        ++m_stats.loadingFrames;
+        m_stats.loadingFrameMs += milliseconds;
+        m_stats.worstLoadingFrameMs = std::max(m_stats.worstLoadingFrameMs, milliseconds);
+    } else {
+        ++m_stats.idleFrames;
+        m_stats.idleFrameMs += milliseconds;
+        m_stats.worstIdleFrameMs = std::max(m_stats.worstIdleFrameMs, milliseconds);
+    }
+}
+
+void ModelLoader::printReport() const {
+    if (m_stats.uploadFrames == 0) return;
+
+    auto average = [](double total, uint32_t count) { return count ? total / count : 0.0; };
+    std::cout << "Runtime model loads: " << m_stats.modelsLoaded << " models over "
+              << m_stats.uploadFrames << " upload frames, "
+              << average(m_stats.uploadMs, m_stats.uploadFrames) << " ms average / "
+              << m_stats.worstUploadMs << " ms worst upload slice" << std::endl;
+    std::cout << "  Frame time while loading: " << average(m_stats.loadingFrameMs, m_stats.loadingFrames)
+              << " ms average, " << m_stats.worstLoadingFrameMs << " ms worst (" << m_stats.loadingFrames
+              << " frames); otherwise " << average(m_stats.idleFrameMs, m_stats.idleFrames) << " ms average, "
+              << m_stats.worstIdleFrameMs << " ms worst" << std::endl;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "GltfModel.h"
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class AsyncQueue;
+class BindlessTextureHeap;
+class Device;
+class MipGenerator;
+class SamplerCache;
+
+// ============================================================================
+// Model Loader
+// Adds glTF models to a running scene. A worker thread does the CPU half of
+// each load (GltfModel::parse: file I/O, deduplication, vertex extraction);
+// the render thread calls update() once per frame, which uploads parsed
+// models in small steps while the frame's upload budget lasts and hands a
+// model out only once all of it is on the GPU, so a model never appears half
+// loaded and a load adds at most what the UploadScheduler allows to any
+// frame. Textures then stream in as they do for the startup model.
+// ============================================================================
+
+class ModelLoader {
+public:
+    ModelLoader() = default;
+    ~ModelLoader() { stop(); }
+
+    ModelLoader(const ModelLoader&) = delete;
+    ModelLoader& operator=(const ModelLoader&) = delete;
+
+    // Parse with `jobs` (must outlive the loader and its models)
+    void setJobSystem(JobSystem* jobs) { m_jobs = jobs; }
+
+    // Queue a file; the worker thread starts on the first request
+    void request(const std::string& filename);
+
+    // Drop queued files, let the worker finish its current parse and join
+    void stop();
+
+    // Render thread, once per frame: upload parsed models while `scheduler`
+    // has budget left and return those that completed. Other arguments are
+    // as for GltfModel::loadFromFile.
+    std::vector<std::unique_ptr<GltfModel>> update(const Device& device,
+                                                   VkCommandPool cmdPool,
+                                                   VkQueue queue,
+                                                   BindlessTextureHeap& textureHeap,
+                                                   SamplerCache& samplerCache,
+                                                   MipGenerator* mipGenerator,
+                                                   AsyncQueue* transferQueue,
+                                                   const GltfLoadOptions& options,
+                                                   UploadScheduler& scheduler);
+
+    // Files queued, being parsed or being uploaded
+    size_t pending() const;
+
+    // Stop, and destroy models parsed or partly uploaded but not handed out
+    // (after the device is idle)
+    void destroy(const Device& device);
+
+    // Record the last frame's CPU time, in frames with or without a load in
+    // progress, so printReport() can show what loading costs a frame
+    void recordFrameTime(double milliseconds);
+    void printReport() const;
+
+private:
+    void run();
+
+    struct Stats {
+        uint32_t modelsLoaded = 0;
+        uint32_t uploadFrames = 0;         // frames that ran upload steps
+        double uploadMs = 0.0;
+        double worstUploadMs = 0.0;        // longest update()
+        uint32_t loadingFrames = 0;
+        double loadingFrameMs = 0.0;
+        double worstLoadingFrameMs = 0.0;
+        uint32_t idleFrames = 0;
+        double idleFrameMs = 0.0;
+        double worstIdleFrameMs = 0.0;
+    };
+    Stats m_stats;
+
+    JobSystem* m_jobs = nullptr;
+    std::thread m_thread;
+    std::atomic<bool> m_stopRequested{ false };
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<std::string> m_queued;                  // waiting for the worker
+    std::deque<std::unique_ptr<GltfModel>> m_parsed;   // waiting for upload
+    bool m_parsing = false;
+
+    std::unique_ptr<GltfModel> m_uploading;            // render thread only
+};
@@ -0,0 +1,138 @@
+// ============================================================================
+// ParallelRecorder.cpp - Per-slot command pools and secondary command buffers
+// ============================================================================
+
+#include "ParallelRecorder.h"
+#include "Device.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+// ============================================================================
+// Pools
+// ============================================================================
+
+void ParallelRecorder::create(const Device& device, uint32_t framesInFlight, uint32_t slotCount) {
+    m_slotCount = std::max(1u, slotCount);
+    m_frame = 0;
+    m_slots.resize(static_cast<size_t>(framesInFlight) * m_slotCount);
+
+    // Transient: every buffer is re-recorded each time its frame comes round
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = device.graphicsFamily();
+    for (Slot& slot : m_slots) {
+        if (vkCreateCommandPool(device.get(), &poolInfo, nullptr, &slot.pool) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create secondary command pool!");
+        }
+    }
+}
+
+void ParallelRecorder::destroy(const Device& device) {
+    // Destroying a pool frees its command buffers
+    for (Slot& slot : m_slots) {
+        if (slot.pool != VK_NULL_HANDLE) {
+            vkDestroyCommandPool(device.get(), slot.pool, nullptr);
+        }
+    }
+    m_slots.clear();
+    m_recorded.clear();
+    m_slotCount = 0;
+}
+
+void ParallelRecorder::beginFrame(const Device& device, uint32_t frame) {
+    m_frame = frame;
+    for (uint32_t i = 0; i < m_slotCount; ++i) {
+        Slot& frameSlot = slot(frame, i);
+        if (frameSlot.used == 0) continue;
+        vkResetCommandPool(device.get(), frameSlot.pool, 0);
+        frameSlot.used = 0;
+    }
+}
+
+VkCommandBuffer ParallelRecorder::acquire(const Device& device, Slot& slot) {
+    if (slot.used == slot.buffers.size()) {
+        size_t first = slot.buffers.size();
+        slot.buffers.resize(first + kAllocationBatch);
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = slot.pool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = kAllocationBatch;
+        if (vkAllocateCommandBuffers(device.get(), &allocInfo, slot.buffers.data() + first) != VK_SUCCESS) {
+            slot.buffers.resize(first);
+            throw std::runtime_error("failed to allocate secondary command buffers!");
+        }
+    }
+    return slot.buffers[slot.used++];
+}
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+const std::vector<VkCommandBuffer>& ParallelRecorder::record(const Device& device, JobSystem& jobs,
+                                                             VkRenderPass renderPass, uint32_t subpass,
+                                                             VkFramebuffer framebuffer, size_t count,
+                                                             const std::function<void(VkCommandBuffer, size_t)>& recordItem) {
+    m_recorded.assign(count, VK_NULL_HANDLE);
+    if (count == 0) return m_recorded;
+
+    VkCommandBufferInheritanceInfo inheritance{};
+    inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance.renderPass = renderPass;
+    inheritance.subpass = subpass;
+    inheritance.framebuffer = framebuffer;
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = &inheritance;
+
+    // One contiguous run per slot, so the run index picks the pool
+    const size_t grain = (count + m_slotCount - 1) / m_slotCount;
+    jobs.parallelFor(count, grain, [&](size_t begin, size_t end) {
+        Slot& runSlot = slot(m_frame, static_cast<uint32_t>(begin / grain));
+        for (size_t i = begin; i < end; ++i) {
+            VkCommandBuffer cmd = acquire(device, runSlot);
+            if (vkBeginCommandBuffer(cmd, &beginInfo) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to begin recording secondary command buffer");
+            }
+            recordItem(cmd, i);
+            if (vkEndCommandBuffer(cmd) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to record secondary command buffer");
+            }
+            m_recorded[i] = cmd;
+        }
+    });
+
+    m_secondaries += count;
+    return m_recorded;
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+void ParallelRecorder::recordFrameTime(double milliseconds) {
+    ++m_frames;
+    m_totalMs += milliseconds;
+    m_worstMs = std::max(m_worstMs, milliseconds);
+}
+
+void ParallelRecorder::printReport() const {
+    if (m_frames == 0) return;
+
+    std::cout << "Draw recording: " << m_totalMs / m_frames << " ms average, " << m_worstMs
+              << " ms worst over " << m_frames << " frames";
+    if (m_slotCount > 1) {
+        std::cout << " (" << m_slotCount << " threads, " << static_cast<double>(m_secondaries) / m_frames
+                  << " secondary command buffers per frame)";
+    } else {
+        std::cout << " (inline, 1 thread)";
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class Device;
+class JobSystem;
+
+// ============================================================================
+// Parallel Recorder
+// Secondary command buffers for recording one subpass on several threads.
+// Every frame in flight has a command pool per recording slot, and a slot
+// is used by one thread at a time, so no pool is ever shared between
+// threads. A frame's pools are reset as a whole once its timeline wait has
+// passed; their command buffers are kept and reused the next time round.
+// ============================================================================
+
+class ParallelRecorder {
+public:
+    // `slotCount`: the most threads that record at once (the job system's
+    // thread count); 1 means the caller records inline instead
+    void create(const Device& device, uint32_t framesInFlight, uint32_t slotCount);
+    void destroy(const Device& device);
+
+    uint32_t slotCount() const { return m_slotCount; }
+
+    // Reset frame slot `frame`'s pools; only call after that frame's timeline wait
+    void beginFrame(const Device& device, uint32_t frame);
+
+    // Record `count` items into a secondary command buffer each, continuing
+    // `subpass` of `renderPass`, and return them in item order for
+    // vkCmdExecuteCommands. Items are split into contiguous runs, one per
+    // slot, and the runs are recorded in parallel on `jobs`; recordItem
+    // only needs to record state the secondary does not inherit (dynamic
+    // state, descriptor sets, pipelines). The buffers stay valid until the
+    // next record() or beginFrame().
+    const std::vector<VkCommandBuffer>& record(const Device& device, JobSystem& jobs,
+                                               VkRenderPass renderPass, uint32_t subpass,
+                                               VkFramebuffer framebuffer, size_t count,
+                                               const std::function<void(VkCommandBuffer, size_t)>& recordItem);
+
+    // CPU time spent recording a frame's draws, whichever way they were recorded
+    void recordFrameTime(double milliseconds);
+    void printReport() const;
+
+private:
+    struct Slot {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> buffers;   // allocated from pool, kept across resets
+        size_t used = 0;                        // handed out since the last reset
+    };
+
+    static constexpr uint32_t kAllocationBatch = 8;   // secondaries allocated at a time per slot
+
+    Slot& slot(uint32_t frame, uint32_t index) { return m_slots[frame * m_slotCount + index]; }
+    VkCommandBuffer acquire(const Device& device, Slot& slot);
+
+    uint32_t m_slotCount = 0;
+    uint32_t m_frame = 0;
+    std::vector<Slot> m_slots;                   // per (frame in flight, slot)
+    std::vector<VkCommandBuffer> m_recorded;     // last record(), in item order
+
+    // Totals for printReport()
+    uint64_t m_frames = 0;
+    double m_totalMs = 0.0;
+    double m_worstMs = 0.0;
+    uint64_t m_secondaries = 0;
+};
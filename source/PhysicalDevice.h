@@ -14,6 +14,8 @@ struct SwapChainSupportDetails {
 struct QueueFamilyIndices {
     std::optional<uint32_t> graphicsFamily;
     std::optional<uint32_t> presentFamily;
+    std::optional<uint32_t> transferFamily;   // dedicated: transfer only, no graphics or compute
+    std::optional<uint32_t> computeFamily;    // dedicated: compute without graphics
 
     bool isComplete() {
         return graphicsFamily.has_value() && presentFamily.has_value();
@@ -1,4 +1,5 @@
 #include "Pipeline.h"
+#include "PipelineCache.h"
 #include "Vertex.h"
 #include <stdexcept>
 
@@ -23,7 +24,7 @@ void PipelineLayoutRAII::destroy(const Device& device)
     }
 }
 
-void GraphicsPipeline::create(const Device& device, VkRenderPass renderPass, VkPipelineLayout layout,
+void GraphicsPipeline::create(const Device& device, PipelineCache& pipelineCache, VkRenderPass renderPass, VkPipelineLayout layout,
     VkExtent2D extent, VkSampleCountFlagBits msaa, VkDescriptorSetLayout descriptorSetLayout,
     VkShaderModule vertexShader, VkShaderModule fragmentShader)
 {
@@ -174,9 +175,7 @@ void GraphicsPipeline::create(const Device& device, VkRenderPass renderPass, VkP
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
     pipelineInfo.basePipelineIndex = -1; // Optional
 
-    if (vkCreateGraphicsPipelines(device.get(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS) {
-        throw std::runtime_error("failed to create graphics pipeline!");
-    }
+    m_pipeline = pipelineCache.createGraphicsPipeline(device, pipelineInfo, "basic");
 
     vkDestroyShaderModule(device.get(), fragmentShader, nullptr);
     vkDestroyShaderModule(device.get(), vertexShader, nullptr);
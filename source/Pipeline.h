@@ -3,6 +3,8 @@
 #include <vector>
 #include "Device.h"
 
+class PipelineCache;
+
 class PipelineLayoutRAII {
 public:
     void create(const Device& device, const std::vector<VkDescriptorSetLayout>& setLayouts, const std::vector<VkPushConstantRange>& pushConstants);
@@ -14,7 +16,7 @@ private:
 
 class GraphicsPipeline {
 public:
-    void create(const Device& device, VkRenderPass renderPass, VkPipelineLayout layout,
+    void create(const Device& device, PipelineCache& pipelineCache, VkRenderPass renderPass, VkPipelineLayout layout,
         VkExtent2D extent, VkSampleCountFlagBits msaa, VkDescriptorSetLayout descriptorSetLayout,
         VkShaderModule vertexShader, VkShaderModule fragmentShader);
     void destroy(const Device& device);
@@ -0,0 +1,288 @@
+// ============================================================================
+// PipelineCache.cpp - Disk-backed VkPipelineCache
+// ============================================================================
+
+#include "PipelineCache.h"
+#include "Device.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+constexpr char kFileMagic[4] = { 'K', 'P', 'S', 'O' };
+constexpr uint32_t kFileVersion = 1;
+
+// Written in front of the driver's blob. The blob carries vendor, device and
+// UUID itself, but not the driver version, and a truncated file is only
+// caught by the size and hash.
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+    uint64_t dataSize;
+    uint64_t dataHash;
+};
+
+uint64_t hashBytes(const char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;   // FNV-1a
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+VkPhysicalDeviceProperties deviceProperties(const Device& device) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device.physical(), &properties);
+    return properties;
+}
+
+} // namespace
+
+// ============================================================================
+// Creation
+// ============================================================================
+
+void PipelineCache::create(const Device& device, const std::string& path) {
+    m_path = path;
+    m_stats = {};
+
+    std::vector<char> data;
+    m_loadedFromDisk = !m_path.empty() && readFile(device, data);
+
+    VkPipelineCacheCreateInfo cacheInfo{ VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+    cacheInfo.initialDataSize = m_loadedFromDisk ? data.size() : 0;
+    cacheInfo.pInitialData = m_loadedFromDisk ? data.data() : nullptr;
+
+    VkResult result = vkCreatePipelineCache(device.get(), &cacheInfo, nullptr, &m_cache);
+    if (result != VK_SUCCESS && m_loadedFromDisk) {
+        // Drivers may still refuse data that passed our checks; start over empty
+        std::cerr << "Warning: driver rejected pipeline cache " << m_path << ", starting empty" << std::endl;
+        m_loadedFromDisk = false;
+        cacheInfo.initialDataSize = 0;
+        cacheInfo.pInitialData = nullptr;
+        result = vkCreatePipelineCache(device.get(), &cacheInfo, nullptr, &m_cache);
+    }
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline cache");
+    }
+
+    if (m_loadedFromDisk) {
+        std::cout << "Pipeline cache: loaded " << data.size() / 1024 << " KB from " << m_path << std::endl;
+    }
+}
+
+void PipelineCache::destroy(const Device& device) {
+    if (m_cache != VK_NULL_HANDLE) {
+        vkDestroyPipelineCache(device.get(), m_cache, nullptr);
+        m_cache = VK_NULL_HANDLE;
+    }
+}
+
+// ============================================================================
+// Disk I/O
+// ============================================================================
+
+bool PipelineCache::readFile(const Device& device, std::vector<char>& data) const {
+    std::ifstream file(m_path, std::ios::binary);
+    if (!file) {
+        std::cout << "Pipeline cache: no cache file at " << m_path << ", starting empty" << std::endl;
+        return false;
+    }
+
+    auto discard = [this](const char* reason) {
+        std::cout << "Pipeline cache: discarding " << m_path << " (" << reason << ")" << std::endl;
+        return false;
+    };
+
+    FileHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) != 0 ||
+        header.version != kFileVersion) {
+        return discard("unknown format");
+    }
+
+    VkPhysicalDeviceProperties properties = deviceProperties(device);
+    if (header.vendorID != properties.vendorID || header.deviceID != properties.deviceID ||
+        std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        return discard("written by a different device");
+    }
+    if (header.driverVersion != properties.driverVersion) {
+        return discard("written by a different driver version");
+    }
+
+    data.resize(static_cast<size_t>(header.dataSize));
+    file.read(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!file || hashBytes(data.data(), data.size()) != header.dataHash) {
+        return discard("truncated or corrupt");
+    }
+
+    // The driver's own header must agree with ours
+    VkPipelineCacheHeaderVersionOne driverHeader{};
+    if (data.size() < sizeof(driverHeader)) {
+        return discard("missing driver header");
+    }
+    std::memcpy(&driverHeader, data.data(), sizeof(driverHeader));
+    if (driverHeader.headerSize < sizeof(driverHeader) ||
+        driverHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+        driverHeader.vendorID != properties.vendorID ||
+        driverHeader.deviceID != properties.deviceID ||
+        std::memcmp(driverHeader.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        return discard("driver header mismatch");
+    }
+    return true;
+}
+
+size_t PipelineCache::dataSize(const Device& device) const {
+    size_t size = 0;
+    vkGetPipelineCacheData(device.get(), m_cache, &size, nullptr);
+    return size;
+}
+
+void PipelineCache::save(const Device& device) const {
+    if (m_path.empty() || m_cache == VK_NULL_HANDLE) {
+        return;
+    }
+
+    size_t size = dataSize(device);
+    std::vector<char> data(size);
+    if (size == 0 || vkGetPipelineCacheData(device.get(), m_cache, &size, data.data()) != VK_SUCCESS) {
+        std::cerr << "Warning: could not read back pipeline cache data" << std::endl;
+        return;
+    }
+    data.resize(size);
+
+    VkPhysicalDeviceProperties properties = deviceProperties(device);
+    FileHeader header{};
+    std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+    header.version = kFileVersion;
+    header.vendorID = properties.vendorID;
+    header.deviceID = properties.deviceID;
+    header.driverVersion = properties.driverVersion;
+    std::memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+    header.dataSize = data.size();
+    header.dataHash = hashBytes(data.data(), data.size());
+
+    std::error_code ec;
+    std::filesystem::path path(m_path);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+
+    // Write beside the old file and swap, so a crash mid-write leaves the old cache intact
+    std::string tempPath = m_path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "Warning: could not write pipeline cache " << m_path << std::endl;
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!file) {
+            std::cerr << "Warning: could not write pipeline cache " << m_path << std::endl;
+            return;
+        }
+    }
+    std::filesystem::rename(tempPath, m_path, ec);
+    if (ec) {
+        std::cerr << "Warning: could not replace pipeline cache " << m_path << ": " << ec.message() << std::endl;
+        return;
+    }
+
+    std::cout << "Pipeline cache: saved " << data.size() / 1024 << " KB to " << m_path << std::endl;
+}
+
+// ============================================================================
+// Pipeline Creation
+// ============================================================================
+
+VkPipeline PipelineCache::createGraphicsPipeline(const Device& device, const VkGraphicsPipelineCreateInfo& info,
+                                                 const char* name) {
+    VkGraphicsPipelineCreateInfo pipelineInfo = info;
+
+    // Creation feedback reports cache hits directly; without it, a miss is
+    // inferred from the cache growing
+    VkPipelineCreationFeedbackEXT feedback{};
+    std::vector<VkPipelineCreationFeedbackEXT> stageFeedback(info.stageCount);
+    VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo{ VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT };
+    if (device.hasPipelineCreationFeedback()) {
+        feedbackInfo.pNext = info.pNext;
+        feedbackInfo.pPipelineCreationFeedback = &feedback;
+        feedbackInfo.pipelineStageCreationFeedbackCount = info.stageCount;
+        feedbackInfo.pPipelineStageCreationFeedbacks = stageFeedback.data();
+        pipelineInfo.pNext = &feedbackInfo;
+    }
+    size_t sizeBefore = dataSize(device);
+
+    auto start = std::chrono::steady_clock::now();
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateGraphicsPipelines(device.get(), m_cache, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
+        throw std::runtime_error(std::string("Failed to create graphics pipeline: ") + name);
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    recordCreation(device, name, feedback, sizeBefore, ms);
+    return pipeline;
+}
+
+VkPipeline PipelineCache::createComputePipeline(const Device& device, const VkComputePipelineCreateInfo& info,
+                                                const char* name) {
+    VkComputePipelineCreateInfo pipelineInfo = info;
+
+    VkPipelineCreationFeedbackEXT feedback{};
+    VkPipelineCreationFeedbackEXT stageFeedback{};
+    VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo{ VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT };
+    if (device.hasPipelineCreationFeedback()) {
+        feedbackInfo.pNext = info.pNext;
+        feedbackInfo.pPipelineCreationFeedback = &feedback;
+        feedbackInfo.pipelineStageCreationFeedbackCount = 1;
+        feedbackInfo.pPipelineStageCreationFeedbacks = &stageFeedback;
+        pipelineInfo.pNext = &feedbackInfo;
+    }
+    size_t sizeBefore = dataSize(device);
+
+    auto start = std::chrono::steady_clock::now();
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateComputePipelines(device.get(), m_cache, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
+        throw std::runtime_error(std::string("Failed to create compute pipeline: ") + name);
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    recordCreation(device, name, feedback, sizeBefore, ms);
+    return pipeline;
+}
+
+void PipelineCache::recordCreation(const Device& device, const char* name, const VkPipelineCreationFeedbackEXT& feedback,
+                                   size_t sizeBefore, double ms) {
+    bool hit;
+    const char* source;
+    if (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT) {
+        hit = (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT) != 0;
+        source = "creation feedback";
+    } else {
+        hit = dataSize(device) == sizeBefore;
+        source = "inferred from cache size";
+    }
+
+    m_stats.pipelines++;
+    (hit ? m_stats.hits : m_stats.misses)++;
+    m_stats.createMs += ms;
+
+    std::cout << "Pipeline '" << name << "': " << ms << " ms, cache " << (hit ? "hit" : "miss")
+              << " (" << source << ")" << std::endl;
+}
+
+void PipelineCache::printStats() const {
+    std::cout << "Pipeline cache: " << m_stats.pipelines << " pipelines, " << m_stats.hits << " hits, "
+              << m_stats.misses << " misses, " << m_stats.createMs << " ms creating"
+              << (m_loadedFromDisk ? " (warm start)" : " (cold start)") << std::endl;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Device;
+
+// ============================================================================
+// Pipeline Cache
+// One VkPipelineCache for every pipeline the renderer builds, seeded from disk
+// at startup and written back on shutdown so later runs skip most shader
+// compilation. A cache file is only used when it was written by the same
+// device (vendor, device ID, pipelineCacheUUID) and driver version; anything
+// else is discarded and the cache starts empty.
+// ============================================================================
+
+class PipelineCache {
+public:
+    // An empty path keeps the cache in memory only (nothing read or written)
+    void create(const Device& device, const std::string& path);
+    void destroy(const Device& device);
+
+    // Write the current cache contents to the file given to create()
+    void save(const Device& device) const;
+
+    // vkCreateGraphicsPipelines through the cache, logging the creation time
+    // and whether the pipeline came from the cache. Throws on failure.
+    VkPipeline createGraphicsPipeline(const Device& device, const VkGraphicsPipelineCreateInfo& info,
+                                      const char* name);
+    VkPipeline createComputePipeline(const Device& device, const VkComputePipelineCreateInfo& info,
+                                     const char* name);
+
+    VkPipelineCache get() const { return m_cache; }
+    bool loadedFromDisk() const { return m_loadedFromDisk; }
+    void printStats() const;
+
+private:
+    struct Stats {
+        uint32_t pipelines = 0;
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+        double createMs = 0.0;
+    };
+
+    bool readFile(const Device& device, std::vector<char>& data) const;
+    size_t dataSize(const Device& device) const;
+    void recordCreation(const Device& device, const char* name, const VkPipelineCreationFeedbackEXT& feedback,
+                        size_t sizeBefore, double ms);
+
+    VkPipelineCache m_cache = VK_NULL_HANDLE;
+    std::string m_path;
+    bool m_loadedFromDisk = false;
+    Stats m_stats;
+};
@@ -0,0 +1,106 @@
+// ============================================================================
+// PipelineStatistics.cpp - Fragment invocation counters
+// ============================================================================
+
+#include "PipelineStatistics.h"
+#include "Device.h"
+#include <iostream>
+#include <stdexcept>
+
+void PipelineStatistics::create(const Device& device, uint32_t framesInFlight) {
+    m_frames.assign(framesInFlight, FrameState{});
+    m_totals[0] = m_totals[1] = Totals{};
+
+    if (!device.features().pipelineStatisticsQuery) {
+        std::cout << "Pipeline statistics queries unsupported, fragment counts disabled" << std::endl;
+        return;
+    }
+
+    VkQueryPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+    poolInfo.queryCount = framesInFlight * SCOPE_COUNT;
+    poolInfo.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+    if (vkCreateQueryPool(device.get(), &poolInfo, nullptr, &m_pool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline statistics query pool");
+    }
+}
+
+void PipelineStatistics::destroy(const Device& device) {
+    if (m_pool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(device.get(), m_pool, nullptr);
+        m_pool = VK_NULL_HANDLE;
+    }
+    m_frames.clear();
+}
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+void PipelineStatistics::reset(VkCommandBuffer cmd, uint32_t frame, bool depthPrepass) {
+    if (!isEnabled()) return;
+
+    vkCmdResetQueryPool(cmd, m_pool, queryIndex(frame, SCOPE_DEPTH_PREPASS), SCOPE_COUNT);
+    m_frames[frame].writtenScopes = 0;
+    m_frames[frame].depthPrepass = depthPrepass;
+}
+
+void PipelineStatistics::begin(VkCommandBuffer cmd, uint32_t frame, Scope scope) {
+    if (!isEnabled()) return;
+
+    vkCmdBeginQuery(cmd, m_pool, queryIndex(frame, scope), 0);
+}
+
+void PipelineStatistics::end(VkCommandBuffer cmd, uint32_t frame, Scope scope) {
+    if (!isEnabled()) return;
+
+    vkCmdEndQuery(cmd, m_pool, queryIndex(frame, scope));
+    m_frames[frame].writtenScopes |= 1u << scope;
+}
+
+// ============================================================================
+// Readback
+// ============================================================================
+
+void PipelineStatistics::collect(const Device& device, uint32_t frame) {
+    if (!isEnabled() || m_frames[frame].writtenScopes == 0) return;
+
+    FrameState& state = m_frames[frame];
+    Totals& totals = m_totals[state.depthPrepass ? 1 : 0];
+    for (uint32_t scope = 0; scope < SCOPE_COUNT; ++scope) {
+        if (!(state.writtenScopes & (1u << scope))) continue;
+
+        uint64_t fragments = 0;
+        VkResult result = vkGetQueryPoolResults(device.get(), m_pool, queryIndex(frame, static_cast<Scope>(scope)), 1,
+                                                sizeof(fragments), &fragments, sizeof(fragments),
+                                                VK_QUERY_RESULT_64_BIT);
+        if (result == VK_SUCCESS) {
+            totals.fragments[scope] += fragments;
+        }
+    }
+    state.writtenScopes = 0;
+
+    totals.frames++;
+    if (totals.frames % kReportInterval == 0) {
+        printTotals(totals, state.depthPrepass);
+    }
+}
+
+void PipelineStatistics::printTotals(const Totals& totals, bool depthPrepass) const {
+    double frames = static_cast<double>(totals.frames);
+    double prepass = totals.fragments[SCOPE_DEPTH_PREPASS] / frames;
+    double main = totals.fragments[SCOPE_MAIN_PASS] / frames;
+    std::cout << "Fragment invocations/frame (depth pre-pass " << (depthPrepass ? "on" : "off") << ", "
+              << totals.frames << " frames): pre-pass " << static_cast<uint64_t>(prepass)
+              << ", main " << static_cast<uint64_t>(main) << std::endl;
+}
+
+void PipelineStatistics::printReport() const {
+    for (int mode = 0; mode < 2; ++mode) {
+        if (m_totals[mode].frames > 0) {
+            printTotals(m_totals[mode], mode == 1);
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+class Device;
+
+// ============================================================================
+// Pipeline Statistics
+// Fragment shader invocation counts per frame, from one pipeline statistics
+// query pool with a query per (frame in flight, scope). Results are read
+// after the frame's timeline wait, so they never stall, and averaged separately
+// for frames drawn with and without the depth pre-pass so the two modes can
+// be compared on the same scene. Needs the pipelineStatisticsQuery feature;
+// without it every call is a no-op.
+// ============================================================================
+
+class PipelineStatistics {
+public:
+    enum Scope : uint32_t {
+        SCOPE_DEPTH_PREPASS = 0,
+        SCOPE_MAIN_PASS,
+        SCOPE_COUNT
+    };
+
+    void create(const Device& device, uint32_t framesInFlight);
+    void destroy(const Device& device);
+
+    bool isEnabled() const { return m_pool != VK_NULL_HANDLE; }
+
+    // Record outside the render pass, before the frame's first begin()
+    void reset(VkCommandBuffer cmd, uint32_t frame, bool depthPrepass);
+    // Must begin and end in the same subpass
+    void begin(VkCommandBuffer cmd, uint32_t frame, Scope scope);
+    void end(VkCommandBuffer cmd, uint32_t frame, Scope scope);
+
+    // Read back frame `frame`'s counts; only call after that frame's timeline wait
+    void collect(const Device& device, uint32_t frame);
+
+    // Per-mode averages over every collected frame
+    void printReport() const;
+
+private:
+    struct FrameState {
+        uint32_t writtenScopes = 0;   // bit per Scope
+        bool depthPrepass = false;
+    };
+    struct Totals {
+        uint64_t frames = 0;
+        uint64_t fragments[SCOPE_COUNT] = {};
+    };
+
+    static constexpr uint32_t kReportInterval = 600;   // frames per mode between log lines
+
+    uint32_t queryIndex(uint32_t frame, Scope scope) const { return frame * SCOPE_COUNT + scope; }
+    void printTotals(const Totals& totals, bool depthPrepass) const;
+
+    VkQueryPool m_pool = VK_NULL_HANDLE;
+    std::vector<FrameState> m_frames;
+    Totals m_totals[2];   // [0] = no pre-pass, [1] = depth pre-pass
+};
@@ -34,6 +34,21 @@ void RenderPass::create(const Device& device, VkFormat colorFormat, VkFormat dep
     depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
+    // Weighted-blended OIT targets: cleared each frame, only read back as
+    // input attachments within the pass, never stored
+    VkAttachmentDescription oitAccumAttachment{};
+    oitAccumAttachment.format = kOitAccumFormat;
+    oitAccumAttachment.samples = msaa;
+    oitAccumAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    oitAccumAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    oitAccumAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    oitAccumAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    oitAccumAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    oitAccumAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkAttachmentDescription oitRevealageAttachment = oitAccumAttachment;
+    oitRevealageAttachment.format = kOitRevealageFormat;
+
     VkAttachmentReference colorAttachmentRef{};
     colorAttachmentRef.attachment = 0;          // index in the attachment descriptions array.
     colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
@@ -46,30 +61,104 @@ void RenderPass::create(const Device& device, VkFormat colorFormat, VkFormat dep
     colorAttachmentResolveRef.attachment = 2;
     colorAttachmentResolveRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
-    VkSubpassDescription subpass{};
-    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-    subpass.colorAttachmentCount = 1;
-    subpass.pColorAttachments = &colorAttachmentRef;
-    subpass.pResolveAttachments = &colorAttachmentResolveRef;
-    subpass.pDepthStencilAttachment = &depthAttachmentRef;
-
-    VkSubpassDependency dependency{};
-    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-    dependency.dstSubpass = 0;
-    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-    dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-
-    std::array<VkAttachmentDescription, 3> attachments = { colorAttachment, depthAttachment, colorAttachmentResolve };
+    VkAttachmentReference depthReadOnlyRef{};
+    depthReadOnlyRef.attachment = 1;
+    depthReadOnlyRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+    std::array<VkAttachmentReference, 2> oitTargetRefs{};
+    oitTargetRefs[0] = { 3, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+    oitTargetRefs[1] = { 4, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+
+    std::array<VkAttachmentReference, 2> oitInputRefs{};
+    oitInputRefs[0] = { 3, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    oitInputRefs[1] = { 4, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+
+    // Scene color stays untouched through the OIT subpass
+    uint32_t preservedColor = 0;
+
+    std::array<VkSubpassDescription, SUBPASS_COUNT> subpasses{};
+    subpasses[SUBPASS_SCENE].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpasses[SUBPASS_SCENE].colorAttachmentCount = 1;
+    subpasses[SUBPASS_SCENE].pColorAttachments = &colorAttachmentRef;
+    subpasses[SUBPASS_SCENE].pDepthStencilAttachment = &depthAttachmentRef;
+
+    subpasses[SUBPASS_OIT_ACCUMULATE].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpasses[SUBPASS_OIT_ACCUMULATE].colorAttachmentCount = static_cast<uint32_t>(oitTargetRefs.size());
+    subpasses[SUBPASS_OIT_ACCUMULATE].pColorAttachments = oitTargetRefs.data();
+    subpasses[SUBPASS_OIT_ACCUMULATE].pDepthStencilAttachment = &depthReadOnlyRef;
+    subpasses[SUBPASS_OIT_ACCUMULATE].preserveAttachmentCount = 1;
+    subpasses[SUBPASS_OIT_ACCUMULATE].pPreserveAttachments = &preservedColor;
+
+    subpasses[SUBPASS_COMPOSITE].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpasses[SUBPASS_COMPOSITE].inputAttachmentCount = static_cast<uint32_t>(oitInputRefs.size());
+    subpasses[SUBPASS_COMPOSITE].pInputAttachments = oitInputRefs.data();
+    subpasses[SUBPASS_COMPOSITE].colorAttachmentCount = 1;
+    subpasses[SUBPASS_COMPOSITE].pColorAttachments = &colorAttachmentRef;
+    subpasses[SUBPASS_COMPOSITE].pResolveAttachments = &colorAttachmentResolveRef;
+
+    std::array<VkSubpassDependency, 6> dependencies{};
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = SUBPASS_SCENE;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    // Scene depth -> OIT depth test
+    dependencies[1].srcSubpass = SUBPASS_SCENE;
+    dependencies[1].dstSubpass = SUBPASS_OIT_ACCUMULATE;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+    dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    // OIT targets -> resolve input reads
+    dependencies[2].srcSubpass = SUBPASS_OIT_ACCUMULATE;
+    dependencies[2].dstSubpass = SUBPASS_COMPOSITE;
+    dependencies[2].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[2].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[2].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[2].dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+    dependencies[2].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    // Scene color -> composite blending over it
+    dependencies[3].srcSubpass = SUBPASS_SCENE;
+    dependencies[3].dstSubpass = SUBPASS_COMPOSITE;
+    dependencies[3].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[3].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[3].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[3].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[3].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    // Attachments first touched after subpass 0 (the OIT targets, cleared on
+    // first use, and the swapchain image, written by the resolve) must also
+    // wait for the previous frame's use of them
+    dependencies[4].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[4].dstSubpass = SUBPASS_OIT_ACCUMULATE;
+    dependencies[4].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[4].srcAccessMask = 0;
+    dependencies[4].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[4].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+    dependencies[5].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[5].dstSubpass = SUBPASS_COMPOSITE;
+    dependencies[5].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[5].srcAccessMask = 0;
+    dependencies[5].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[5].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+    std::array<VkAttachmentDescription, 5> attachments = {
+        colorAttachment, depthAttachment, colorAttachmentResolve, oitAccumAttachment, oitRevealageAttachment
+    };
     VkRenderPassCreateInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
     renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
     renderPassInfo.pAttachments = attachments.data();
-    renderPassInfo.subpassCount = 1;
-    renderPassInfo.pSubpasses = &subpass;
-    renderPassInfo.dependencyCount = 1;
-    renderPassInfo.pDependencies = &dependency;
+    renderPassInfo.subpassCount = static_cast<uint32_t>(subpasses.size());
+    renderPassInfo.pSubpasses = subpasses.data();
+    renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+    renderPassInfo.pDependencies = dependencies.data();
 
     if (vkCreateRenderPass(device.get(), &renderPassInfo, nullptr, &m_renderPass) != VK_SUCCESS) {
         throw std::runtime_error("failed to create render pass!");
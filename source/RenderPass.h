@@ -2,8 +2,22 @@
 #include <vulkan/vulkan.h>
 #include "Device.h"
 
+// Subpasses of the main render pass:
+//   0 scene:      color + depth; opaque, mask and (sorted mode) blend draws
+//   1 OIT:        weighted-blended accumulation into accum/revealage, depth read-only
+//   2 composite:  OIT resolve over the scene color, then the MSAA resolve
+// Attachments: 0 color, 1 depth, 2 swapchain (resolve), 3 OIT accum, 4 OIT revealage
 class RenderPass {
 public:
+    enum Subpass : uint32_t {
+        SUBPASS_SCENE = 0,
+        SUBPASS_OIT_ACCUMULATE,
+        SUBPASS_COMPOSITE,
+        SUBPASS_COUNT
+    };
+    static constexpr VkFormat kOitAccumFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
+    static constexpr VkFormat kOitRevealageFormat = VK_FORMAT_R16_SFLOAT;
+
     void create(const Device& device, VkFormat colorFormat, VkFormat depthFormat, VkSampleCountFlagBits msaa);
     void destroy(const Device& device);
     VkRenderPass get() const { return m_renderPass; }
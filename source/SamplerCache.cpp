@@ -0,0 +1,114 @@
+// ============================================================================
+// SamplerCache.cpp - Deduplicated sampler objects
+// ============================================================================
+
+#include "SamplerCache.h"
+#include "Device.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+
+// ============================================================================
+// Sampler Key
+// ============================================================================
+
+bool SamplerKey::operator==(const SamplerKey& other) const {
+    return magFilter == other.magFilter &&
+           minFilter == other.minFilter &&
+           mipmapMode == other.mipmapMode &&
+           addressModeU == other.addressModeU &&
+           addressModeV == other.addressModeV &&
+           addressModeW == other.addressModeW &&
+           maxAnisotropy == other.maxAnisotropy &&
+           minLod == other.minLod &&
+           maxLod == other.maxLod;
+}
+
+size_t SamplerKeyHash::operator()(const SamplerKey& key) const {
+    auto floatBits = [](float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    };
+
+    size_t hash = 0;
+    auto combine = [&hash](uint32_t value) {
+        hash ^= std::hash<uint32_t>{}(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+    combine(static_cast<uint32_t>(key.magFilter));
+    combine(static_cast<uint32_t>(key.minFilter));
+    combine(static_cast<uint32_t>(key.mipmapMode));
+    combine(static_cast<uint32_t>(key.addressModeU));
+    combine(static_cast<uint32_t>(key.addressModeV));
+    combine(static_cast<uint32_t>(key.addressModeW));
+    combine(floatBits(key.maxAnisotropy));
+    combine(floatBits(key.minLod));
+    combine(floatBits(key.maxLod));
+    return hash;
+}
+
+// ============================================================================
+// Sampler Cache
+// ============================================================================
+
+void SamplerCache::create(const Device& device) {
+    m_maxAnisotropy = 0.0f;
+    if (device.features().samplerAnisotropy == VK_TRUE) {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(device.physical(), &properties);
+        m_maxAnisotropy = properties.limits.maxSamplerAnisotropy;
+    }
+    m_requests = 0;
+}
+
+void SamplerCache::destroy(const Device& device) {
+    for (auto& entry : m_samplers) {
+        vkDestroySampler(device.get(), entry.second, nullptr);
+    }
+    m_samplers.clear();
+}
+
+VkSampler SamplerCache::get(const Device& device, SamplerKey key) {
+    m_requests++;
+
+    // Anisotropy below 1 means off; normalize so "off" has one key
+    key.maxAnisotropy = std::min(key.maxAnisotropy, m_maxAnisotropy);
+    if (key.maxAnisotropy < 1.0f) {
+        key.maxAnisotropy = 0.0f;
+    }
+
+    auto it = m_samplers.find(key);
+    if (it != m_samplers.end()) {
+        return it->second;
+    }
+
+    VkSamplerCreateInfo samplerCreateInfo{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
+    samplerCreateInfo.magFilter = key.magFilter;
+    samplerCreateInfo.minFilter = key.minFilter;
+    samplerCreateInfo.mipmapMode = key.mipmapMode;
+    samplerCreateInfo.addressModeU = key.addressModeU;
+    samplerCreateInfo.addressModeV = key.addressModeV;
+    samplerCreateInfo.addressModeW = key.addressModeW;
+    samplerCreateInfo.anisotropyEnable = key.maxAnisotropy > 0.0f ? VK_TRUE : VK_FALSE;
+    samplerCreateInfo.maxAnisotropy = std::max(key.maxAnisotropy, 1.0f);
+    samplerCreateInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+    samplerCreateInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerCreateInfo.compareEnable = VK_FALSE;
+    samplerCreateInfo.minLod = key.minLod;
+    samplerCreateInfo.maxLod = key.maxLod;
+    samplerCreateInfo.mipLodBias = 0.0f;
+
+    VkSampler sampler;
+    if (vkCreateSampler(device.get(), &samplerCreateInfo, nullptr, &sampler) != VK_SUCCESS) {
+        throw std::runtime_error("SamplerCache: create sampler failed");
+    }
+    m_samplers.emplace(key, sampler);
+    return sampler;
+}
+
+void SamplerCache::printStats() const {
+    std::cout << "Sampler cache: " << m_samplers.size() << " unique samplers for "
+              << m_requests << " requests" << std::endl;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+class Device;
+
+// Everything that distinguishes one sampler from another in this renderer
+struct SamplerKey {
+    VkFilter magFilter = VK_FILTER_LINEAR;
+    VkFilter minFilter = VK_FILTER_LINEAR;
+    VkSamplerMipmapMode mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    VkSamplerAddressMode addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    VkSamplerAddressMode addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    VkSamplerAddressMode addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    float maxAnisotropy = 16.0f;              // 0 = anisotropic filtering off
+    float minLod = 0.0f;
+    float maxLod = VK_LOD_CLAMP_NONE;         // the image view limits the levels
+
+    bool operator==(const SamplerKey& other) const;
+};
+
+struct SamplerKeyHash {
+    size_t operator()(const SamplerKey& key) const;
+};
+
+// ============================================================================
+// Sampler Cache
+// One VkSampler per unique sampler state, shared by every texture that asks
+// for it. Samplers live until destroy(); textures using them must not
+// destroy them (see Texture's sharedSampler parameter).
+// ============================================================================
+
+class SamplerCache {
+public:
+    void create(const Device& device);
+    void destroy(const Device& device);
+
+    // Anisotropy is clamped to the device limit before lookup, so keys that
+    // only differ beyond what the device supports share a sampler
+    VkSampler get(const Device& device, SamplerKey key);
+
+    size_t size() const { return m_samplers.size(); }
+    uint32_t requests() const { return m_requests; }
+    void printStats() const;
+
+private:
+    std::unordered_map<SamplerKey, VkSampler, SamplerKeyHash> m_samplers;
+    float m_maxAnisotropy = 0.0f;   // 0 when samplerAnisotropy is not enabled
+    uint32_t m_requests = 0;
+};
@@ -1,9 +1,11 @@
 #include "Swapchain.h"
+#include "DeletionQueue.h"
 #include "PhysicalDevice.h"
 #include "Utilities.h"
 #include <stdexcept>
 #include <GLFW/glfw3.h>
 #include <algorithm>
+#include <limits>
 
 VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats) {
     for (const auto& availableFormat : availableFormats) {
@@ -39,7 +41,8 @@ VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities, GLFWwi
     }
 }
 
-void Swapchain::create(const Device& device, VkSurfaceKHR surface, GLFWwindow* window)
+void Swapchain::create(const Device& device, VkSurfaceKHR surface, GLFWwindow* window,
+                       VkSwapchainKHR oldSwapchain)
 {
     m_device = device;
 
@@ -86,7 +89,7 @@ void Swapchain::create(const Device& device, VkSurfaceKHR surface, GLFWwindow* w
     createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
     createInfo.presentMode = presentMode;
     createInfo.clipped = VK_TRUE;
-    createInfo.oldSwapchain = VK_NULL_HANDLE;
+    createInfo.oldSwapchain = oldSwapchain;   // lets the driver reuse its resources
 
     if (vkCreateSwapchainKHR(device.get(), &createInfo, nullptr, &m_swapchain) != VK_SUCCESS) {
         throw std::runtime_error("failed to create swap chain!");
@@ -103,11 +106,23 @@ void Swapchain::create(const Device& device, VkSurfaceKHR surface, GLFWwindow* w
 
 void Swapchain::destroy(const Device& device)
 {
+    // The device is idle; swapchains never retired go too
+    for (Old& old : m_old) {
+        for (VkImageView view : old.views) {
+            vkDestroyImageView(device.get(), view, nullptr);
+        }
+        vkDestroySwapchainKHR(device.get(), old.swapchain, nullptr);
+    }
+    m_old.clear();
+
     for (auto imageView : m_views) {
         vkDestroyImageView(device.get(), imageView, nullptr);
     }
 
+    m_views.clear();
+
     vkDestroySwapchainKHR(device.get(), m_swapchain, nullptr);
+    m_swapchain = VK_NULL_HANDLE;
 }
 
 void Swapchain::createImageViews(const Device& device) {
@@ -125,12 +140,26 @@ void Swapchain::recreate(const Device& device, VkSurfaceKHR surface, GLFWwindow*
         glfwWaitEvents();
     }
 
-    vkDeviceWaitIdle(device.get());
+    Old old;
+    old.swapchain = m_swapchain;
+    old.views = std::move(m_views);
+    m_views.clear();
 
-    destroy(device);
+    create(device, surface, window, old.swapchain);
+    m_old.push_back(std::move(old));
+}
 
-    create(device, surface, window);
-    createImageViews(device);
+void Swapchain::retireOld(const Device& device, DeletionQueue& deletionQueue, uint64_t retireValue) {
+    VkDevice handle = device.get();
+    for (Old& old : m_old) {
+        deletionQueue.push(retireValue, [handle, old]() {
+            for (VkImageView view : old.views) {
+                vkDestroyImageView(handle, view, nullptr);
+            }
+            vkDestroySwapchainKHR(handle, old.swapchain, nullptr);
+        });
+    }
+    m_old.clear();
 }
 
 VkFormat Swapchain::depthFormat()
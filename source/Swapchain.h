@@ -3,11 +3,28 @@
 #include <vector>
 #include "Device.h"
 #include <GLFW/glfw3.h>
+#include <cstdint>
+
+class DeletionQueue;
 
 class Swapchain {
 public:
-    void create(const Device& device, VkSurfaceKHR surface, GLFWwindow* window);
+    // `oldSwapchain` is retired by the new one but still owned by the caller
+    void create(const Device& device, VkSurfaceKHR surface, GLFWwindow* window,
+                VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
+    // Build a new swapchain from the current one without idling the device.
+    // Frames in flight may still render to and present the old images, so
+    // the old swapchain and its views are kept until retireOld().
     void recreate(const Device& device, VkSurfaceKHR surface, GLFWwindow* window);
+    // Hand the swapchains recreate() replaced to `deletionQueue` at
+    // `retireValue`. A queue submission's completion says nothing about a
+    // present queued before it (VUID-vkDestroySwapchainKHR-swapchain-01282)
+    // and there are no present fences without VK_EXT_swapchain_maintenance1,
+    // so only call this with the value of a frame submitted after an image
+    // of the current swapchain was presented: by then the presentation
+    // engine has moved on to the new swapchain.
+    void retireOld(const Device& device, DeletionQueue& deletionQueue, uint64_t retireValue);
+    bool hasOld() const { return !m_old.empty(); }
     void destroy(const Device& device);
     VkFormat imageFormat() const { return m_format; }
     VkExtent2D extent() const { return m_extent; }
@@ -16,7 +33,13 @@ public:
     VkFormat depthFormat();
     VkSampleCountFlagBits msaa() const { return m_msaaSamples; }
 private:
+    struct Old {
+        VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+        std::vector<VkImageView> views;
+    };
+
     VkSwapchainKHR m_swapchain = VK_NULL_HANDLE;
+    std::vector<Old> m_old;                  // replaced by recreate(), not yet retired
     std::vector<VkImage> m_swapchainImages;
     std::vector<VkImageView> m_views;
     VkFormat m_format{};
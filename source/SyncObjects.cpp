@@ -1,26 +1,34 @@
 #include "SyncObjects.h"
 #include <stdexcept>
 
-void SyncObjects::create(const Device& device, size_t maxFramesInFlight)
+void SyncObjects::create(const Device& device, size_t framesInFlight)
 {
-    m_imageAvailableSemaphores.resize(maxFramesInFlight);
-    m_renderFinishedSemaphores.resize(maxFramesInFlight);
-    m_inFlightFences.resize(maxFramesInFlight);
+    m_imageAvailableSemaphores.resize(framesInFlight);
+    m_renderFinishedSemaphores.resize(framesInFlight);
+    m_frameValues.assign(framesInFlight, 0);
+    m_submittedValue = 0;
 
     VkSemaphoreCreateInfo semaphoreInfo{};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-    for (size_t i = 0; i < maxFramesInFlight; i++) {
+    for (size_t i = 0; i < framesInFlight; i++) {
         if (vkCreateSemaphore(device.get(), &semaphoreInfo, nullptr, &m_imageAvailableSemaphores[i]) != VK_SUCCESS ||
-            vkCreateSemaphore(device.get(), &semaphoreInfo, nullptr, &m_renderFinishedSemaphores[i]) != VK_SUCCESS ||
-            vkCreateFence(device.get(), &fenceInfo, nullptr, &m_inFlightFences[i]) != VK_SUCCESS) {
+            vkCreateSemaphore(device.get(), &semaphoreInfo, nullptr, &m_renderFinishedSemaphores[i]) != VK_SUCCESS) {
             throw std::runtime_error("failed to create synchronization objects for a frame!");
         }
     }
+
+    // Starts at 0, the value every slot waits for before its first submission
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+    VkSemaphoreCreateInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    timelineInfo.pNext = &typeInfo;
+    if (vkCreateSemaphore(device.get(), &timelineInfo, nullptr, &m_timeline) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create frame timeline semaphore!");
+    }
 }
 
 void SyncObjects::destroy(const Device& device)
@@ -29,6 +37,32 @@ void SyncObjects::destroy(const Device& device)
     for (size_t i = 0; i < framesInFlight; i++) {
         vkDestroySemaphore(device.get(), m_renderFinishedSemaphores[i], nullptr);
         vkDestroySemaphore(device.get(), m_imageAvailableSemaphores[i], nullptr);
-        vkDestroyFence(device.get(), m_inFlightFences[i], nullptr);
+    }
+    m_imageAvailableSemaphores.clear();
+    m_renderFinishedSemaphores.clear();
+    if (m_timeline != VK_NULL_HANDLE) {
+        vkDestroySemaphore(device.get(), m_timeline, nullptr);
+        m_timeline = VK_NULL_HANDLE;
+    }
+}
+
+uint64_t SyncObjects::completedValue(const Device& device) const
+{
+    uint64_t value = 0;
+    vkGetSemaphoreCounterValue(device.get(), m_timeline, &value);
+    return value;
+}
+
+void SyncObjects::waitForValue(const Device& device, uint64_t value) const
+{
+    if (value == 0) return;
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &m_timeline;
+    waitInfo.pValues = &value;
+    if (vkWaitSemaphores(device.get(), &waitInfo, UINT64_MAX) != VK_SUCCESS) {
+        throw std::runtime_error("failed to wait for frame timeline!");
     }
 }
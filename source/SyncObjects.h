@@ -1,19 +1,48 @@
 #pragma once
 #include <vulkan/vulkan.h>
+#include <cstdint>
 #include <vector>
 #include "Device.h"
 
+// ============================================================================
+// Frame Synchronization
+// Binary semaphores for acquire and present, and one timeline semaphore that
+// every graphics-queue submission signals with an increasing value: frames,
+// and the batches that end AsyncQueue work. A frame slot is free once the
+// timeline reaches the value its last submission signaled; other subsystems
+// can tag work with submittedValue() and wait for, or poll, that value
+// instead of idling a queue or keeping fences of their own.
+// ============================================================================
+
 class SyncObjects
 {
 	public:
-	void create(const Device& device, size_t maxFramesInFlight);
+	void create(const Device& device, size_t framesInFlight);
 	void destroy(const Device& device);
 	VkSemaphore getImageAvailableSemaphore(size_t frame) const { return m_imageAvailableSemaphores[frame]; }
 	VkSemaphore getRenderFinishedSemaphore(size_t frame) const { return m_renderFinishedSemaphores[frame]; }
-	VkFence& getInFlightFence(size_t frame) { return m_inFlightFences[frame]; }
+	VkSemaphore timeline() const { return m_timeline; }
+
+	// Block until frame slot `frame`'s previous submission has completed
+	void waitForFrame(const Device& device, size_t frame) const { waitForValue(device, m_frameValues[frame]); }
+
+	// Timeline value for the submission about to be made from slot `frame`
+	uint64_t nextFrameValue(size_t frame) { return m_frameValues[frame] = ++m_submittedValue; }
+
+	// Timeline value for a graphics-queue submission outside the frame slots
+	// (AsyncQueue handoffs); it must be submitted before the next value is taken
+	uint64_t nextSubmitValue() { return ++m_submittedValue; }
+
+	// Value of the latest frame submission; work recorded so far is done when
+	// the timeline reaches it
+	uint64_t submittedValue() const { return m_submittedValue; }
+	uint64_t completedValue(const Device& device) const;
+	void waitForValue(const Device& device, uint64_t value) const;
+
 private:
 	std::vector<VkSemaphore> m_imageAvailableSemaphores;
 	std::vector<VkSemaphore> m_renderFinishedSemaphores;
-	std::vector<VkFence> m_inFlightFences;
+	VkSemaphore m_timeline = VK_NULL_HANDLE;
+	std::vector<uint64_t> m_frameValues;    // last value signaled from each slot
+	uint64_t m_submittedValue = 0;
 };
-
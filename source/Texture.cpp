@@ -3,12 +3,17 @@
 // ============================================================================
 
 #include "Texture.h"
+#include "AsyncQueue.h"
+#include "DeletionQueue.h"
 #include "Device.h"
 #include "Utilities.h"
+#include "Buffer.h"
+#include "MipGenerator.h"
 #include <stdexcept>
 #include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <string>
 
 // ============================================================================
 // Helper Functions
@@ -73,12 +78,17 @@ void Texture::createFromPixels(const Device& device,
     VkFormat format,
     bool generateMipmapsEnabled,
     VkFilter samplerFilter,
-    VkSamplerAddressMode addressMode)
+    VkSamplerAddressMode addressMode,
+    VkComponentMapping components,
+    VkSampler sharedSampler,
+    MipGenerator* mipGenerator)
 {
     m_mipLevels = generateMipmapsEnabled
         ? (uint32_t)std::floor(std::log2(std::max(width, height))) + 1
         : 1u;
-    VkDeviceSize imageSize = static_cast<VkDeviceSize>(width) * height * 4;
+    const bool computeMipmaps = generateMipmapsEnabled && mipGenerator &&
+                                mipGenerator->supports(device, format, width, height);
+    VkDeviceSize imageSize = static_cast<VkDeviceSize>(width) * height * texelSize(format);
     VkBuffer stagingBuffer = VK_NULL_HANDLE;
     VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
     {
@@ -119,10 +129,28 @@ void Texture::createFromPixels(const Device& device,
         VK_IMAGE_TILING_OPTIMAL,
         VK_IMAGE_USAGE_TRANSFER_DST_BIT |
         VK_IMAGE_USAGE_SAMPLED_BIT |
-        (generateMipmapsEnabled ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0),
+        (computeMipmaps ? MipGenerator::kImageUsage
+                        : generateMipmapsEnabled ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0),
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        m_image, m_memory);
-    {
+        m_image, m_memory,
+        computeMipmaps ? MipGenerator::imageFlags(format) : 0);
+    VkBufferImageCopy copy{};
+    copy.bufferOffset = 0;
+    copy.bufferRowLength = 0;
+    copy.bufferImageHeight = 0;
+    copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    copy.imageSubresource.mipLevel = 0;
+    copy.imageSubresource.baseArrayLayer = 0;
+    copy.imageSubresource.layerCount = 1;
+    copy.imageOffset = { 0, 0, 0 };
+    copy.imageExtent = { width, height, 1 };
+    uint64_t generateValue = 0;
+    if (computeMipmaps) {
+        // Upload and downsample in one submission (on the async compute queue if any)
+        generateValue = mipGenerator->generate(device, commandPool, graphicsQueue, stagingBuffer, { copy },
+                                               m_image, format, width, height, m_mipLevels, 1);
+    }
+    else {
         transitionImageLayout(device, commandPool, graphicsQueue,
             m_image, format,
             VK_IMAGE_LAYOUT_UNDEFINED,
@@ -130,24 +158,142 @@ void Texture::createFromPixels(const Device& device,
             m_mipLevels,
             VK_IMAGE_ASPECT_COLOR_BIT);
         VkCommandBuffer commandBuffer = beginSingleTimeCommands(device, commandPool);
-        VkBufferImageCopy copy{};
-        copy.bufferOffset = 0;
+        vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, m_image,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
+        endSingleTimeCommands(device, commandBuffer, commandPool, graphicsQueue);
+
+        if (generateMipmapsEnabled) {
+            generateMipmaps(device, commandPool, graphicsQueue, format, (int32_t)width, (int32_t)height);
+        }
+        else {
+            transitionImageLayout(device, commandPool, graphicsQueue,
+                m_image, format,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                m_mipLevels,
+                VK_IMAGE_ASPECT_COLOR_BIT);
+        }
+    }
+    m_view = createImageView(device, m_image, format, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, components);
+    if (sharedSampler != VK_NULL_HANDLE) {
+        m_sampler = sharedSampler;
+        m_ownsSampler = false;
+    } else {
+        createSampler(device, samplerFilter, addressMode);
+    }
+    VkDevice handle = device.get();
+    auto freeStaging = [handle, stagingBuffer, stagingMemory]() {
+        vkDestroyBuffer(handle, stagingBuffer, nullptr);
+        vkFreeMemory(handle, stagingMemory, nullptr);
+    };
+    DeletionQueue* deletionQueue = computeMipmaps ? mipGenerator->deletionQueue() : nullptr;
+    if (deletionQueue) {
+        deletionQueue->push(generateValue, freeStaging);
+    } else {
+        freeStaging();
+    }
+}
+
+void Texture::createFromMipChain(const Device& device,
+    VkCommandPool commandPool,
+    VkQueue graphicsQueue,
+    const std::vector<TextureMipLevel>& levels,
+    VkFormat format,
+    VkFilter samplerFilter,
+    VkSamplerAddressMode addressMode,
+    VkComponentMapping components,
+    VkSampler sharedSampler,
+    AsyncQueue* uploadQueue)
+{
+    if (levels.empty())
+        throw std::runtime_error("Texture: empty mip chain");
+
+    m_mipLevels = static_cast<uint32_t>(levels.size());
+
+    // Pack every level into one staging buffer; offsets stay 16-byte aligned
+    // which satisfies the texel-block alignment of all BCn formats
+    std::vector<VkBufferImageCopy> copies(levels.size());
+    VkDeviceSize totalSize = 0;
+    for (size_t i = 0; i < levels.size(); ++i) {
+        totalSize = (totalSize + 15) & ~VkDeviceSize(15);
+        VkBufferImageCopy& copy = copies[i];
+        copy.bufferOffset = totalSize;
         copy.bufferRowLength = 0;
         copy.bufferImageHeight = 0;
         copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        copy.imageSubresource.mipLevel = 0;
+        copy.imageSubresource.mipLevel = static_cast<uint32_t>(i);
         copy.imageSubresource.baseArrayLayer = 0;
         copy.imageSubresource.layerCount = 1;
         copy.imageOffset = { 0, 0, 0 };
-        copy.imageExtent = { width, height, 1 };
-        vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, m_image,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
-        endSingleTimeCommands(device, commandBuffer, commandPool, graphicsQueue);
+        copy.imageExtent = { levels[i].width, levels[i].height, 1 };
+        totalSize += levels[i].data.size();
     }
-    if (generateMipmapsEnabled) {
-        generateMipmaps(device, commandPool, graphicsQueue, format, (int32_t)width, (int32_t)height);
+
+    Buffer staging;
+    staging.createAndMap(device, totalSize,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    for (size_t i = 0; i < levels.size(); ++i) {
+        staging.write(levels[i].data.data(), levels[i].data.size(), copies[i].bufferOffset);
+    }
+#ifndef NDEBUG
+    // Every level must read back at its own offset; a later level landing on
+    // an earlier one would upload the wrong bytes to every mip but the last
+    for (size_t i = 0; i < levels.size(); ++i) {
+        const char* packed = static_cast<const char*>(staging.mappedPtrRaw()) + copies[i].bufferOffset;
+        if (std::memcmp(packed, levels[i].data.data(), levels[i].data.size()) != 0) {
+            throw std::runtime_error("Mip level " + std::to_string(i) + " was not staged at its offset");
+        }
+    }
+#endif
+
+    createImage(device, levels[0].width, levels[0].height, m_mipLevels,
+        VK_SAMPLE_COUNT_1_BIT,
+        format,
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        m_image, m_memory);
+
+    uint64_t uploadValue = 0;
+    if (uploadQueue) {
+        // One submission on the upload queue; the handoff makes the image
+        // shader-readable for the graphics queue
+        VkCommandBuffer commandBuffer = uploadQueue->begin(device);
+        VkImageMemoryBarrier barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = m_image;
+        barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, m_mipLevels, 0, 1 };
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &barrier);
+        vkCmdCopyBufferToImage(commandBuffer, staging.get(), m_image,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            static_cast<uint32_t>(copies.size()), copies.data());
+
+        ImageHandoff handoff;
+        handoff.image = m_image;
+        handoff.range = barrier.subresourceRange;
+        uploadValue = uploadQueue->submit(device, commandBuffer, { handoff });
     }
     else {
+        transitionImageLayout(device, commandPool, graphicsQueue,
+            m_image, format,
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            m_mipLevels,
+            VK_IMAGE_ASPECT_COLOR_BIT);
+        {
+            VkCommandBuffer commandBuffer = beginSingleTimeCommands(device, commandPool);
+            vkCmdCopyBufferToImage(commandBuffer, staging.get(), m_image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                static_cast<uint32_t>(copies.size()), copies.data());
+            endSingleTimeCommands(device, commandBuffer, commandPool, graphicsQueue);
+        }
         transitionImageLayout(device, commandPool, graphicsQueue,
             m_image, format,
             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
@@ -155,10 +301,31 @@ void Texture::createFromPixels(const Device& device,
             m_mipLevels,
             VK_IMAGE_ASPECT_COLOR_BIT);
     }
-    m_view = createImageView(device, m_image, format, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels);
-    createSampler(device, samplerFilter, addressMode);
-    vkDestroyBuffer(device.get(), stagingBuffer, nullptr);
-    vkFreeMemory(device.get(), stagingMemory, nullptr);
+
+    m_view = createImageView(device, m_image, format, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, components);
+    if (sharedSampler != VK_NULL_HANDLE) {
+        m_sampler = sharedSampler;
+        m_ownsSampler = false;
+    } else {
+        createSampler(device, samplerFilter, addressMode);
+    }
+    if (uploadQueue) {
+        // Freed once the copy has run; this does not wait for it
+        staging.retire(device, uploadQueue->deletionQueue(), uploadValue);
+    } else {
+        staging.destroy(device);
+    }
+}
+
+uint32_t Texture::texelSize(VkFormat format)
+{
+    switch (format) {
+    case VK_FORMAT_R8_UNORM: return 1;
+    case VK_FORMAT_R8G8_UNORM: return 2;
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB: return 4;
+    default: throw std::runtime_error("Texture: unsupported format in texelSize");
+    }
 }
 
 // ============================================================================
@@ -196,61 +363,7 @@ void Texture::generateMipmaps(const Device& device,
     int32_t texHeight)
 {
     VkCommandBuffer commandBuffer = beginSingleTimeCommands(device, commandPool);
-    VkImageMemoryBarrier barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
-    barrier.image = m_image;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-    barrier.subresourceRange.levelCount = 1;
-    int32_t mipWidth = texWidth;
-    int32_t mipHeight = texHeight;
-    for (uint32_t i = 1; i < m_mipLevels; i++) {
-        barrier.subresourceRange.baseMipLevel = i - 1;
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-        vkCmdPipelineBarrier(commandBuffer,
-            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-            0, 0, nullptr, 0, nullptr, 1, &barrier);
-        VkImageBlit blit{};
-        blit.srcOffsets[0] = { 0, 0, 0 };
-        blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
-        blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        blit.srcSubresource.mipLevel = i - 1;
-        blit.srcSubresource.baseArrayLayer = 0;
-        blit.srcSubresource.layerCount = 1;
-        int32_t nextWidth = std::max(mipWidth / 2, 1);
-        int32_t nextHeight = std::max(mipHeight / 2, 1);
-        blit.dstOffsets[0] = { 0, 0, 0 };
-        blit.dstOffsets[1] = { nextWidth, nextHeight, 1 };
-        blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        blit.dstSubresource.mipLevel = i;
-        blit.dstSubresource.baseArrayLayer = 0;
-        blit.dstSubresource.layerCount = 1;
-        vkCmdBlitImage(commandBuffer, m_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-            m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            1, &blit, VK_FILTER_LINEAR);
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        vkCmdPipelineBarrier(commandBuffer,
-            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-            0, 0, nullptr, 0, nullptr, 1, &barrier);
-        mipWidth = nextWidth;
-        mipHeight = nextHeight;
-    }
-    barrier.subresourceRange.baseMipLevel = m_mipLevels - 1;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    vkCmdPipelineBarrier(commandBuffer,
-        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-        0, 0, nullptr, 0, nullptr, 1, &barrier);
+    recordBlitMipChain(commandBuffer, m_image, (uint32_t)texWidth, (uint32_t)texHeight, m_mipLevels, 1);
     endSingleTimeCommands(device, commandBuffer, commandPool, graphicsQueue);
 }
 
@@ -260,9 +373,32 @@ void Texture::generateMipmaps(const Device& device,
 
 void Texture::destroy(const Device& device)
 {
-    if (m_sampler) { vkDestroySampler(device.get(), m_sampler, nullptr); m_sampler = VK_NULL_HANDLE; }
+    if (m_sampler && m_ownsSampler) vkDestroySampler(device.get(), m_sampler, nullptr);
+    m_sampler = VK_NULL_HANDLE;
+    m_ownsSampler = true;
     if (m_view) { vkDestroyImageView(device.get(), m_view, nullptr);  m_view = VK_NULL_HANDLE; }
     if (m_image) { vkDestroyImage(device.get(), m_image, nullptr);     m_image = VK_NULL_HANDLE; }
     if (m_memory) { vkFreeMemory(device.get(), m_memory, nullptr);      m_memory = VK_NULL_HANDLE; }
     m_mipLevels = 1;
 }
+
+void Texture::retire(const Device& device, DeletionQueue& deletionQueue, uint64_t value)
+{
+    VkDevice handle = device.get();
+    VkSampler sampler = m_ownsSampler ? m_sampler : VK_NULL_HANDLE;
+    VkImageView view = m_view;
+    VkImage image = m_image;
+    VkDeviceMemory memory = m_memory;
+    deletionQueue.push(value, [handle, sampler, view, image, memory]() {
+        if (sampler) vkDestroySampler(handle, sampler, nullptr);
+        if (view) vkDestroyImageView(handle, view, nullptr);
+        if (image) vkDestroyImage(handle, image, nullptr);
+        if (memory) vkFreeMemory(handle, memory, nullptr);
+    });
+    m_sampler = VK_NULL_HANDLE;
+    m_ownsSampler = true;
+    m_view = VK_NULL_HANDLE;
+    m_image = VK_NULL_HANDLE;
+    m_memory = VK_NULL_HANDLE;
+    m_mipLevels = 1;
+}
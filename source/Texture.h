@@ -1,15 +1,31 @@
 ﻿#pragma once
 #include <vulkan/vulkan.h>
 #include <cstdint>
+#include <vector>
 
+class AsyncQueue;
+class DeletionQueue;
 class Device;
+class MipGenerator;
+
+// One pre-built mip level (tightly packed texels or compressed blocks)
+struct TextureMipLevel {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> data;
+};
 
 class Texture {
 public:
     Texture() = default;
     virtual ~Texture() = default;
 
-    // Create a 2D texture from pixel data (RGBA8 example), optionally generate mipmaps
+    // Create a 2D texture from pixel data (R8, RG8 or RGBA8), optionally generate mipmaps.
+    // `components` swizzles the view so narrow formats can be read like RGBA.
+    // A `sharedSampler` (e.g. from SamplerCache) is used instead of creating a
+    // sampler from `samplerFilter`/`addressMode`, and is not destroyed with the texture.
+    // Mipmaps come from `mipGenerator` in one compute dispatch when it supports
+    // the format and size, and from per-level blits otherwise.
     void createFromPixels(const Device& device,
         VkCommandPool commandPool,
         VkQueue graphicsQueue,
@@ -19,9 +35,32 @@ public:
         VkFormat format = VK_FORMAT_R8G8B8A8_SRGB,
         bool generateMipmaps = true,
         VkFilter samplerFilter = VK_FILTER_LINEAR,
-        VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT);
+        VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        VkComponentMapping components = {},
+        VkSampler sharedSampler = VK_NULL_HANDLE,
+        MipGenerator* mipGenerator = nullptr);
+
+    // Create a 2D texture from a complete, CPU-built mip chain (any format,
+    // including block-compressed). All levels are uploaded in one staging copy,
+    // on `uploadQueue` (e.g. the transfer queue) when one is given.
+    void createFromMipChain(const Device& device,
+        VkCommandPool commandPool,
+        VkQueue graphicsQueue,
+        const std::vector<TextureMipLevel>& levels,
+        VkFormat format,
+        VkFilter samplerFilter = VK_FILTER_LINEAR,
+        VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        VkComponentMapping components = {},
+        VkSampler sharedSampler = VK_NULL_HANDLE,
+        AsyncQueue* uploadQueue = nullptr);
+
+    // Bytes per texel for the uncompressed formats createFromPixels accepts
+    static uint32_t texelSize(VkFormat format);
 
     virtual void destroy(const Device& device);
+    // destroy() once the frame timeline reaches `value`, for textures that
+    // frames in flight may still sample; this object is empty afterwards
+    void retire(const Device& device, DeletionQueue& deletionQueue, uint64_t value);
 
     uint32_t mipLevels() const { return m_mipLevels; }
     VkImage image() const { return m_image; }
@@ -46,6 +85,7 @@ protected:
     VkDeviceMemory m_memory = VK_NULL_HANDLE;
     VkImageView m_view = VK_NULL_HANDLE;
     VkSampler m_sampler = VK_NULL_HANDLE;
+    bool m_ownsSampler = true;
 };
 
 
@@ -0,0 +1,160 @@
+// ============================================================================
+// TextureBudget.cpp - Quality presets and budget-driven mip dropping
+// ============================================================================
+
+#include "TextureBudget.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+// ============================================================================
+// Presets
+// ============================================================================
+
+namespace {
+
+constexpr uint64_t kMiB = 1024ull * 1024ull;
+
+// Textures are never reduced below this top-mip size by the budget pass
+constexpr uint32_t kMinDimension = 64;
+
+const TextureQualityPreset kPresets[] = {
+    { "low",    512,  64 * kMiB  },
+    { "medium", 1024, 256 * kMiB },
+    { "high",   2048, 768 * kMiB },
+    { "ultra",  0,    0          },
+};
+
+uint32_t levelDimension(uint32_t size, uint32_t dropped) {
+    return std::max(size >> dropped, 1u);
+}
+
+bool canDrop(const TextureBudgetEntry& entry) {
+    uint32_t top = std::max(levelDimension(entry.width, entry.droppedMips),
+                            levelDimension(entry.height, entry.droppedMips));
+    return top / 2 >= kMinDimension;
+}
+
+uint64_t residentBytes(const TextureBudgetEntry& entry) {
+    return textureChainBytes(entry.format,
+                             levelDimension(entry.width, entry.droppedMips),
+                             levelDimension(entry.height, entry.droppedMips));
+}
+
+} // namespace
+
+uint32_t textureUsageImportance(TextureUsageFlags usage) {
+    if (usage & TEXTURE_USAGE_BASE_COLOR) return 4;
+    if (usage & TEXTURE_USAGE_NORMAL) return 3;
+    if (usage & (TEXTURE_USAGE_EMISSIVE | TEXTURE_USAGE_METALLIC_ROUGHNESS)) return 2;
+    return 1;
+}
+
+const TextureQualityPreset& textureQualityPreset(TextureQuality quality) {
+    return kPresets[static_cast<int>(quality)];
+}
+
+bool parseTextureQuality(const std::string& name, TextureQuality& outQuality) {
+    for (int i = 0; i < 4; ++i) {
+        if (name == kPresets[i].name) {
+            outQuality = static_cast<TextureQuality>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// Planning
+// ============================================================================
+
+TextureBudget::TextureBudget(const TextureBudgetSettings& settings)
+    : m_preset(textureQualityPreset(settings.quality)),
+      m_budgetBytes(settings.budgetBytes != 0 ? settings.budgetBytes : m_preset.defaultBudgetBytes) {
+}
+
+void TextureBudget::plan(std::vector<TextureBudgetEntry>& entries) const {
+    uint64_t total = 0;
+    for (auto& entry : entries) {
+        entry.droppedMips = 0;
+        entry.fullBytes = textureChainBytes(entry.format, entry.width, entry.height);
+
+        // Preset resolution cap
+        if (m_preset.maxDimension != 0) {
+            while (std::max(levelDimension(entry.width, entry.droppedMips),
+                            levelDimension(entry.height, entry.droppedMips)) > m_preset.maxDimension &&
+                   canDrop(entry)) {
+                entry.droppedMips++;
+            }
+        }
+        entry.residentBytes = residentBytes(entry);
+        total += entry.residentBytes;
+    }
+
+    if (m_budgetBytes == 0) {
+        return;
+    }
+
+    // Drop one mip at a time from the entry with the most bytes per unit of
+    // importance until the set fits (or nothing can shrink further)
+    while (total > m_budgetBytes) {
+        TextureBudgetEntry* victim = nullptr;
+        uint64_t victimScore = 0;
+        for (auto& entry : entries) {
+            if (!canDrop(entry)) continue;
+            uint64_t score = entry.residentBytes / textureUsageImportance(entry.usage);
+            if (!victim || score > victimScore) {
+                victim = &entry;
+                victimScore = score;
+            }
+        }
+        if (!victim) {
+            std::cerr << "Warning: texture budget of " << m_budgetBytes / kMiB
+                      << " MB cannot be met at minimum resolution" << std::endl;
+            break;
+        }
+        total -= victim->residentBytes;
+        victim->droppedMips++;
+        victim->residentBytes = residentBytes(*victim);
+        total += victim->residentBytes;
+    }
+}
+
+// ============================================================================
+// Report
+// ============================================================================
+
+void TextureBudget::printReport(const std::vector<TextureBudgetEntry>& entries) const {
+    uint64_t fullTotal = 0;
+    uint64_t residentTotal = 0;
+    uint32_t reduced = 0;
+
+    std::cout << "Texture memory report (quality: " << m_preset.name << ", budget: ";
+    if (m_budgetBytes == 0) std::cout << "unlimited";
+    else std::cout << m_budgetBytes / kMiB << " MB";
+    std::cout << ")" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& entry : entries) {
+        fullTotal += entry.fullBytes;
+        residentTotal += entry.residentBytes;
+        if (entry.droppedMips > 0) reduced++;
+
+        std::cout << "  " << std::left << std::setw(32) << entry.name << std::right
+                  << std::setw(5) << entry.width << "x" << std::setw(5) << std::left << entry.height << std::right
+                  << " -> " << std::setw(5) << levelDimension(entry.width, entry.droppedMips)
+                  << "x" << std::setw(5) << std::left << levelDimension(entry.height, entry.droppedMips) << std::right
+                  << " " << std::setw(13) << std::left << textureFormatName(entry.format) << std::right
+                  << std::setw(9) << static_cast<double>(entry.residentBytes) / kMiB << " MB";
+        if (entry.droppedMips > 0) {
+            std::cout << "  (-" << entry.droppedMips << " mip" << (entry.droppedMips > 1 ? "s" : "") << ")";
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << "  Total: " << static_cast<double>(residentTotal) / kMiB << " MB resident, "
+              << static_cast<double>(fullTotal - residentTotal) / kMiB << " MB saved ("
+              << reduced << "/" << entries.size() << " textures reduced)" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "TextureCooker.h"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Texture Budget
+// Caps the VRAM spent on model textures. Each quality preset limits the top
+// mip dimension and sets a default budget; if the textures still do not fit,
+// whole top mips are dropped from the least important, largest textures first.
+// ============================================================================
+
+enum class TextureQuality {
+    Low,
+    Medium,
+    High,
+    Ultra
+};
+
+struct TextureQualityPreset {
+    const char* name;
+    uint32_t maxDimension;        // top mip is reduced until it fits (0 = no cap)
+    uint64_t defaultBudgetBytes;  // 0 = unlimited
+};
+
+const TextureQualityPreset& textureQualityPreset(TextureQuality quality);
+bool parseTextureQuality(const std::string& name, TextureQuality& outQuality);
+
+// Higher = keep resolution longer (and stream earlier). Color is most visible, occlusion least.
+uint32_t textureUsageImportance(TextureUsageFlags usage);
+
+struct TextureBudgetSettings {
+    TextureQuality quality = TextureQuality::High;
+    uint64_t budgetBytes = 0;     // overrides the preset default when non-zero
+};
+
+// One texture as seen by the planner
+struct TextureBudgetEntry {
+    std::string name;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+    TextureUsageFlags usage = 0;
+
+    // Filled by TextureBudget::plan()
+    uint32_t droppedMips = 0;
+    uint64_t fullBytes = 0;       // full-resolution mip chain
+    uint64_t residentBytes = 0;   // mip chain after dropping
+};
+
+class TextureBudget {
+public:
+    explicit TextureBudget(const TextureBudgetSettings& settings);
+
+    // Choose droppedMips for every entry so the sum of residentBytes fits the budget
+    void plan(std::vector<TextureBudgetEntry>& entries) const;
+
+    // Per-texture resolution/format table plus totals and bytes saved
+    void printReport(const std::vector<TextureBudgetEntry>& entries) const;
+
+    uint64_t budgetBytes() const { return m_budgetBytes; }
+
+private:
+    TextureQualityPreset m_preset;
+    uint64_t m_budgetBytes = 0;
+};
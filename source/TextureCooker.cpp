@@ -0,0 +1,454 @@
+// ============================================================================
+// TextureCooker.cpp - Usage-aware texture format selection, CPU mip chains,
+// BCn encoding and the on-disk cook cache
+// ============================================================================
+
+#include "TextureCooker.h"
+#include "BlockCompression.h"
+#include "Device.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+// ============================================================================
+// Helper Functions
+// ============================================================================
+
+namespace {
+
+// Bump whenever encoder output or the file layout changes
+constexpr uint32_t kCookVersion = 1;
+constexpr char kCacheMagic[4] = { 'K', 'T', 'C', '1' };
+
+struct CacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+};
+
+uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool isBlockCompressed(VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bc::Format toBlockFormat(VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:  return bc::Format::BC1;
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:      return bc::Format::BC3;
+        case VK_FORMAT_BC4_UNORM_BLOCK:     return bc::Format::BC4;
+        default:                            return bc::Format::BC5;
+    }
+}
+
+bool isSrgb(VkFormat format) {
+    return format == VK_FORMAT_R8G8B8A8_SRGB ||
+           format == VK_FORMAT_BC1_RGB_SRGB_BLOCK ||
+           format == VK_FORMAT_BC3_SRGB_BLOCK;
+}
+
+uint32_t mipCount(uint32_t width, uint32_t height) {
+    return static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+}
+
+// 2x2 box filter; odd dimensions clamp the second tap to the last row/column.
+// Color channels of sRGB images are averaged in linear space.
+std::vector<uint8_t> downsample(const std::vector<uint8_t>& src, uint32_t width, uint32_t height, bool srgb) {
+    static const auto toLinear = [] {
+        std::vector<float> table(256);
+        for (int i = 0; i < 256; ++i) {
+            float c = i / 255.0f;
+            table[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return table;
+    }();
+    auto toSrgb = [](float l) {
+        float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+        return static_cast<uint8_t>(std::clamp(c * 255.0f + 0.5f, 0.0f, 255.0f));
+    };
+
+    uint32_t dstWidth = std::max(width / 2, 1u);
+    uint32_t dstHeight = std::max(height / 2, 1u);
+    std::vector<uint8_t> dst(static_cast<size_t>(dstWidth) * dstHeight * 4);
+
+    for (uint32_t y = 0; y < dstHeight; ++y) {
+        uint32_t y0 = std::min(y * 2, height - 1);
+        uint32_t y1 = std::min(y * 2 + 1, height - 1);
+        for (uint32_t x = 0; x < dstWidth; ++x) {
+            uint32_t x0 = std::min(x * 2, width - 1);
+            uint32_t x1 = std::min(x * 2 + 1, width - 1);
+            const uint8_t* taps[4] = {
+                &src[(static_cast<size_t>(y0) * width + x0) * 4],
+                &src[(static_cast<size_t>(y0) * width + x1) * 4],
+                &src[(static_cast<size_t>(y1) * width + x0) * 4],
+                &src[(static_cast<size_t>(y1) * width + x1) * 4],
+            };
+            uint8_t* out = &dst[(static_cast<size_t>(y) * dstWidth + x) * 4];
+            for (int c = 0; c < 4; ++c) {
+                if (srgb && c < 3) {
+                    float sum = toLinear[taps[0][c]] + toLinear[taps[1][c]] + toLinear[taps[2][c]] + toLinear[taps[3][c]];
+                    out[c] = toSrgb(sum * 0.25f);
+                } else {
+                    uint32_t sum = taps[0][c] + taps[1][c] + taps[2][c] + taps[3][c];
+                    out[c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+    }
+    return dst;
+}
+
+// Keep only the channels an uncompressed format stores, starting at `firstChannel`
+TextureMipLevel storeLevel(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height,
+                           VkFormat format, size_t firstChannel) {
+    TextureMipLevel out;
+    out.width = width;
+    out.height = height;
+    size_t pixelCount = static_cast<size_t>(width) * height;
+    uint32_t channels = Texture::texelSize(format);
+    if (channels == 4) {
+        out.data = rgba;
+        return out;
+    }
+    out.data.resize(pixelCount * channels);
+    for (size_t i = 0; i < pixelCount; ++i) {
+        for (uint32_t c = 0; c < channels; ++c) {
+            out.data[i * channels + c] = rgba[i * 4 + firstChannel + c];
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+const char* textureFormatName(VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_R8G8B8A8_SRGB:       return "RGBA8 SRGB";
+        case VK_FORMAT_R8G8B8A8_UNORM:      return "RGBA8 LINEAR";
+        case VK_FORMAT_R8G8_UNORM:          return "RG8";
+        case VK_FORMAT_R8_UNORM:            return "R8";
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:  return "BC1 SRGB";
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK: return "BC1 LINEAR";
+        case VK_FORMAT_BC3_SRGB_BLOCK:      return "BC3 SRGB";
+        case VK_FORMAT_BC3_UNORM_BLOCK:     return "BC3 LINEAR";
+        case VK_FORMAT_BC4_UNORM_BLOCK:     return "BC4";
+        case VK_FORMAT_BC5_UNORM_BLOCK:     return "BC5";
+        default:                            return "other";
+    }
+}
+
+uint64_t textureChainBytes(VkFormat format, uint32_t width, uint32_t height) {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < mipCount(width, height); ++i) {
+        uint32_t w = std::max(width >> i, 1u);
+        uint32_t h = std::max(height >> i, 1u);
+        total += isBlockCompressed(format)
+            ? bc::compressedSize(toBlockFormat(format), w, h)
+            : static_cast<uint64_t>(w) * h * Texture::texelSize(format);
+    }
+    return total;
+}
+
+// ============================================================================
+// Initialization
+// ============================================================================
+
+void TextureCooker::init(const Device& device, const TextureCookOptions& options) {
+    m_options = options;
+    m_physicalDevice = device.physical();
+    m_bcEnabled = options.allowBlockCompression && device.features().textureCompressionBC == VK_TRUE;
+    m_stats = {};
+}
+
+bool TextureCooker::isSampleable(VkFormat format) const {
+    if (isBlockCompressed(format) && !m_bcEnabled) {
+        return false;
+    }
+    VkFormatProperties props{};
+    vkGetPhysicalDeviceFormatProperties(m_physicalDevice, format, &props);
+    VkFormatFeatureFlags required = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+                                    VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    return (props.optimalTilingFeatures & required) == required;
+}
+
+// ============================================================================
+// Format Selection
+// ============================================================================
+
+VkFormat TextureCooker::chooseFormat(TextureUsageFlags usage, bool hasAlpha) const {
+    const TextureUsageFlags colorUsage = TEXTURE_USAGE_BASE_COLOR | TEXTURE_USAGE_EMISSIVE;
+    const TextureUsageFlags ormUsage = TEXTURE_USAGE_METALLIC_ROUGHNESS | TEXTURE_USAGE_OCCLUSION;
+
+    // Uncompressed fallback keeps only the channels the shader reads:
+    // occlusion -> R8, normal XY -> RG8, metallic-roughness GB -> RG8
+    VkFormat fallback = (usage & colorUsage) ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    if (usage == TEXTURE_USAGE_OCCLUSION && isSampleable(VK_FORMAT_R8_UNORM)) {
+        fallback = VK_FORMAT_R8_UNORM;
+    } else if ((usage == TEXTURE_USAGE_NORMAL || usage == TEXTURE_USAGE_METALLIC_ROUGHNESS) &&
+               isSampleable(VK_FORMAT_R8G8_UNORM)) {
+        fallback = VK_FORMAT_R8G8_UNORM;
+    }
+
+    // A texture shared between color and data slots keeps full RGBA8 so
+    // neither use loses channels or gets the wrong transfer function
+    VkFormat preferred = fallback;
+    if (usage != 0 && (usage & ~colorUsage) == 0) {
+        preferred = hasAlpha ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+    } else if (usage == TEXTURE_USAGE_NORMAL) {
+        preferred = VK_FORMAT_BC5_UNORM_BLOCK;
+    } else if (usage == TEXTURE_USAGE_OCCLUSION) {
+        preferred = VK_FORMAT_BC4_UNORM_BLOCK;
+    } else if (usage != 0 && (usage & ~ormUsage) == 0) {
+        preferred = VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+    }
+
+    if (preferred != fallback && isSampleable(preferred)) {
+        return preferred;
+    }
+    return fallback;
+}
+
+// ============================================================================
+// Cooking
+// ============================================================================
+
+VkFormat TextureCooker::predictFormat(const uint8_t* rgba, uint32_t width, uint32_t height,
+                                      TextureUsageFlags usage) const {
+    bool hasAlpha = false;
+    if (usage & TEXTURE_USAGE_BASE_COLOR) {
+        size_t pixelBytes = static_cast<size_t>(width) * height * 4;
+        for (size_t i = 3; i < pixelBytes; i += 4) {
+            if (rgba[i] != 255) { hasAlpha = true; break; }
+        }
+    }
+    return chooseFormat(usage, hasAlpha);
+}
+
+CookedTexture TextureCooker::cook(const uint8_t* sourceRgba,
+                                  uint32_t sourceWidth,
+                                  uint32_t sourceHeight,
+                                  TextureUsageFlags usage,
+                                  uint32_t skipMips) {
+    CookedTexture cooked;
+    cooked.format = predictFormat(sourceRgba, sourceWidth, sourceHeight, usage);
+    m_stats.texturesCooked++;
+    m_stats.sourceBytes += textureChainBytes(VK_FORMAT_R8G8B8A8_UNORM, sourceWidth, sourceHeight);
+
+    // Budget-dropped top mips are filtered away here, before encode/upload
+    const uint8_t* rgba = sourceRgba;
+    uint32_t width = sourceWidth;
+    uint32_t height = sourceHeight;
+    std::vector<uint8_t> reduced;
+    skipMips = std::min(skipMips, mipCount(sourceWidth, sourceHeight) - 1);
+    if (skipMips > 0) {
+        reduced.assign(sourceRgba, sourceRgba + static_cast<size_t>(width) * height * 4);
+        for (uint32_t i = 0; i < skipMips; ++i) {
+            reduced = downsample(reduced, width, height, isSrgb(cooked.format));
+            width = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+        }
+        rgba = reduced.data();
+    }
+    size_t pixelBytes = static_cast<size_t>(width) * height * 4;
+
+    // Uncompressed path: upload level 0 and let the GPU blit the chain,
+    // unless the caller needs every level on the CPU
+    if (!isBlockCompressed(cooked.format)) {
+        // Metallic-roughness lives in G/B; RG8 stores it in R/G and the view
+        // is swizzled back so the shader keeps sampling .gb
+        size_t firstChannel = 0;
+        if (cooked.format == VK_FORMAT_R8G8_UNORM && usage == TEXTURE_USAGE_METALLIC_ROUGHNESS) {
+            firstChannel = 1;
+            cooked.components = { VK_COMPONENT_SWIZZLE_ONE, VK_COMPONENT_SWIZZLE_R,
+                                  VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_ONE };
+        }
+
+        uint32_t levelCount = m_options.cpuMipChain ? mipCount(width, height) : 1;
+        std::vector<uint8_t> level(rgba, rgba + pixelBytes);
+        uint32_t levelWidth = width;
+        uint32_t levelHeight = height;
+        for (uint32_t i = 0; i < levelCount; ++i) {
+            cooked.levels.push_back(storeLevel(level, levelWidth, levelHeight, cooked.format, firstChannel));
+            if (i + 1 < levelCount) {
+                level = downsample(level, levelWidth, levelHeight, isSrgb(cooked.format));
+                levelWidth = std::max(levelWidth / 2, 1u);
+                levelHeight = std::max(levelHeight / 2, 1u);
+            }
+        }
+        cooked.generateMipmapsOnGpu = !m_options.cpuMipChain;
+        m_stats.cookedBytes += textureChainBytes(cooked.format, width, height);
+        return cooked;
+    }
+
+    m_stats.compressed++;
+
+    std::string cachePath;
+    if (m_options.useDiskCache) {
+        uint64_t key = fnv1a(rgba, pixelBytes);
+        uint32_t params[4] = { width, height, static_cast<uint32_t>(cooked.format), kCookVersion };
+        key = fnv1a(params, sizeof(params), key);
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.ktc", static_cast<unsigned long long>(key));
+        cachePath = m_options.cacheDirectory + "/" + name;
+
+        if (loadFromCache(cachePath, cooked.format, width, height, cooked)) {
+            m_stats.cacheHits++;
+            for (const auto& level : cooked.levels) m_stats.cookedBytes += level.data.size();
+            return cooked;
+        }
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    bc::Format blockFormat = toBlockFormat(cooked.format);
+    bool srgb = isSrgb(cooked.format);
+    uint32_t levelCount = mipCount(width, height);
+    cooked.levels.resize(levelCount);
+
+    std::vector<uint8_t> level(rgba, rgba + pixelBytes);
+    uint32_t levelWidth = width;
+    uint32_t levelHeight = height;
+    for (uint32_t i = 0; i < levelCount; ++i) {
+        TextureMipLevel& out = cooked.levels[i];
+        out.width = levelWidth;
+        out.height = levelHeight;
+        out.data.resize(bc::compressedSize(blockFormat, levelWidth, levelHeight));
+        bc::compressImage(blockFormat, level.data(), levelWidth, levelHeight, out.data.data(), m_encodeThreads);
+        m_stats.cookedBytes += out.data.size();
+
+        if (i + 1 < levelCount) {
+            level = downsample(level, levelWidth, levelHeight, srgb);
+            levelWidth = std::max(levelWidth / 2, 1u);
+            levelHeight = std::max(levelHeight / 2, 1u);
+        }
+    }
+
+    m_stats.encodeMs += std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+
+    if (!cachePath.empty()) {
+        saveToCache(cachePath, cooked);
+    }
+    return cooked;
+}
+
+// ============================================================================
+// Disk Cache
+// ============================================================================
+
+bool TextureCooker::loadFromCache(const std::string& path, VkFormat format, uint32_t width, uint32_t height,
+                                  CookedTexture& out) const {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    CacheHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file ||
+        std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+        header.version != kCookVersion ||
+        header.format != static_cast<uint32_t>(format) ||
+        header.width != width || header.height != height ||
+        header.levelCount != mipCount(width, height)) {
+        return false;
+    }
+
+    bc::Format blockFormat = toBlockFormat(format);
+    std::vector<TextureMipLevel> levels(header.levelCount);
+    for (auto& level : levels) {
+        uint32_t dims[2] = {};
+        file.read(reinterpret_cast<char*>(dims), sizeof(dims));
+        if (!file) return false;
+        level.width = dims[0];
+        level.height = dims[1];
+        level.data.resize(bc::compressedSize(blockFormat, level.width, level.height));
+        file.read(reinterpret_cast<char*>(level.data.data()), static_cast<std::streamsize>(level.data.size()));
+        if (!file) return false;
+    }
+
+    out.levels = std::move(levels);
+    return true;
+}
+
+void TextureCooker::saveToCache(const std::string& path, const CookedTexture& cooked) const {
+    std::error_code ec;
+    std::filesystem::create_directories(m_options.cacheDirectory, ec);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Warning: could not write texture cache " << path << std::endl;
+        return;
+    }
+
+    CacheHeader header{};
+    std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+    header.version = kCookVersion;
+    header.format = static_cast<uint32_t>(cooked.format);
+    header.width = cooked.levels[0].width;
+    header.height = cooked.levels[0].height;
+    header.levelCount = static_cast<uint32_t>(cooked.levels.size());
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const auto& level : cooked.levels) {
+        uint32_t dims[2] = { level.width, level.height };
+        file.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+        file.write(reinterpret_cast<const char*>(level.data.data()), static_cast<std::streamsize>(level.data.size()));
+    }
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+TextureCooker TextureCooker::fork() const {
+    TextureCooker copy = *this;
+    copy.m_encodeThreads = 1;
+    copy.m_stats = {};
+    return copy;
+}
+
+void TextureCooker::mergeStats(const TextureCooker& other) {
+    m_stats.texturesCooked += other.m_stats.texturesCooked;
+    m_stats.compressed += other.m_stats.compressed;
+    m_stats.cacheHits += other.m_stats.cacheHits;
+    m_stats.sourceBytes += other.m_stats.sourceBytes;
+    m_stats.cookedBytes += other.m_stats.cookedBytes;
+    m_stats.encodeMs += other.m_stats.encodeMs;
+}
+
+void TextureCooker::printStats() const {
+    const double mb = 1.0 / (1024.0 * 1024.0);
+    std::cout << "Texture cook: " << m_stats.texturesCooked << " textures, "
+              << m_stats.compressed << " block-compressed ("
+              << m_stats.cacheHits << " from cache), "
+              << m_stats.sourceBytes * mb << " MB -> " << m_stats.cookedBytes * mb << " MB, "
+              << "encode " << m_stats.encodeMs << " ms" << std::endl;
+}
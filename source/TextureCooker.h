@@ -0,0 +1,95 @@
+#pragma once
+#include "Texture.h"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Device;
+
+// ============================================================================
+// Texture Cooker
+// Turns decoded RGBA8 images into GPU-ready mip chains. The target format is
+// picked from how materials use the texture and from what the physical device
+// can sample; block-compressed results are cached on disk so later runs skip
+// the encode.
+// ============================================================================
+
+// How materials reference a texture (a texture may have several uses)
+enum TextureUsageBits : uint32_t {
+    TEXTURE_USAGE_BASE_COLOR         = 1u << 0,
+    TEXTURE_USAGE_EMISSIVE           = 1u << 1,
+    TEXTURE_USAGE_NORMAL             = 1u << 2,
+    TEXTURE_USAGE_METALLIC_ROUGHNESS = 1u << 3,
+    TEXTURE_USAGE_OCCLUSION          = 1u << 4,
+};
+using TextureUsageFlags = uint32_t;
+
+struct TextureCookOptions {
+    bool allowBlockCompression = true;
+    bool useDiskCache = true;
+    std::string cacheDirectory = "cache/textures";
+    bool cpuMipChain = false;      // build uncompressed chains on the CPU instead of blitting on the GPU
+};
+
+struct CookedTexture {
+    VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+    std::vector<TextureMipLevel> levels;
+    VkComponentMapping components{};    // view swizzle for channel-reduced formats
+    bool generateMipmapsOnGpu = false;  // true: levels holds only level 0 (uncompressed, no cpuMipChain)
+};
+
+// Short human-readable name for the formats the cooker produces (for logs)
+const char* textureFormatName(VkFormat format);
+
+// GPU bytes of a full mip chain (down to 1x1) for any format the cooker produces
+uint64_t textureChainBytes(VkFormat format, uint32_t width, uint32_t height);
+
+class TextureCooker {
+public:
+    void init(const Device& device, const TextureCookOptions& options = {});
+
+    // Cook one image. `rgba` is tightly packed RGBA8. The top `skipMips`
+    // levels are filtered away on the CPU and never reach the GPU.
+    CookedTexture cook(const uint8_t* rgba,
+                       uint32_t width,
+                       uint32_t height,
+                       TextureUsageFlags usage,
+                       uint32_t skipMips = 0);
+
+    // Format that cook() would pick for this usage (alpha = image has non-opaque texels)
+    VkFormat chooseFormat(TextureUsageFlags usage, bool hasAlpha) const;
+
+    // Format that cook() will pick for this image
+    VkFormat predictFormat(const uint8_t* rgba, uint32_t width, uint32_t height, TextureUsageFlags usage) const;
+
+    bool isSampleable(VkFormat format) const;
+
+    // Copy for cooking on a job thread: empty statistics, and block
+    // compression stays on that thread instead of spreading over the cores
+    // the other jobs are using. Fold its statistics back with mergeStats().
+    TextureCooker fork() const;
+    void mergeStats(const TextureCooker& other);
+
+    void printStats() const;
+
+private:
+    struct Stats {
+        uint32_t texturesCooked = 0;
+        uint32_t compressed = 0;
+        uint32_t cacheHits = 0;
+        uint64_t sourceBytes = 0;   // RGBA8 with full mip chain
+        uint64_t cookedBytes = 0;
+        double encodeMs = 0.0;
+    };
+
+    bool loadFromCache(const std::string& path, VkFormat format, uint32_t width, uint32_t height,
+                       CookedTexture& out) const;
+    void saveToCache(const std::string& path, const CookedTexture& cooked) const;
+
+    TextureCookOptions m_options;
+    VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
+    bool m_bcEnabled = false;
+    uint32_t m_encodeThreads = 0;   // bc::compressImage threads (0 = hardware concurrency)
+    Stats m_stats;
+};
@@ -0,0 +1,57 @@
+// ============================================================================
+// TextureFeedback.cpp - Per-frame mip request buffers written by gltf.frag
+// ============================================================================
+
+#include "TextureFeedback.h"
+#include "Device.h"
+#include <algorithm>
+#include <cstring>
+
+void TextureFeedback::create(const Device& device, uint32_t framesInFlight, uint32_t textureCount) {
+    m_textureCount = std::max(textureCount, 1u);
+    m_sampleCell = 0;
+    m_buffers.resize(framesInFlight);
+
+    VkDeviceSize size = sizeof(uint32_t) * (1 + m_textureCount);
+    for (uint32_t i = 0; i < framesInFlight; ++i) {
+        m_buffers[i].createAndMap(device, size,
+                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        reset(i);
+    }
+}
+
+void TextureFeedback::destroy(const Device& device) {
+    for (auto& buffer : m_buffers) {
+        buffer.destroy(device);
+    }
+    m_buffers.clear();
+    m_textureCount = 0;
+}
+
+void TextureFeedback::collect(uint32_t frame, std::vector<uint32_t>& outMinMips) {
+    const uint32_t* words = static_cast<const uint32_t*>(m_buffers[frame].mappedPtrRaw());
+    outMinMips.assign(words + 1, words + 1 + m_textureCount);
+
+    // Rotate through the 64 cells of an 8x8 tile so every pixel reports
+    // once every 64 frames (7 is coprime with 64, so all cells are visited)
+    m_sampleCell = (m_sampleCell + 7) & 63u;
+    reset(frame);
+}
+
+void TextureFeedback::reset(uint32_t frame) {
+    uint32_t* words = static_cast<uint32_t*>(m_buffers[frame].mappedPtrRaw());
+    words[0] = m_sampleCell;
+    std::fill(words + 1, words + 1 + m_textureCount, kNotSampled);
+}
+
+void TextureFeedback::recordHostBarrier(VkCommandBuffer cmd) {
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(cmd,
+                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                         VK_PIPELINE_STAGE_HOST_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "Buffer.h"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+class Device;
+
+// ============================================================================
+// Texture Feedback
+// One small host-visible storage buffer per frame in flight. gltf.frag writes
+// the finest mip it asked for per bindless heap slot (textureQueryLod + atomicMin);
+// the CPU reads a frame's buffer after that frame's timeline wait, so the
+// readback never stalls the GPU.
+//
+// Layout (uint32 words): [0] = sample cell for this frame, [1 + i] =
+// floor(LOD) + kLodBias for heap slot i, in the bound image's own level space
+// (kNotSampled if untouched). The bias keeps magnification (negative LOD),
+// which is what tells a shrunken texture it needs finer mips.
+// ============================================================================
+
+class TextureFeedback {
+public:
+    static constexpr uint32_t kNotSampled = 0xFFFFFFFFu;
+    static constexpr int kLodBias = 16;   // must match FEEDBACK_LOD_BIAS in gltf.frag
+
+    void create(const Device& device, uint32_t framesInFlight, uint32_t textureCount);
+    void destroy(const Device& device);
+
+    // Copy out frame `frame`'s results, then clear it for the next use and
+    // pick the next 8x8 sample cell. Only call after that frame's timeline wait.
+    void collect(uint32_t frame, std::vector<uint32_t>& outMinMips);
+
+    // Make the fragment shader's writes visible to host reads after the timeline wait
+    static void recordHostBarrier(VkCommandBuffer cmd);
+
+    VkBuffer buffer(uint32_t frame) const { return m_buffers[frame].get(); }
+    uint32_t textureCount() const { return m_textureCount; }
+    bool isCreated() const { return !m_buffers.empty(); }
+
+private:
+    void reset(uint32_t frame);
+
+    std::vector<Buffer> m_buffers;
+    uint32_t m_textureCount = 0;
+    uint32_t m_sampleCell = 0;
+};
@@ -0,0 +1,134 @@
+// ============================================================================
+// TextureResidency.cpp - Feedback-driven mip residency with LRU eviction
+// ============================================================================
+
+#include "TextureResidency.h"
+#include <algorithm>
+
+namespace {
+
+// Requests are kept for two windows so the 1-in-64 pixel sampling of the
+// feedback pass does not make textures flicker in and out
+constexpr uint64_t kRequestWindowFrames = 64;
+
+// A texture not sampled for this long drops to its floor level
+constexpr uint64_t kEvictAfterFrames = 300;
+
+} // namespace
+
+void TextureResidency::init(uint32_t textureCount, uint64_t budgetBytes) {
+    m_entries.assign(textureCount, Entry{});
+    m_budgetBytes = budgetBytes;
+    m_windowStart = 0;
+    m_loads = 0;
+    m_evictions = 0;
+}
+
+void TextureResidency::track(uint32_t textureIndex, std::vector<uint64_t> chainBytes,
+                             uint32_t floorLevel, uint32_t residentTop) {
+    Entry& entry = m_entries[textureIndex];
+    entry.tracked = true;
+    entry.chainBytes = std::move(chainBytes);
+    entry.floorLevel = std::min(floorLevel, static_cast<uint32_t>(entry.chainBytes.size()) - 1);
+    entry.residentTop = residentTop;
+    entry.windowRequest = kNoRequest;
+    entry.previousRequest = kNoRequest;
+    // Grace period: a texture that just arrived counts as recently used
+    entry.lastUsedFrame = m_windowStart;
+}
+
+void TextureResidency::recordRequest(uint32_t textureIndex, uint32_t level, uint64_t frame) {
+    if (textureIndex >= m_entries.size()) return;
+    Entry& entry = m_entries[textureIndex];
+    if (!entry.tracked) return;
+    entry.windowRequest = std::min(entry.windowRequest, level);
+    entry.lastUsedFrame = frame;
+}
+
+uint32_t TextureResidency::wantedTop(const Entry& entry, uint64_t frame) const {
+    if (frame > entry.lastUsedFrame + kEvictAfterFrames) {
+        return entry.floorLevel;
+    }
+    uint32_t request = std::min(entry.windowRequest, entry.previousRequest);
+    if (request == kNoRequest) {
+        return entry.residentTop;
+    }
+    return std::min(request, entry.floorLevel);
+}
+
+std::vector<TextureResidency::Change> TextureResidency::plan(uint64_t frame) {
+    if (frame >= m_windowStart + kRequestWindowFrames) {
+        for (auto& entry : m_entries) {
+            entry.previousRequest = entry.windowRequest;
+            entry.windowRequest = kNoRequest;
+        }
+        m_windowStart = frame;
+    }
+
+    std::vector<uint32_t> target(m_entries.size(), 0);
+    uint64_t total = 0;
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        const Entry& entry = m_entries[i];
+        if (!entry.tracked) continue;
+
+        uint32_t wanted = wantedTop(entry, frame);
+        // Keep one spare level instead of re-uploading for a small zoom-out
+        bool unused = frame > entry.lastUsedFrame + kEvictAfterFrames;
+        if (!unused && wanted == entry.residentTop + 1) {
+            wanted = entry.residentTop;
+        }
+        target[i] = wanted;
+        total += entry.chainBytes[wanted];
+    }
+
+    // Over budget: shrink the least recently sampled textures first
+    if (m_budgetBytes != 0 && total > m_budgetBytes) {
+        std::vector<size_t> order;
+        for (size_t i = 0; i < m_entries.size(); ++i) {
+            if (m_entries[i].tracked) order.push_back(i);
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return m_entries[a].lastUsedFrame < m_entries[b].lastUsedFrame;
+        });
+        for (size_t i : order) {
+            const Entry& entry = m_entries[i];
+            while (total > m_budgetBytes && target[i] < entry.floorLevel) {
+                total -= entry.chainBytes[target[i]];
+                target[i]++;
+                total += entry.chainBytes[target[i]];
+            }
+            if (total <= m_budgetBytes) break;
+        }
+    }
+
+    std::vector<Change> changes;
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        if (m_entries[i].tracked && target[i] != m_entries[i].residentTop) {
+            changes.push_back({ static_cast<uint32_t>(i), target[i] });
+        }
+    }
+    return changes;
+}
+
+void TextureResidency::setResident(uint32_t textureIndex, uint32_t topLevel) {
+    Entry& entry = m_entries[textureIndex];
+    if (topLevel < entry.residentTop) m_loads++;
+    else if (topLevel > entry.residentTop) m_evictions++;
+    entry.residentTop = topLevel;
+}
+
+uint64_t TextureResidency::residentBytes() const {
+    uint64_t total = 0;
+    for (const auto& entry : m_entries) {
+        if (entry.tracked) total += entry.chainBytes[entry.residentTop];
+    }
+    return total;
+}
+
+uint64_t TextureResidency::fullBytes() const {
+    uint64_t total = 0;
+    for (const auto& entry : m_entries) {
+        if (entry.tracked) total += entry.chainBytes[0];
+    }
+    return total;
+}
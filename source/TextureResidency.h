@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// ============================================================================
+// Texture Residency
+// Decides which mips of each streamed texture stay on the GPU. Levels are
+// indices into the texture's cooked (CPU-side) mip chain; a texture is
+// resident from its "top" level down to 1x1. Shader feedback says which top
+// level each texture needs, textures nobody sampled for a while fall back to
+// their small floor level, and when the wanted set exceeds the budget the
+// least recently sampled textures are shrunk first.
+// ============================================================================
+
+class TextureResidency {
+public:
+    static constexpr uint32_t kNoRequest = 0xFFFFFFFFu;
+
+    struct Change {
+        uint32_t textureIndex;
+        uint32_t topLevel;
+    };
+
+    void init(uint32_t textureCount, uint64_t budgetBytes);
+
+    // Start managing a texture. `chainBytes[l]` = bytes resident when level l
+    // is the top; `floorLevel` is the coarsest top ever chosen.
+    void track(uint32_t textureIndex, std::vector<uint64_t> chainBytes,
+               uint32_t floorLevel, uint32_t residentTop);
+
+    // One frame of feedback: finest cooked-chain level sampled for a texture
+    void recordRequest(uint32_t textureIndex, uint32_t level, uint64_t frame);
+
+    // Top levels that should change now; call setResident() once applied
+    std::vector<Change> plan(uint64_t frame);
+    void setResident(uint32_t textureIndex, uint32_t topLevel);
+
+    uint64_t residentBytes() const;
+    uint64_t fullBytes() const;
+    uint64_t budgetBytes() const { return m_budgetBytes; }
+    uint32_t loads() const { return m_loads; }
+    uint32_t evictions() const { return m_evictions; }
+
+private:
+    struct Entry {
+        bool tracked = false;
+        std::vector<uint64_t> chainBytes;
+        uint32_t floorLevel = 0;
+        uint32_t residentTop = 0;
+        uint32_t windowRequest = kNoRequest;    // finest request in the current window
+        uint32_t previousRequest = kNoRequest;  // finest request in the last full window
+        uint64_t lastUsedFrame = 0;
+    };
+
+    uint32_t wantedTop(const Entry& entry, uint64_t frame) const;
+
+    std::vector<Entry> m_entries;
+    uint64_t m_budgetBytes = 0;   // 0 = unlimited
+    uint64_t m_windowStart = 0;
+    uint32_t m_loads = 0;
+    uint32_t m_evictions = 0;
+};
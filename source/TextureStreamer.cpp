@@ -0,0 +1,154 @@
+// ============================================================================
+// TextureStreamer.cpp - Background decode/cook of model textures
+// ============================================================================
+
+#include "TextureStreamer.h"
+#include <stb_image.h>
+#include <iostream>
+#include <iterator>
+
+// ============================================================================
+// Helper Functions
+// ============================================================================
+
+namespace {
+
+bool decodeImage(const EncodedImage& image, std::vector<uint8_t>& rgba, uint32_t& width, uint32_t& height) {
+    int w, h, channels;
+    stbi_uc* pixels = image.bytes.empty()
+        ? stbi_load(image.path.c_str(), &w, &h, &channels, STBI_rgb_alpha)
+        : stbi_load_from_memory(image.bytes.data(), static_cast<int>(image.bytes.size()),
+                                &w, &h, &channels, STBI_rgb_alpha);
+    if (!pixels) {
+        return false;
+    }
+    rgba.assign(pixels, pixels + static_cast<size_t>(w) * h * 4);
+    stbi_image_free(pixels);
+    width = static_cast<uint32_t>(w);
+    height = static_cast<uint32_t>(h);
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// Processing
+// ============================================================================
+
+StreamedTexture TextureStreamer::process(TextureCooker& cooker, const TextureStreamRequest& request) {
+    StreamedTexture result;
+    result.textureIndex = request.textureIndex;
+
+    std::vector<uint8_t> rgba;
+    uint32_t width = 0, height = 0;
+    if (!request.image || !decodeImage(*request.image, rgba, width, height)) {
+        std::cerr << "Warning: Failed to decode image for texture " << request.textureIndex << std::endl;
+        result.failed = true;
+        return result;
+    }
+
+    // Channel-pack occlusion into R (planOrmPacking guarantees matching sizes;
+    // without it R falls back to "no occlusion")
+    if (request.occlusion) {
+        std::vector<uint8_t> occlusion;
+        uint32_t occlusionWidth = 0, occlusionHeight = 0;
+        bool packed = decodeImage(*request.occlusion, occlusion, occlusionWidth, occlusionHeight) &&
+                      occlusionWidth == width && occlusionHeight == height;
+        if (!packed) {
+            std::cerr << "Warning: Could not pack occlusion into texture " << request.textureIndex << std::endl;
+        }
+        size_t pixelCount = static_cast<size_t>(width) * height;
+        for (size_t p = 0; p < pixelCount; ++p) {
+            rgba[p * 4 + 0] = packed ? occlusion[p * 4 + 0] : 255;
+            rgba[p * 4 + 3] = 255;
+        }
+    }
+
+    result.cooked = cooker.cook(rgba.data(), width, height, request.usage, request.skipMips);
+    return result;
+}
+
+// ============================================================================
+// Thread Control
+// ============================================================================
+
+void TextureStreamer::start(TextureCooker cooker, std::vector<TextureStreamRequest> requests, JobSystem* jobs) {
+    stop();
+
+    m_state->requests = std::move(requests);
+    m_state->cooker = std::move(cooker);
+    m_state->remaining = m_state->requests.size();
+
+    if (!jobs || jobs->threadCount() <= 1) {
+        m_thread = std::thread(&TextureStreamer::run, m_state);
+        return;
+    }
+
+    // One background job per texture, started in request order; each cooks
+    // with its own copy of the cooker, all forked before the first job runs
+    std::vector<TextureCooker> cookers;
+    cookers.reserve(m_state->requests.size());
+    for (size_t i = 0; i < m_state->requests.size(); ++i) {
+        cookers.push_back(m_state->cooker.fork());
+    }
+    for (size_t i = 0; i < cookers.size(); ++i) {
+        jobs->run([state = m_state, cooker = std::move(cookers[i]), i]() mutable {
+            processRequest(*state, cooker, i);
+        }, nullptr, JobPriority::Background);
+    }
+}
+
+void TextureStreamer::stop() {
+    m_state->stopRequested = true;
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_state = std::make_shared<State>();
+}
+
+void TextureStreamer::run(const std::shared_ptr<State>& state) {
+    for (size_t i = 0; i < state->requests.size(); ++i) {
+        processRequest(*state, state->cooker, i);
+    }
+}
+
+void TextureStreamer::processRequest(State& state, TextureCooker& cooker, size_t index) {
+    TextureStreamRequest& request = state.requests[index];
+    bool skipped = state.stopRequested;
+    StreamedTexture result;
+    if (!skipped) {
+        result = process(cooker, request);
+    }
+
+    // Encoded bytes are no longer needed once nothing else references them
+    request.image.reset();
+    request.occlusion.reset();
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (!skipped) {
+        state.completed.push_back(std::move(result));
+    }
+    if (&cooker != &state.cooker) {
+        state.cooker.mergeStats(cooker);
+    }
+    --state.remaining;
+}
+
+std::vector<StreamedTexture> TextureStreamer::takeCompleted() {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    std::vector<StreamedTexture> completed;
+    completed.swap(m_state->completed);
+    return completed;
+}
+
+void TextureStreamer::returnCompleted(std::vector<StreamedTexture> results) {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    results.insert(results.end(), std::make_move_iterator(m_state->completed.begin()),
+                   std::make_move_iterator(m_state->completed.end()));
+    m_state->completed.swap(results);
+}
+
+bool TextureStreamer::isFinished() const {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->remaining == 0 && m_state->completed.empty();
+}
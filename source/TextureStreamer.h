@@ -0,0 +1,96 @@
+#pragma once
+#include "TextureCooker.h"
+#include "JobSystem.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// Texture Streamer
+// Decodes and cooks model textures off the render thread so the first frame
+// does not wait for them: with a JobSystem, each texture is a background job
+// of its own; without one, a thread of the streamer's cooks them in turn.
+// The render thread polls finished results each frame and does the GPU
+// upload itself; nothing here touches Vulkan objects.
+// ============================================================================
+
+// Still-encoded (PNG/JPEG) image captured while parsing the glTF
+struct EncodedImage {
+    std::vector<uint8_t> bytes;
+    std::string path;           // external file to read instead when bytes is empty
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t channels = 0;      // channels stored in the file (2/4 = has alpha)
+};
+
+// One texture to decode, optionally ORM-pack, and cook
+struct TextureStreamRequest {
+    uint32_t textureIndex = 0;
+    std::shared_ptr<const EncodedImage> image;
+    std::shared_ptr<const EncodedImage> occlusion;  // merged into R when set
+    TextureUsageFlags usage = 0;
+    uint32_t skipMips = 0;
+};
+
+struct StreamedTexture {
+    uint32_t textureIndex = 0;
+    CookedTexture cooked;
+    bool failed = false;
+};
+
+class TextureStreamer {
+public:
+    TextureStreamer() = default;
+    ~TextureStreamer() { stop(); }
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Start cooking; requests are started in the given order. `jobs`
+    // (optional) must outlive the streamer.
+    void start(TextureCooker cooker, std::vector<TextureStreamRequest> requests, JobSystem* jobs = nullptr);
+
+    // Drop the textures not started yet. With jobs this does not wait: a
+    // job already cooking finishes into state the streamer has let go of.
+    // Without, the thread finishes its current texture and is joined.
+    void stop();
+
+    // Results finished since the last call (render thread)
+    std::vector<StreamedTexture> takeCompleted();
+
+    // Hand back results takeCompleted() returned that the caller had no
+    // budget for; the next takeCompleted() returns them first
+    void returnCompleted(std::vector<StreamedTexture> results);
+
+    // Every request has been processed and handed out by takeCompleted()
+    bool isFinished() const;
+
+    // Cook statistics; only call once isFinished() is true, before stop()
+    const TextureCooker& cooker() const { return m_state->cooker; }
+
+    // Decode, pack and cook one request on the calling thread
+    static StreamedTexture process(TextureCooker& cooker, const TextureStreamRequest& request);
+
+private:
+    // Shared with the thread or jobs doing the cooking, which keep it alive
+    // for as long as they run
+    struct State {
+        std::vector<TextureStreamRequest> requests;
+        std::atomic<bool> stopRequested{ false };
+
+        std::mutex mutex;
+        std::vector<StreamedTexture> completed;
+        TextureCooker cooker;       // cooks on the thread; with jobs, collects the forks' statistics
+        size_t remaining = 0;       // requests neither processed nor skipped yet
+    };
+
+    static void run(const std::shared_ptr<State>& state);
+    static void processRequest(State& state, TextureCooker& cooker, size_t index);
+
+    std::shared_ptr<State> m_state = std::make_shared<State>();
+    std::thread m_thread;
+};
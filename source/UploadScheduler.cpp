@@ -0,0 +1,137 @@
+// ============================================================================
+// UploadScheduler.cpp - Per-frame byte and time budget for streaming uploads
+// ============================================================================
+
+#include "UploadScheduler.h"
+#include <algorithm>
+#include <iostream>
+
+// ============================================================================
+// Frame Budget
+// ============================================================================
+
+void UploadScheduler::beginFrame(uint64_t submittedValue, uint64_t completedValue) {
+    // Close out the previous frame's totals. Its uploads went out on the
+    // async queues without a wait and are complete once the timeline passes
+    // everything submitted since.
+    if (m_frameUploads > 0) {
+        ++m_uploadFrames;
+        m_worstFrameBytes = std::max(m_worstFrameBytes, m_frameBytes);
+        m_worstFrameMs = std::max(m_worstFrameMs,
+                                  std::chrono::duration<double, std::milli>(m_frameTime).count());
+    }
+    if (m_frameBytes > 0) {
+        m_inFlight.push_back({ submittedValue, m_frameBytes });
+    }
+
+    while (!m_inFlight.empty() && m_inFlight.front().value <= completedValue) {
+        m_bytesInFlight -= m_inFlight.front().bytes;
+        m_inFlight.pop_front();
+    }
+
+    m_frameBytes = 0;
+    m_frameTime = std::chrono::steady_clock::duration::zero();
+    m_frameUploads = 0;
+}
+
+bool UploadScheduler::hasBudget(uint64_t bytes) const {
+    if (m_frameUploads == 0) return true;
+    return m_frameBytes + bytes <= m_budget.bytesPerFrame && m_frameTime < m_budget.timePerFrame;
+}
+
+void UploadScheduler::account(uint64_t bytes, std::chrono::steady_clock::duration elapsed) {
+    m_frameBytes += bytes;
+    m_frameTime += elapsed;
+    ++m_frameUploads;
+    ++m_totalUploads;
+    m_totalBytes += bytes;
+    m_bytesInFlight += bytes;
+}
+
+// ============================================================================
+// Queued Uploads
+// ============================================================================
+
+void UploadScheduler::enqueue(Owner owner, uint64_t bytes, std::function<float()> priority,
+                              std::function<void(const UploadFrame&)> upload) {
+    Entry entry;
+    entry.owner = owner;
+    entry.bytes = bytes;
+    entry.priority = std::move(priority);
+    entry.upload = std::move(upload);
+    m_queue.push_back(std::move(entry));
+    m_queuedBytes += bytes;
+    m_peakQueueDepth = std::max(m_peakQueueDepth, m_queue.size());
+}
+
+void UploadScheduler::cancel(Owner owner) {
+    auto removed = std::remove_if(m_queue.begin(), m_queue.end(),
+                                  [owner](const Entry& entry) { return entry.owner == owner; });
+    for (auto it = removed; it != m_queue.end(); ++it) {
+        m_queuedBytes -= it->bytes;
+    }
+    m_queue.erase(removed, m_queue.end());
+}
+
+void UploadScheduler::runQueued(const UploadFrame& frame) {
+    if (m_queue.empty()) return;
+
+    // Priorities follow the camera, so the order is rebuilt every frame
+    for (Entry& entry : m_queue) {
+        entry.order = entry.priority();
+    }
+    std::stable_sort(m_queue.begin(), m_queue.end(),
+                     [](const Entry& a, const Entry& b) { return a.order < b.order; });
+
+    size_t done = 0;
+    while (done < m_queue.size() && hasBudget(m_queue[done].bytes)) {
+        Entry& entry = m_queue[done++];
+        charge(entry.bytes, [&] { entry.upload(frame); });
+        m_queuedBytes -= entry.bytes;
+    }
+    m_queue.erase(m_queue.begin(), m_queue.begin() + static_cast<std::ptrdiff_t>(done));
+
+    if (!m_queue.empty()) {
+        ++m_saturatedFrames;
+    }
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+UploadScheduler::Stats UploadScheduler::stats() const {
+    Stats stats;
+    stats.queueDepth = m_queue.size();
+    stats.queuedBytes = m_queuedBytes;
+    stats.bytesInFlight = m_bytesInFlight;
+    stats.frameBytes = m_frameBytes;
+    stats.frameMs = std::chrono::duration<double, std::milli>(m_frameTime).count();
+    return stats;
+}
+
+void UploadScheduler::printStatus() {
+    if (m_queue.empty() && m_bytesInFlight == 0) return;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_lastStatus < std::chrono::seconds(1)) return;
+    m_lastStatus = now;
+
+    const Stats current = stats();
+    const double mb = 1.0 / (1024.0 * 1024.0);
+    std::cout << "Uploads: " << current.queueDepth << " queued (" << current.queuedBytes * mb << " MB), "
+              << current.bytesInFlight * mb << " MB in flight, this frame " << current.frameBytes * mb
+              << " MB in " << current.frameMs << " ms" << std::endl;
+}
+
+void UploadScheduler::printReport() const {
+    if (m_totalUploads == 0) return;
+
+    const double mb = 1.0 / (1024.0 * 1024.0);
+    std::cout << "Upload scheduler: " << m_totalUploads << " uploads, " << m_totalBytes * mb << " MB over "
+              << m_uploadFrames << " frames (budget " << m_budget.bytesPerFrame * mb << " MB / "
+              << m_budget.timePerFrame.count() / 1000.0 << " ms per frame)" << std::endl;
+    std::cout << "  Worst frame: " << m_worstFrameBytes * mb << " MB, " << m_worstFrameMs << " ms; "
+              << m_saturatedFrames << " frames deferred queued work, peak queue depth " << m_peakQueueDepth
+              << std::endl;
+}
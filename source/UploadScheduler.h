@@ -0,0 +1,119 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+class DeletionQueue;
+class Device;
+
+// ============================================================================
+// Upload Scheduler
+// One per-frame allowance, in bytes and CPU time, shared by every upload made
+// while rendering: streamed texture chains, residency reloads and models
+// loaded at runtime. Work that can wait is queued with a priority (lower
+// first, re-evaluated every frame so it follows the camera) and runs in that
+// order until the frame's budget is spent; the rest carries over. Work an
+// uploader must place this frame asks hasBudget() first and runs through
+// charge(). The first upload of a frame is always allowed, so a single copy
+// larger than the budget still makes progress.
+// ============================================================================
+
+struct UploadBudget {
+    uint64_t bytesPerFrame = 16ull * 1024ull * 1024ull;
+    std::chrono::microseconds timePerFrame{ 2000 };
+};
+
+// What a queued upload needs from the frame it runs in
+struct UploadFrame {
+    const Device& device;
+    VkCommandPool cmdPool;
+    VkQueue queue;
+    DeletionQueue& deletionQueue;
+    uint64_t retireValue;   // SyncObjects::submittedValue(): replaced resources retire at this value
+};
+
+class UploadScheduler {
+public:
+    using Owner = const void*;
+
+    void setBudget(const UploadBudget& budget) { m_budget = budget; }
+    const UploadBudget& budget() const { return m_budget; }
+
+    // Start a frame's allowance. Uploads made before it were all submitted by
+    // timeline value `submittedValue`; those up to `completedValue` are done.
+    void beginFrame(uint64_t submittedValue, uint64_t completedValue);
+
+    // Queue an upload of about `bytes`, run with runQueued()'s frame; it
+    // must not enqueue or cancel uploads itself
+    void enqueue(Owner owner, uint64_t bytes, std::function<float()> priority,
+                 std::function<void(const UploadFrame&)> upload);
+
+    // Drop an owner's queued uploads (it is being destroyed)
+    void cancel(Owner owner);
+
+    // Run queued uploads in priority order while the budget lasts
+    void runQueued(const UploadFrame& frame);
+
+    // Whether an upload of `bytes` still fits this frame
+    bool hasBudget(uint64_t bytes) const;
+
+    // Perform an upload now and charge its bytes and time to this frame
+    template <typename Upload>
+    void charge(uint64_t bytes, Upload&& upload) {
+        auto start = std::chrono::steady_clock::now();
+        upload();
+        account(bytes, std::chrono::steady_clock::now() - start);
+    }
+
+    struct Stats {
+        size_t queueDepth = 0;        // queued uploads waiting for budget
+        uint64_t queuedBytes = 0;
+        uint64_t bytesInFlight = 0;   // submitted, not yet completed by the GPU
+        uint64_t frameBytes = 0;      // this frame so far
+        double frameMs = 0.0;
+    };
+    Stats stats() const;
+
+    // Print stats() about once a second while uploads are queued or in flight
+    void printStatus();
+    void printReport() const;
+
+private:
+    void account(uint64_t bytes, std::chrono::steady_clock::duration elapsed);
+
+    struct Entry {
+        Owner owner = nullptr;
+        uint64_t bytes = 0;
+        float order = 0.0f;           // priority() as of this frame
+        std::function<float()> priority;
+        std::function<void(const UploadFrame&)> upload;
+    };
+
+    UploadBudget m_budget;
+    std::vector<Entry> m_queue;
+    uint64_t m_queuedBytes = 0;
+
+    uint64_t m_frameBytes = 0;
+    std::chrono::steady_clock::duration m_frameTime{ 0 };
+    uint32_t m_frameUploads = 0;
+
+    struct InFlight {
+        uint64_t value = 0;
+        uint64_t bytes = 0;
+    };
+    std::deque<InFlight> m_inFlight;                    // earlier frames' bytes, by completion value
+    uint64_t m_bytesInFlight = 0;                       // including this frame's
+    std::chrono::steady_clock::time_point m_lastStatus;
+
+    // Totals for printReport()
+    uint64_t m_totalUploads = 0;
+    uint64_t m_totalBytes = 0;
+    uint32_t m_uploadFrames = 0;        // frames with at least one upload
+    uint32_t m_saturatedFrames = 0;     // frames that left queued work for later
+    uint64_t m_worstFrameBytes = 0;
+    double m_worstFrameMs = 0.0;
+    size_t m_peakQueueDepth = 0;
+};
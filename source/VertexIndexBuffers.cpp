@@ -1,11 +1,13 @@
 #include "VertexIndexBuffers.h"
 #include "Device.h"
+#include "AsyncQueue.h"
 
 void VertexBuffer::createFrom(const Device& device,
     VkCommandPool commandPool,
     VkQueue transferQueue,
     const void* vertexData,
-    VkDeviceSize bytes)
+    VkDeviceSize bytes,
+    AsyncQueue* uploadQueue)
 {
     Buffer staging;
     staging.createAndMap(device, bytes,
@@ -18,16 +20,24 @@ void VertexBuffer::createFrom(const Device& device,
         VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-    Buffer::copyBuffer(device, commandPool, transferQueue, staging.get(), m_gpu.get(), bytes);
-    staging.destroy(device);
+    if (uploadQueue) {
+        uint64_t value = Buffer::copyBuffer(device, *uploadQueue, staging.get(), m_gpu.get(), bytes,
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+        staging.retire(device, uploadQueue->deletionQueue(), value);
+    } else {
+        Buffer::copyBuffer(device, commandPool, transferQueue, staging.get(), m_gpu.get(), bytes);
+        staging.destroy(device);
+    }
 }
 
 void VertexBuffer::createFromVector(const Device& device,
     VkCommandPool commandPool,
     VkQueue transferQueue,
-    const std::vector<uint8_t>& rawBytes)
+    const std::vector<uint8_t>& rawBytes,
+    AsyncQueue* uploadQueue)
 {
-    createFrom(device, commandPool, transferQueue, rawBytes.data(), static_cast<VkDeviceSize>(rawBytes.size()));
+    createFrom(device, commandPool, transferQueue, rawBytes.data(), static_cast<VkDeviceSize>(rawBytes.size()),
+        uploadQueue);
 }
 
 void VertexBuffer::destroy(const Device& device) {
@@ -38,7 +48,8 @@ void IndexBuffer::createFrom(const Device& device,
     VkCommandPool commandPool,
     VkQueue transferQueue,
     const void* indexData,
-    VkDeviceSize bytes)
+    VkDeviceSize bytes,
+    AsyncQueue* uploadQueue)
 {
     Buffer staging;
     staging.createAndMap(device, bytes,
@@ -51,8 +62,14 @@ void IndexBuffer::createFrom(const Device& device,
         VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-    Buffer::copyBuffer(device, commandPool, transferQueue, staging.get(), m_gpu.get(), bytes);
-    staging.destroy(device);
+    if (uploadQueue) {
+        uint64_t value = Buffer::copyBuffer(device, *uploadQueue, staging.get(), m_gpu.get(), bytes,
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT);
+        staging.retire(device, uploadQueue->deletionQueue(), value);
+    } else {
+        Buffer::copyBuffer(device, commandPool, transferQueue, staging.get(), m_gpu.get(), bytes);
+        staging.destroy(device);
+    }
 }
 
 void IndexBuffer::destroy(const Device& device) {
@@ -4,27 +4,35 @@
 #include <cstdint>
 #include "Buffer.h"
 
+class AsyncQueue;
+class DeletionQueue;
 class Device;
 
+// Device-local vertex/index data. Uploads go through `uploadQueue` (e.g. the
+// transfer queue) when one is given, else through `transferQueue` directly.
 class VertexBuffer {
 public:
     void createFrom(const Device& device,
         VkCommandPool commandPool,
         VkQueue transferQueue,
         const void* vertexData,
-        VkDeviceSize bytes);
+        VkDeviceSize bytes,
+        AsyncQueue* uploadQueue = nullptr);
     void createFromVector(const Device& device,
         VkCommandPool commandPool,
         VkQueue transferQueue,
-        const std::vector<uint8_t>& rawBytes);
+        const std::vector<uint8_t>& rawBytes,
+        AsyncQueue* uploadQueue = nullptr);
     template<typename T>
     void createFromVector(const Device& device,
         VkCommandPool commandPool,
         VkQueue transferQueue,
-        const std::vector<T>& vec) {
-        createFrom(device, commandPool, transferQueue, vec.data(), sizeof(T) * vec.size());
+        const std::vector<T>& vec,
+        AsyncQueue* uploadQueue = nullptr) {
+        createFrom(device, commandPool, transferQueue, vec.data(), sizeof(T) * vec.size(), uploadQueue);
     }
     void destroy(const Device& device);
+    void retire(const Device& device, DeletionQueue& deletionQueue, uint64_t value) { m_gpu.retire(device, deletionQueue, value); }
 
     VkBuffer get() const { return m_gpu.get(); }
     VkDeviceSize size() const { return m_gpu.size(); }
@@ -39,15 +47,18 @@ public:
         VkCommandPool commandPool,
         VkQueue transferQueue,
         const void* indexData,
-        VkDeviceSize bytes);
+        VkDeviceSize bytes,
+        AsyncQueue* uploadQueue = nullptr);
     template<typename T>
     void createFromVector(const Device& device,
         VkCommandPool commandPool,
         VkQueue transferQueue,
-        const std::vector<T>& vec) {
-        createFrom(device, commandPool, transferQueue, vec.data(), sizeof(T) * vec.size());
+        const std::vector<T>& vec,
+        AsyncQueue* uploadQueue = nullptr) {
+        createFrom(device, commandPool, transferQueue, vec.data(), sizeof(T) * vec.size(), uploadQueue);
     }
     void destroy(const Device& device);
+    void retire(const Device& device, DeletionQueue& deletionQueue, uint64_t value) { m_gpu.retire(device, deletionQueue, value); }
 
     VkBuffer get() const { return m_gpu.get(); }
     VkDeviceSize size() const { return m_gpu.size(); }
@@ -0,0 +1,216 @@
+// ============================================================================
+// WeightedOit.cpp - Weighted blended OIT resolve
+// ============================================================================
+
+#include "WeightedOit.h"
+#include "DeletionQueue.h"
+#include "Device.h"
+#include "PipelineCache.h"
+#include "RenderPass.h"
+#include <stdexcept>
+
+void WeightedOit::create(const Device& device, PipelineCache& pipelineCache, VkRenderPass renderPass,
+                         VkShaderModule resolveVertexShader, VkShaderModule resolveFragmentShader) {
+    // Set 0: binding 0 = accum, binding 1 = revealage
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    for (uint32_t i = 0; i < bindings.size(); ++i) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    if (vkCreateDescriptorSetLayout(device.get(), &layoutInfo, nullptr, &m_setLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create OIT descriptor set layout");
+    }
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+    poolSize.descriptorCount = static_cast<uint32_t>(bindings.size()) * kMaxTargetSets;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    poolInfo.maxSets = kMaxTargetSets;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    if (vkCreateDescriptorPool(device.get(), &poolInfo, nullptr, &m_pool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create OIT descriptor pool");
+    }
+
+    m_pipelineLayout.create(device, { m_setLayout }, {});
+
+    // ---- Resolve pipeline: full-screen triangle, no vertex input, no depth ----
+    VkPipelineShaderStageCreateInfo stages[2]{};
+    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    stages[0].module = resolveVertexShader;
+    stages[0].pName = "main";
+    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    stages[1].module = resolveFragmentShader;
+    stages[1].pName = "main";
+
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.cullMode = VK_CULL_MODE_NONE;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.lineWidth = 1.0f;
+
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = VK_FALSE;
+    depthStencil.depthWriteEnable = VK_FALSE;
+
+    // out = (average color, coverage): standard "over" onto the scene
+    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                          VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.blendEnable = VK_TRUE;
+    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+
+    VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
+
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = 2;
+    pipelineInfo.pStages = stages;
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = m_pipelineLayout.get();
+    pipelineInfo.renderPass = renderPass;
+    pipelineInfo.subpass = RenderPass::SUBPASS_COMPOSITE;
+
+    m_resolvePipeline = pipelineCache.createGraphicsPipeline(device, pipelineInfo, "oit resolve");
+}
+
+void WeightedOit::destroy(const Device& device) {
+    if (m_resolvePipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device.get(), m_resolvePipeline, nullptr);
+        m_resolvePipeline = VK_NULL_HANDLE;
+    }
+    m_pipelineLayout.destroy(device);
+    if (m_pool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(device.get(), m_pool, nullptr);   // frees m_set and any retiring sets
+        m_pool = VK_NULL_HANDLE;
+        m_set = VK_NULL_HANDLE;
+    }
+    if (m_setLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(device.get(), m_setLayout, nullptr);
+        m_setLayout = VK_NULL_HANDLE;
+    }
+}
+
+void WeightedOit::setTargets(const Device& device, VkImageView accumView, VkImageView revealageView,
+                             DeletionQueue* deletionQueue, uint64_t retireValue) {
+    if (m_set != VK_NULL_HANDLE) {
+        VkDevice handle = device.get();
+        VkDescriptorPool pool = m_pool;
+        VkDescriptorSet oldSet = m_set;
+        auto freeSet = [handle, pool, oldSet]() { vkFreeDescriptorSets(handle, pool, 1, &oldSet); };
+        if (deletionQueue) {
+            deletionQueue->push(retireValue, freeSet);
+        } else {
+            freeSet();
+        }
+        m_set = VK_NULL_HANDLE;
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_pool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_setLayout;
+    if (vkAllocateDescriptorSets(device.get(), &allocInfo, &m_set) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate OIT descriptor set");
+    }
+
+    VkDescriptorImageInfo imageInfos[2]{};
+    imageInfos[0].imageView = accumView;
+    imageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfos[1].imageView = revealageView;
+    imageInfos[1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = m_set;
+    write.dstBinding = 0;
+    write.descriptorCount = 2;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+    write.pImageInfo = imageInfos;
+    vkUpdateDescriptorSets(device.get(), 1, &write, 0, nullptr);
+}
+
+void WeightedOit::recordResolve(VkCommandBuffer cmd) const {
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_resolvePipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout.get(), 0, 1, &m_set, 0, nullptr);
+    vkCmdDraw(cmd, 3, 1, 0, 0);
+}
+
+std::array<VkPipelineColorBlendAttachmentState, 2> WeightedOit::accumulateBlendStates() {
+    std::array<VkPipelineColorBlendAttachmentState, 2> states{};
+
+    // Accum: sum of (premultiplied color, alpha) * weight
+    states[0].colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                               VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    states[0].blendEnable = VK_TRUE;
+    states[0].srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+    states[0].dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+    states[0].colorBlendOp = VK_BLEND_OP_ADD;
+    states[0].srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    states[0].dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    states[0].alphaBlendOp = VK_BLEND_OP_ADD;
+
+    // Revealage: dst *= (1 - alpha), the shader writes alpha to R
+    states[1].colorWriteMask = VK_COLOR_COMPONENT_R_BIT;
+    states[1].blendEnable = VK_TRUE;
+    states[1].srcColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+    states[1].dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR;
+    states[1].colorBlendOp = VK_BLEND_OP_ADD;
+    states[1].srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+    states[1].dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    states[1].alphaBlendOp = VK_BLEND_OP_ADD;
+
+    return states;
+}
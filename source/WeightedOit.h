@@ -0,0 +1,53 @@
+#pragma once
+#include "Pipeline.h"
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+
+class DeletionQueue;
+class Device;
+class PipelineCache;
+
+// ============================================================================
+// Weighted Blended OIT
+// McGuire & Bavoil weighted-blended order-independent transparency. Blend
+// draws run in RenderPass::SUBPASS_OIT_ACCUMULATE with additive blending into
+// an RGBA16F accum target (premultiplied color * weight, alpha * weight) and
+// multiplicative blending into an R16F revealage target (product of 1 - alpha).
+// The resolve in SUBPASS_COMPOSITE reads both as input attachments and blends
+// accum.rgb / accum.a over the scene with coverage 1 - revealage.
+// No per-frame sorting is needed; the price is approximate ordering between
+// overlapping layers. The resolve reads single-sample inputs, so it assumes
+// the render pass runs without MSAA.
+// ============================================================================
+
+class WeightedOit {
+public:
+    void create(const Device& device, PipelineCache& pipelineCache, VkRenderPass renderPass,
+                VkShaderModule resolveVertexShader, VkShaderModule resolveFragmentShader);
+    void destroy(const Device& device);
+
+    // Point the resolve at the framebuffer's targets; again whenever they are
+    // recreated. Each call writes a fresh descriptor set, so frames in flight
+    // keep theirs: the previous set is freed through `deletionQueue` at
+    // `retireValue`, or right away without a queue.
+    void setTargets(const Device& device, VkImageView accumView, VkImageView revealageView,
+                    DeletionQueue* deletionQueue = nullptr, uint64_t retireValue = 0);
+
+    // Full-screen composite; record inside SUBPASS_COMPOSITE
+    void recordResolve(VkCommandBuffer cmd) const;
+
+    // Color blend states for pipelines drawing into SUBPASS_OIT_ACCUMULATE
+    static std::array<VkPipelineColorBlendAttachmentState, 2> accumulateBlendStates();
+
+private:
+    // The current set plus those still retiring after resizes, one per frame
+    // in flight at most
+    static constexpr uint32_t kMaxTargetSets = 8;
+
+    VkDescriptorSetLayout m_setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool m_pool = VK_NULL_HANDLE;
+    VkDescriptorSet m_set = VK_NULL_HANDLE;
+    PipelineLayoutRAII m_pipelineLayout;
+    VkPipeline m_resolvePipeline = VK_NULL_HANDLE;
+};
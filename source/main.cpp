@@ -1,5 +1,8 @@
 #include <iostream>
 #include "Application.h"
+#include "AppSettings.h"
+#include "DrawList.h"
+#include "GltfModel.h"
 
 #ifdef NDEBUG
 const bool enableValidationLayers = false;
@@ -7,10 +10,23 @@ const bool enableValidationLayers = false;
 const bool enableValidationLayers = true;
 #endif
 
-int main() {
-    Application app;
-
+int main(int argc, char** argv) {
     try {
+        AppSettings settings = AppSettings::fromCommandLine(argc, argv);
+        if (settings.showHelp) {
+            AppSettings::printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+        if (settings.benchmarkDrawSort) {
+            benchmarkDrawListSort();
+            return EXIT_SUCCESS;
+        }
+        if (settings.benchmarkJobs) {
+            GltfModel::benchmarkJobScaling(settings.gltfModelPath);
+            return EXIT_SUCCESS;
+        }
+
+        Application app(settings);
         app.run();
     }
     catch (const std::exception& e) {
@@ -19,4 +35,4 @@ int main() {
     }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}